@@ -0,0 +1,47 @@
+#include "benchdatabase.h"
+
+#include <QEloquent/queryrunner.h>
+
+#include <QSqlError>
+
+using namespace QEloquent;
+
+bool BenchDatabase::setUp()
+{
+    Connection connection = Connection::addConnection("DB", "QSQLITE", ":memory:");
+    if (!connection.open()) {
+        s_lastError = QStringLiteral("Can't open connection");
+        return false;
+    }
+
+    return exec(QStringLiteral(TEST_DATA_DIR) + "/store/structure.sql")
+        && exec(QStringLiteral(TEST_DATA_DIR) + "/store/content.sql");
+}
+
+void BenchDatabase::tearDown()
+{
+    Connection::removeConnection("DB");
+}
+
+Connection BenchDatabase::connection()
+{
+    return Connection::connection("DB");
+}
+
+QString BenchDatabase::lastError()
+{
+    return s_lastError;
+}
+
+bool BenchDatabase::exec(const QString &sqlFileName)
+{
+    auto result = QueryRunner::execScriptFile(sqlFileName, connection());
+    if (!result) {
+        s_lastError = result.error().text();
+        return false;
+    }
+
+    return true;
+}
+
+QString BenchDatabase::s_lastError;
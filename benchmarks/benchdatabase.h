@@ -0,0 +1,24 @@
+#ifndef BENCHDATABASE_H
+#define BENCHDATABASE_H
+
+#include <QEloquent/connection.h>
+
+#include <QString>
+
+// In-memory SQLite database, migrated and seeded from testdata/store
+class BenchDatabase
+{
+public:
+    static bool setUp();
+    static void tearDown();
+
+    static QEloquent::Connection connection();
+    static QString lastError();
+
+private:
+    static bool exec(const QString &sqlFileName);
+
+    static QString s_lastError;
+};
+
+#endif // BENCHDATABASE_H
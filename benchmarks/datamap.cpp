@@ -0,0 +1,85 @@
+#include <benchmark/benchmark.h>
+
+#include <QEloquent/datamap.h>
+
+using namespace QEloquent;
+
+static QStringList keys(int count)
+{
+    QStringList keys;
+    for (int i(0); i < count; ++i)
+        keys.append(QStringLiteral("field_%1").arg(i));
+    return keys;
+}
+
+static void BM_DataMapInsert(benchmark::State &state)
+{
+    const QStringList names = keys(state.range(0));
+
+    for (auto _ : state) {
+        DataMap map;
+        for (const QString &name : names)
+            map.insert(name, 42);
+        benchmark::DoNotOptimize(map);
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_DataMapInsert)->Arg(4)->Arg(16)->Arg(64);
+
+static void BM_DataMapLookup(benchmark::State &state)
+{
+    const QStringList names = keys(state.range(0));
+
+    DataMap map;
+    for (const QString &name : names)
+        map.insert(name, 42);
+
+    for (auto _ : state) {
+        for (const QString &name : names)
+            benchmark::DoNotOptimize(map.value(name));
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_DataMapLookup)->Arg(4)->Arg(16)->Arg(64);
+
+static void BM_DataMapRows(benchmark::State &state)
+{
+    // Rows of a result set, all built with the same keys
+    const QStringList names = keys(state.range(0));
+
+    for (auto _ : state) {
+        QList<DataMap> rows;
+        rows.reserve(100);
+        for (int row(0); row < 100; ++row) {
+            DataMap map;
+            for (const QString &name : names)
+                map.insert(name, row);
+            rows.append(map);
+        }
+        benchmark::DoNotOptimize(rows);
+    }
+
+    state.SetItemsProcessed(state.iterations() * 100 * state.range(0));
+}
+BENCHMARK(BM_DataMapRows)->Arg(8)->Arg(32);
+
+static void BM_DataMapRemove(benchmark::State &state)
+{
+    const QStringList names = keys(state.range(0));
+
+    DataMap source;
+    for (const QString &name : names)
+        source.insert(name, 42);
+
+    for (auto _ : state) {
+        DataMap map = source;
+        for (const QString &name : names)
+            map.remove(name);
+        benchmark::DoNotOptimize(map);
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_DataMapRemove)->Arg(4)->Arg(16)->Arg(64);
@@ -0,0 +1,38 @@
+#include <benchmark/benchmark.h>
+
+#include "benchdatabase.h"
+
+#include <models/simplemodels.h>
+
+#include <QSqlQuery>
+#include <QSqlRecord>
+
+static void BM_FillFromRecord(benchmark::State &state)
+{
+    auto result = BenchDatabase::connection().exec("SELECT * FROM Products WHERE id = 1");
+    if (!result || !result->next()) {
+        state.SkipWithError("Apple record not found");
+        return;
+    }
+
+    const QSqlRecord record = result->record();
+    for (auto _ : state) {
+        SimpleProduct product;
+        product.fill(record);
+        benchmark::DoNotOptimize(product.id);
+    }
+}
+BENCHMARK(BM_FillFromRecord);
+
+static void BM_FindAll(benchmark::State &state)
+{
+    for (auto _ : state) {
+        auto result = SimpleProduct::all();
+        if (!result) {
+            state.SkipWithError("Query failed");
+            return;
+        }
+        benchmark::DoNotOptimize(result->size());
+    }
+}
+BENCHMARK(BM_FindAll);
@@ -0,0 +1,26 @@
+#include <benchmark/benchmark.h>
+
+#include <QCoreApplication>
+#include <QDebug>
+
+#include "benchdatabase.h"
+
+int main(int argc, char *argv[])
+{
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+        return 1;
+
+    QCoreApplication app(argc, argv);
+
+    if (!BenchDatabase::setUp()) {
+        qCritical().noquote() << "QEloquentBench: database setup failed," << BenchDatabase::lastError();
+        return 1;
+    }
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+
+    BenchDatabase::tearDown();
+    return 0;
+}
@@ -0,0 +1,51 @@
+#include <benchmark/benchmark.h>
+
+#include <models/simplemodels.h>
+
+#include <QEloquent/metaobject.h>
+
+using namespace QEloquent;
+
+static void BM_MetaObjectFrom(benchmark::State &state)
+{
+    for (auto _ : state)
+        benchmark::DoNotOptimize(MetaObject::from<SimpleProduct>());
+}
+BENCHMARK(BM_MetaObjectFrom);
+
+static void BM_PropertyByName(benchmark::State &state)
+{
+    const MetaObject object = MetaObject::from<SimpleProduct>();
+    for (auto _ : state)
+        benchmark::DoNotOptimize(object.property("barcode"));
+}
+BENCHMARK(BM_PropertyByName);
+
+static void BM_PropertyByFieldName(benchmark::State &state)
+{
+    const MetaObject object = MetaObject::from<SimpleProduct>();
+    for (auto _ : state)
+        benchmark::DoNotOptimize(object.property("created_at", MetaObject::ResolveByFieldName));
+}
+BENCHMARK(BM_PropertyByFieldName);
+
+static void BM_FillableProperties(benchmark::State &state)
+{
+    const MetaObject object = MetaObject::from<SimpleProduct>();
+    for (auto _ : state)
+        benchmark::DoNotOptimize(object.properties(MetaProperty::FillableProperty, MetaObject::StandardProperties | MetaObject::DynamicProperties));
+}
+BENCHMARK(BM_FillableProperties);
+
+static void BM_PropertyRead(benchmark::State &state)
+{
+    const MetaObject object = MetaObject::from<SimpleProduct>();
+    const MetaProperty property = object.property("name");
+
+    SimpleProduct product;
+    product.name = "Apple";
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(property.read(&product));
+}
+BENCHMARK(BM_PropertyRead);
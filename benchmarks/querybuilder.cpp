@@ -0,0 +1,42 @@
+#include <benchmark/benchmark.h>
+
+#include <QEloquent/querybuilder.h>
+#include <QEloquent/query.h>
+#include <QEloquent/datamap.h>
+
+#include <QDateTime>
+
+using namespace QEloquent;
+
+static void BM_SelectStatement(benchmark::State &state)
+{
+    Query query;
+    query.table("Products")
+        .connection("DB")
+        .where("category_id", 1)
+        .where("price", ">", 0.25)
+        .orderBy("name", Qt::AscendingOrder)
+        .page(2, 20);
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(QueryBuilder::selectStatement(query));
+}
+BENCHMARK(BM_SelectStatement);
+
+static void BM_InsertStatement(benchmark::State &state)
+{
+    Query query;
+    query.table("Products").connection("DB");
+
+    DataMap data;
+    data.insert("name", "Apple");
+    data.insert("description", "Fresh red apple");
+    data.insert("price", 0.5);
+    data.insert("barcode", "1234567890123");
+    data.insert("category_id", 1);
+    data.insert("created_at", QDateTime::currentDateTimeUtc());
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(QueryBuilder::insertStatement(data, query));
+}
+BENCHMARK(BM_InsertStatement);
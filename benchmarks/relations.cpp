@@ -0,0 +1,33 @@
+#include <benchmark/benchmark.h>
+
+#include <models/complexmodels.h>
+
+// Product eager loads its stock ("with" class info)
+static void BM_EagerLoad(benchmark::State &state)
+{
+    for (auto _ : state) {
+        auto result = Product::all();
+        if (!result) {
+            state.SkipWithError("Query failed");
+            return;
+        }
+        benchmark::DoNotOptimize(result->size());
+    }
+}
+BENCHMARK(BM_EagerLoad);
+
+static void BM_LazyLoad(benchmark::State &state)
+{
+    auto result = Category::find(1);
+    if (!result) {
+        state.SkipWithError("Category not found");
+        return;
+    }
+
+    for (auto _ : state) {
+        Category category = result.value();
+        category.load("products");
+        benchmark::DoNotOptimize(category);
+    }
+}
+BENCHMARK(BM_LazyLoad);
@@ -0,0 +1,124 @@
+#include "datagenerator.h"
+
+#include <QEloquent/queryrunner.h>
+
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QDateTime>
+#include <QTimeZone>
+
+#define GENERATION_BATCH_SIZE 10000
+
+using namespace QEloquent;
+
+DataGenerator::DataGenerator(quint32 seed)
+    : m_random(seed)
+{}
+
+bool DataGenerator::migrate(const Connection &connection, const QString &structureFile)
+{
+    auto result = QueryRunner::execScriptFile(structureFile, connection);
+    if (!result) {
+        m_lastError = result.error().text();
+        return false;
+    }
+
+    return true;
+}
+
+bool DataGenerator::generate(const Connection &connection, qint64 productCount)
+{
+    m_productCount = productCount;
+    m_categoryCount = qMax<qint64>(10, productCount / 1000);
+    m_userCount = qMax<qint64>(10, productCount / 10000);
+    m_saleCount = qMax<qint64>(1, productCount / 10);
+
+    const QDateTime origin(QDate(2024, 1, 1), QTime(0, 0), QTimeZone::utc());
+
+    bool ok = insertRows(connection, "INSERT INTO UserRoles (name) VALUES (?)", 1, [](qint64) -> QVariantList {
+        return { QStringLiteral("Seller") };
+    });
+
+    ok = ok && insertRows(connection, "INSERT INTO Users (name, email, password, role_id) VALUES (?, ?, ?, 1)", m_userCount, [](qint64 i) -> QVariantList {
+        return { QStringLiteral("User %1").arg(i), QStringLiteral("user%1@store.com").arg(i), QStringLiteral("secret") };
+    });
+
+    ok = ok && insertRows(connection, "INSERT INTO Categories (name, description) VALUES (?, ?)", m_categoryCount, [](qint64 i) -> QVariantList {
+        return { QStringLiteral("Category %1").arg(i), QStringLiteral("Generated category %1").arg(i) };
+    });
+
+    ok = ok && insertRows(connection, "INSERT INTO Products (name, description, price, barcode, category_id, created_at, updated_at) VALUES (?, ?, ?, ?, ?, ?, ?)", m_productCount, [this, &origin](qint64 i) -> QVariantList {
+        const QDateTime createdAt = origin.addSecs(i * 60);
+        return {
+            QStringLiteral("Product %1").arg(i),
+            QStringLiteral("Generated product %1, category %2").arg(i).arg(i % m_categoryCount),
+            m_random.bounded(1, 100000) / 100.0,
+            QStringLiteral("%1").arg(i, 13, 10, QLatin1Char('0')),
+            1 + m_random.bounded(int(m_categoryCount)),
+            createdAt,
+            createdAt
+        };
+    });
+
+    ok = ok && insertRows(connection, "INSERT INTO Stocks (quantity, product_id) VALUES (?, ?)", m_productCount, [this](qint64 i) -> QVariantList {
+        return { m_random.bounded(0, 500), i + 1 };
+    });
+
+    ok = ok && insertRows(connection, "INSERT INTO Sales (number, amount, seller_id, created_at) VALUES (?, ?, ?, ?)", m_saleCount, [this, &origin](qint64 i) -> QVariantList {
+        return { i + 1, m_random.bounded(1, 1000000) / 100.0, 1 + m_random.bounded(int(m_userCount)), origin.addSecs(i * 600) };
+    });
+
+    // Five items per sale on average
+    ok = ok && insertRows(connection, "INSERT INTO SaleItems (unit_price, quantity, sale_id, product_id) VALUES (?, ?, ?, ?)", m_saleCount * 5, [this](qint64 i) -> QVariantList {
+        return { m_random.bounded(1, 100000) / 100.0, m_random.bounded(1, 10), 1 + i / 5, 1 + m_random.bounded(int(m_productCount)) };
+    });
+
+    return ok;
+}
+
+qint64 DataGenerator::categoryCount() const
+{ return m_categoryCount; }
+
+qint64 DataGenerator::productCount() const
+{ return m_productCount; }
+
+qint64 DataGenerator::userCount() const
+{ return m_userCount; }
+
+qint64 DataGenerator::saleCount() const
+{ return m_saleCount; }
+
+QString DataGenerator::lastError() const
+{ return m_lastError; }
+
+bool DataGenerator::insertRows(const Connection &connection, const QString &statement, qint64 count, const RowGenerator &generator)
+{
+    // Generation is not measured, we go through QtSql directly using batched transactions
+    QSqlDatabase db = connection.database();
+    QSqlQuery query(db);
+    if (!query.prepare(statement)) {
+        m_lastError = query.lastError().text();
+        return false;
+    }
+
+    for (qint64 i(0); i < count; i += GENERATION_BATCH_SIZE) {
+        db.transaction();
+
+        const qint64 end = qMin(count, i + GENERATION_BATCH_SIZE);
+        for (qint64 row(i); row < end; ++row) {
+            const QVariantList values = generator(row);
+            for (const QVariant &value : values)
+                query.addBindValue(value);
+
+            if (!query.exec()) {
+                m_lastError = query.lastError().text();
+                db.rollback();
+                return false;
+            }
+        }
+
+        db.commit();
+    }
+
+    return true;
+}
@@ -0,0 +1,38 @@
+#ifndef DATAGENERATOR_H
+#define DATAGENERATOR_H
+
+#include <QEloquent/connection.h>
+
+#include <QRandomGenerator>
+
+#include <functional>
+
+// Deterministic store data, scaled on the product count
+class DataGenerator
+{
+public:
+    explicit DataGenerator(quint32 seed = 42);
+
+    bool migrate(const QEloquent::Connection &connection, const QString &structureFile);
+    bool generate(const QEloquent::Connection &connection, qint64 productCount);
+
+    qint64 categoryCount() const;
+    qint64 productCount() const;
+    qint64 userCount() const;
+    qint64 saleCount() const;
+
+    QString lastError() const;
+
+private:
+    typedef std::function<QVariantList (qint64)> RowGenerator;
+    bool insertRows(const QEloquent::Connection &connection, const QString &statement, qint64 count, const RowGenerator &generator);
+
+    QRandomGenerator m_random;
+    qint64 m_categoryCount = 0;
+    qint64 m_productCount = 0;
+    qint64 m_userCount = 0;
+    qint64 m_saleCount = 0;
+    QString m_lastError;
+};
+
+#endif // DATAGENERATOR_H
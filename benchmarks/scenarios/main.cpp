@@ -0,0 +1,174 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QTemporaryDir>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <QFile>
+#include <QBuffer>
+#include <QTextStream>
+#include <QDebug>
+
+#include <models/complexmodels.h>
+
+#include "datagenerator.h"
+#include "scenario.h"
+
+#define PAGE_SIZE        50
+#define BULK_BATCH_SIZE  100
+#define EXPORT_ROW_LIMIT 100000
+
+using namespace QEloquent;
+
+static QJsonObject runSize(qint64 size, quint32 seed, const QString &databaseFile)
+{
+    QJsonObject output;
+    output.insert("rows", size);
+
+    Connection connection = Connection::addConnection("DB", "QSQLITE", databaseFile);
+    if (!connection.open()) {
+        output.insert("error", "can't open database");
+        return output;
+    }
+
+    // Generation
+    DataGenerator generator(seed);
+    QElapsedTimer timer;
+    timer.start();
+
+    if (!generator.migrate(connection, QStringLiteral(TEST_DATA_DIR) + "/store/structure.sql")
+        || !generator.generate(connection, size)) {
+        output.insert("error", generator.lastError());
+        Connection::removeConnection("DB");
+        return output;
+    }
+
+    output.insert("generation_ms", timer.elapsed());
+
+    QRandomGenerator random(seed);
+    const int pageCount = int(qMax<qint64>(1, size / PAGE_SIZE));
+    QList<ScenarioResult> results;
+
+    // Point reads by primary key
+    results.append(Scenario::run("read", int(qMin<qint64>(1000, size)), [&random, size]() -> qint64 {
+        auto result = SimpleProduct::find(1 + random.bounded(int(size)));
+        return (result ? 1 : -1);
+    }));
+
+    // Paginated listing
+    results.append(Scenario::run("paginate", qMin(200, pageCount), [&random, pageCount]() -> qint64 {
+        auto result = SimpleProduct::paginate(1 + random.bounded(pageCount), PAGE_SIZE);
+        return (result ? result->size() : -1);
+    }));
+
+    // Same listing, eager loading stocks
+    results.append(Scenario::run("eager", qMin(200, pageCount), [&random, pageCount]() -> qint64 {
+        auto result = Product::paginate(1 + random.bounded(pageCount), PAGE_SIZE);
+        return (result ? result->size() : -1);
+    }));
+
+    // Bulk insert, one transaction per batch
+    int batch = 0;
+    results.append(Scenario::run("bulk_insert", int(qBound<qint64>(1, size / BULK_BATCH_SIZE, 100)), [&connection, &batch, size]() -> qint64 {
+        QList<QJsonObject> objects;
+        objects.reserve(BULK_BATCH_SIZE);
+        for (int i(0); i < BULK_BATCH_SIZE; ++i) {
+            const qint64 index = size + qint64(batch) * BULK_BATCH_SIZE + i;
+            objects.append(QJsonObject({
+                { "name", QStringLiteral("Product %1").arg(index) },
+                { "description", QStringLiteral("Bulk product %1").arg(index) },
+                { "price", 1.5 },
+                { "barcode", QStringLiteral("%1").arg(index, 13, 10, QLatin1Char('0')) },
+                { "category_id", 1 }
+            }));
+        }
+        ++batch;
+
+        connection.beginTransaction();
+        auto result = SimpleProduct::create(objects);
+        if (!result) {
+            connection.rollbackTransaction();
+            return -1;
+        }
+        connection.commitTransaction();
+        return result->size();
+    }));
+
+    // JSON export of a large slice
+    results.append(Scenario::run("export", 3, [&random, size]() -> qint64 {
+        const qint64 limit = qMin<qint64>(size, EXPORT_ROW_LIMIT);
+        Query query;
+        query.limit(int(limit)).offset(random.bounded(int(size - limit + 1)));
+
+        QBuffer buffer;
+        buffer.open(QIODevice::WriteOnly);
+
+        auto result = SimpleProduct::exportJson(&buffer, query);
+        return (result ? result.value() : -1);
+    }));
+
+    QJsonArray scenarios;
+    for (const ScenarioResult &result : std::as_const(results))
+        scenarios.append(result.toJson());
+    output.insert("scenarios", scenarios);
+
+    connection = Connection();
+    Connection::removeConnection("DB");
+    return output;
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    app.setApplicationName("QEloquentScenarios");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("End-to-end QEloquent scenarios on generated store data.");
+    parser.addHelpOption();
+    parser.addOption({ "sizes", "Comma separated product counts (10^3 to 10^7).", "sizes", "1000,10000,100000" });
+    parser.addOption({ "seed", "Data generator seed.", "seed", "42" });
+    parser.addOption({ "output", "JSON report file, standard output if not set.", "file" });
+    parser.addOption({ "memory", "Use an in-memory database instead of a temporary file." });
+    parser.process(app);
+
+    QList<qint64> sizes;
+    const QStringList items = parser.value("sizes").split(',', Qt::SkipEmptyParts);
+    for (const QString &item : items) {
+        bool ok = false;
+        const qint64 size = item.trimmed().toLongLong(&ok);
+        if (!ok || size < 1000 || size > 10000000) {
+            qCritical().noquote() << "QEloquentScenarios: invalid size" << item;
+            return 1;
+        }
+        sizes.append(size);
+    }
+
+    const quint32 seed = parser.value("seed").toUInt();
+
+    QTemporaryDir dir;
+    QJsonArray runs;
+    for (qint64 size : std::as_const(sizes)) {
+        const QString databaseFile = (parser.isSet("memory") ? QStringLiteral(":memory:") : dir.filePath(QStringLiteral("store_%1.sqlite").arg(size)));
+        runs.append(runSize(size, seed, databaseFile));
+    }
+
+    QJsonObject report;
+    report.insert("seed", qint64(seed));
+    report.insert("runs", runs);
+    const QByteArray json = QJsonDocument(report).toJson(QJsonDocument::Indented);
+
+    if (parser.isSet("output")) {
+        QFile file(parser.value("output"));
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            qCritical().noquote() << "QEloquentScenarios: can't write" << file.fileName();
+            return 1;
+        }
+        file.write(json);
+    } else {
+        QTextStream(stdout) << json;
+    }
+
+    return 0;
+}
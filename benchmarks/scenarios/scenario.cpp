@@ -0,0 +1,104 @@
+#include "scenario.h"
+
+#include <QElapsedTimer>
+#include <QJsonValue>
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(Q_OS_WIN)
+#   include <windows.h>
+#   include <psapi.h>
+#else
+#   include <sys/resource.h>
+#endif
+
+double ScenarioResult::throughput() const
+{
+    return (elapsedNs > 0 ? rows * 1e9 / elapsedNs : 0.0);
+}
+
+qint64 ScenarioResult::percentile(double ratio) const
+{
+    if (latenciesNs.isEmpty())
+        return 0;
+
+    // Nearest rank, latencies are sorted once the scenario ran
+    const qsizetype rank = qBound<qsizetype>(0, qsizetype(std::ceil(ratio * latenciesNs.size())) - 1, latenciesNs.size() - 1);
+    return latenciesNs.at(rank);
+}
+
+QJsonObject ScenarioResult::toJson() const
+{
+    QJsonObject object;
+    object.insert("name", name);
+    object.insert("operations", operations);
+    object.insert("rows", rows);
+    object.insert("elapsed_ms", elapsedNs / 1e6);
+    object.insert("throughput_rows_per_sec", throughput());
+
+    QJsonObject latency;
+    latency.insert("p50", percentile(0.50) / 1e3);
+    latency.insert("p95", percentile(0.95) / 1e3);
+    latency.insert("p99", percentile(0.99) / 1e3);
+    latency.insert("max", (latenciesNs.isEmpty() ? 0.0 : latenciesNs.last() / 1e3));
+    object.insert("latency_us", latency);
+
+    object.insert("peak_rss_kb", peakRssKb);
+
+    if (!error.isEmpty())
+        object.insert("error", error);
+
+    return object;
+}
+
+ScenarioResult Scenario::run(const QString &name, int operations, const Operation &operation)
+{
+    ScenarioResult result;
+    result.name = name;
+    result.latenciesNs.reserve(operations);
+
+    QElapsedTimer total;
+    total.start();
+
+    for (int i(0); i < operations; ++i) {
+        QElapsedTimer timer;
+        timer.start();
+
+        const qint64 rows = operation();
+        const qint64 elapsed = timer.nsecsElapsed();
+
+        if (rows < 0) {
+            result.error = QStringLiteral("operation %1 failed").arg(i);
+            break;
+        }
+
+        result.latenciesNs.append(elapsed);
+        result.rows += rows;
+        ++result.operations;
+    }
+
+    result.elapsedNs = total.nsecsElapsed();
+    result.peakRssKb = peakRssKb();
+    std::sort(result.latenciesNs.begin(), result.latenciesNs.end());
+    return result;
+}
+
+qint64 Scenario::peakRssKb()
+{
+#if defined(Q_OS_WIN)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        return qint64(counters.PeakWorkingSetSize / 1024);
+    return 0;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return 0;
+#   if defined(Q_OS_MACOS)
+    return usage.ru_maxrss / 1024; // bytes on macOS
+#   else
+    return usage.ru_maxrss;
+#   endif
+#endif
+}
@@ -0,0 +1,37 @@
+#ifndef SCENARIO_H
+#define SCENARIO_H
+
+#include <QString>
+#include <QList>
+#include <QJsonObject>
+
+#include <functional>
+
+struct ScenarioResult
+{
+    QString name;
+    qint64 operations = 0;
+    qint64 rows = 0;
+    qint64 elapsedNs = 0;
+    qint64 peakRssKb = 0;
+    QList<qint64> latenciesNs;
+    QString error;
+
+    double throughput() const;
+    qint64 percentile(double ratio) const;
+
+    QJsonObject toJson() const;
+};
+
+class Scenario
+{
+public:
+    // Runs one operation, returning the number of rows it processed, or -1 on failure
+    typedef std::function<qint64 ()> Operation;
+
+    static ScenarioResult run(const QString &name, int operations, const Operation &operation);
+
+    static qint64 peakRssKb();
+};
+
+#endif // SCENARIO_H
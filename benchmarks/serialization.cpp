@@ -0,0 +1,93 @@
+#include <benchmark/benchmark.h>
+
+#include <models/complexmodels.h>
+
+#include <QJsonDocument>
+#include <QBuffer>
+
+static bool loadProduct(benchmark::State &state, Product *product)
+{
+    auto result = Product::find(1);
+    if (!result) {
+        state.SkipWithError("Apple record not found");
+        return false;
+    }
+
+    *product = result.value();
+    return true;
+}
+
+static void BM_ToJson(benchmark::State &state)
+{
+    Product product;
+    if (!loadProduct(state, &product))
+        return;
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(product.toJson());
+}
+BENCHMARK(BM_ToJson);
+
+// Former toJson() path: maps, then QJsonObject, then QJsonDocument
+static void BM_ToJsonDocument(benchmark::State &state)
+{
+    Product product;
+    if (!loadProduct(state, &product))
+        return;
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(QJsonDocument(product.toJsonObject()).toJson(QJsonDocument::Compact));
+}
+BENCHMARK(BM_ToJsonDocument);
+
+static void BM_ExportJson(benchmark::State &state)
+{
+    for (auto _ : state) {
+        QBuffer buffer;
+        buffer.open(QIODevice::WriteOnly);
+        auto result = Product::exportJson(&buffer);
+        if (!result) {
+            state.SkipWithError("Export failed");
+            return;
+        }
+        benchmark::DoNotOptimize(buffer.data());
+    }
+}
+BENCHMARK(BM_ExportJson);
+
+static void BM_ToCsv(benchmark::State &state)
+{
+    Product product;
+    if (!loadProduct(state, &product))
+        return;
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(product.toCsv());
+}
+BENCHMARK(BM_ToCsv);
+
+static void BM_ToYaml(benchmark::State &state)
+{
+    Product product;
+    if (!loadProduct(state, &product))
+        return;
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(product.toYaml());
+}
+BENCHMARK(BM_ToYaml);
+
+static void BM_FillJson(benchmark::State &state)
+{
+    Product product;
+    if (!loadProduct(state, &product))
+        return;
+
+    const QJsonObject object = product.toJsonObject();
+    for (auto _ : state) {
+        Product copy;
+        copy.fill(object);
+        benchmark::DoNotOptimize(copy.name);
+    }
+}
+BENCHMARK(BM_FillJson);
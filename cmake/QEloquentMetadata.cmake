@@ -0,0 +1,269 @@
+# Build-time generation of QEloquent metadata descriptors
+#
+# qeloquent_generate_metadata(<target> HEADERS <header>... [OUTPUT <file>])
+#
+# Scans model headers for Q_CLASSINFO / Q_PROPERTY declarations and emits a source file holding
+# static descriptor tables, registered when the target is loaded. MetaObjectGenerator then reads
+# class infos, lists and field names from these tables instead of parsing them at runtime.
+#
+# The same file is run in script mode (cmake -P) to perform the generation itself.
+
+if (NOT CMAKE_SCRIPT_MODE_FILE)
+
+set(QELOQUENT_METADATA_SCRIPT ${CMAKE_CURRENT_LIST_FILE})
+
+function(qeloquent_generate_metadata target)
+    set(options)
+    set(oneValueArgs OUTPUT)
+    set(multiValueArgs HEADERS)
+    cmake_parse_arguments(ARG "${options}" "${oneValueArgs}" "${multiValueArgs}" ${ARGN})
+
+    if (NOT ARG_HEADERS)
+        message(FATAL_ERROR "qeloquent_generate_metadata: no HEADERS given for ${target}")
+    endif()
+
+    if (NOT ARG_OUTPUT)
+        set(ARG_OUTPUT ${CMAKE_CURRENT_BINARY_DIR}/${target}_qeloquent_metadata.cpp)
+    endif()
+
+    set(headers)
+    foreach (header ${ARG_HEADERS})
+        get_filename_component(header ${header} ABSOLUTE)
+        list(APPEND headers ${header})
+    endforeach()
+
+    string(REPLACE ";" "|" headerList "${headers}")
+
+    add_custom_command(
+        OUTPUT ${ARG_OUTPUT}
+        COMMAND ${CMAKE_COMMAND}
+            -DQELOQUENT_METADATA_HEADERS=${headerList}
+            -DQELOQUENT_METADATA_OUTPUT=${ARG_OUTPUT}
+            -P ${QELOQUENT_METADATA_SCRIPT}
+        DEPENDS ${headers} ${QELOQUENT_METADATA_SCRIPT}
+        COMMENT "Generating QEloquent metadata for ${target}"
+        VERBATIM
+    )
+
+    target_sources(${target} PRIVATE ${ARG_OUTPUT})
+endfunction()
+
+return()
+
+endif()
+
+# Script mode: generation
+
+cmake_policy(SET CMP0054 NEW)
+cmake_policy(SET CMP0057 NEW)
+
+# Mirrors NamingConvention::snakeFromCamel()
+function(_qeloquent_snake_from_camel input output)
+    string(REGEX REPLACE "([A-Z])" "_\\1" result "${input}")
+    string(REGEX REPLACE "([^0-9])([0-9])" "\\1_\\2" result "${result}")
+    string(REGEX REPLACE "^_" "" result "${result}")
+    string(TOLOWER "${result}" result)
+    set(${output} "${result}" PARENT_SCOPE)
+endfunction()
+
+function(_qeloquent_c_string input output)
+    string(REPLACE "\\" "\\\\" result "${input}")
+    string(REPLACE "\"" "\\\"" result "${result}")
+    set(${output} "\"${result}\"" PARENT_SCOPE)
+endfunction()
+
+string(REPLACE "|" ";" headers "${QELOQUENT_METADATA_HEADERS}")
+
+# Updates the namespace stack with the namespace openings and braces of input
+function(_qeloquent_track_namespaces input stack)
+    set(result ${${stack}})
+    string(REGEX MATCHALL "namespace[ \t\r\n]+[A-Za-z0-9_:]+[ \t\r\n]*{|[{}]" tokens "${input}")
+    foreach (token ${tokens})
+        if (token MATCHES "^namespace[ \t\r\n]+([A-Za-z0-9_:]+)")
+            list(APPEND result "${CMAKE_MATCH_1}")
+        elseif (token STREQUAL "{")
+            list(APPEND result "-") # Anonymous namespace or any other block
+        else()
+            list(LENGTH result depth)
+            if (depth GREATER 0)
+                list(REMOVE_AT result -1)
+            endif()
+        endif()
+    endforeach()
+    set(${stack} ${result} PARENT_SCOPE)
+endfunction()
+
+set(tables "")
+set(descriptors "")
+set(classNames "")
+set(count 0)
+
+foreach (header ${headers})
+    file(READ ${header} content)
+
+    # Dropping comments, they may contain macros
+    string(REGEX REPLACE "//[^\n]*" "" content "${content}")
+
+    # Splitting on class declarations, each chunk holds a class body
+    string(REGEX MATCHALL "class[ \t\r\n]+[A-Za-z0-9_ \t\r\n]*:[^{;]*{([^}]|}[^;])*" classes "${content}")
+
+    # Namespaces are tracked along the header, moc reports qualified class names
+    set(remaining "${content}")
+    set(namespaces "")
+
+    foreach (class ${classes})
+        string(FIND "${remaining}" "${class}" position)
+        string(SUBSTRING "${remaining}" 0 ${position} before)
+        _qeloquent_track_namespaces("${before}" namespaces)
+
+        set(scope "")
+        foreach (namespace ${namespaces})
+            if (NOT namespace STREQUAL "-")
+                string(APPEND scope "${namespace}::")
+            endif()
+        endforeach()
+
+        # The class body is balanced up to its closing brace, left in the remaining content
+        _qeloquent_track_namespaces("${class}" namespaces)
+        string(LENGTH "${class}" length)
+        math(EXPR position "${position} + ${length}")
+        string(SUBSTRING "${remaining}" ${position} -1 remaining)
+
+        if (NOT class MATCHES "Q_GADGET")
+            continue()
+        endif()
+
+        # Last identifier before ':' is the class name (export macros come first)
+        string(REGEX MATCH "class[ \t\r\n]+([A-Za-z0-9_ \t\r\n]*):" head "${class}")
+        string(STRIP "${CMAKE_MATCH_1}" head)
+        string(REGEX REPLACE "[ \t\r\n]+final$" "" head "${head}")
+        string(REGEX REPLACE ".*[ \t\r\n]" "" className "${head}")
+        set(className "${scope}${className}")
+
+        # Descriptors are looked up by qualified name, a duplicate would give one class the metadata of another
+        if ("${className}" IN_LIST classNames)
+            message(FATAL_ERROR "qeloquent_generate_metadata: ${className} is declared more than once (${header})")
+        endif()
+        list(APPEND classNames "${className}")
+
+        set(id ${count})
+        math(EXPR count "${count} + 1")
+
+        # Class infos, lists are split once here
+        string(REGEX MATCHALL "Q_CLASSINFO[ \t]*\\([ \t]*\"[^\"]*\"[ \t]*,[ \t]*\"[^\"]*\"[ \t]*\\)" infos "${class}")
+
+        set(infoEntries "")
+        set(infoCount 0)
+        set(naming "Laravel")
+        set(overrides "")
+        foreach (info ${infos})
+            string(REGEX MATCH "\"([^\"]*)\"[ \t]*,[ \t]*\"([^\"]*)\"" unused "${info}")
+            set(name "${CMAKE_MATCH_1}")
+            set(value "${CMAKE_MATCH_2}")
+
+            if (name STREQUAL "naming")
+                set(naming "${value}")
+            endif()
+
+            if (name MATCHES "^(.+)Field$")
+                list(APPEND overrides "${CMAKE_MATCH_1}=${value}")
+            endif()
+
+            string(REPLACE "," ";" values "${value}")
+            set(valueEntries "")
+            set(valueCount 0)
+            foreach (item ${values})
+                string(STRIP "${item}" item)
+                if (item STREQUAL "")
+                    continue()
+                endif()
+                _qeloquent_c_string("${item}" item)
+                string(APPEND valueEntries "${item}, ")
+                math(EXPR valueCount "${valueCount} + 1")
+            endforeach()
+
+            if (valueCount EQUAL 0)
+                string(APPEND tables "static const char *const values_${id}_${infoCount}[] = { nullptr };\n")
+            else()
+                string(APPEND tables "static const char *const values_${id}_${infoCount}[] = { ${valueEntries}};\n")
+            endif()
+
+            _qeloquent_c_string("${name}" name)
+            _qeloquent_c_string("${value}" value)
+            string(APPEND infoEntries "    { ${name}, ${value}, values_${id}_${infoCount}, ${valueCount} },\n")
+            math(EXPR infoCount "${infoCount} + 1")
+        endforeach()
+
+        if (infoCount GREATER 0)
+            string(APPEND tables "static const QEloquent::MetaInfoDescriptor infos_${id}[] = {\n${infoEntries}};\n")
+            set(infoTable "infos_${id}")
+        else()
+            set(infoTable "nullptr")
+        endif()
+
+        # Field names: explicit overrides first, then the naming convention when it is a known one
+        string(REGEX MATCHALL "Q_PROPERTY[ \t]*\\([^)]*\\)" properties "${class}")
+
+        set(fieldEntries "")
+        set(fieldCount 0)
+        foreach (property ${properties})
+            if (NOT property MATCHES "([A-Za-z_][A-Za-z0-9_]*)[ \t\r\n]+(READ|MEMBER)")
+                continue()
+            endif()
+            set(propertyName "${CMAKE_MATCH_1}")
+
+            set(fieldName "")
+            foreach (override ${overrides})
+                if (override MATCHES "^${propertyName}=(.*)$")
+                    set(fieldName "${CMAKE_MATCH_1}")
+                endif()
+            endforeach()
+
+            if (fieldName STREQUAL "")
+                if (naming STREQUAL "Laravel")
+                    _qeloquent_snake_from_camel("${propertyName}" fieldName)
+                elseif (naming STREQUAL "One One")
+                    set(fieldName "${propertyName}")
+                else()
+                    continue()
+                endif()
+            endif()
+
+            _qeloquent_c_string("${propertyName}" propertyName)
+            _qeloquent_c_string("${fieldName}" fieldName)
+            string(APPEND fieldEntries "    { ${propertyName}, ${fieldName} },\n")
+            math(EXPR fieldCount "${fieldCount} + 1")
+        endforeach()
+
+        if (fieldCount GREATER 0)
+            string(APPEND tables "static const QEloquent::MetaFieldDescriptor fields_${id}[] = {\n${fieldEntries}};\n")
+            set(fieldTable "fields_${id}")
+        else()
+            set(fieldTable "nullptr")
+        endif()
+
+        string(APPEND tables "\n")
+        _qeloquent_c_string("${naming}" naming)
+        string(APPEND descriptors "    { \"${className}\", ${naming}, ${infoTable}, ${infoCount}, ${fieldTable}, ${fieldCount} },\n")
+    endforeach()
+endforeach()
+
+set(output "// Generated by qeloquent_generate_metadata(), do not edit.\n\n")
+string(APPEND output "#include <QEloquent/metaobjectregistry.h>\n\n")
+string(APPEND output "namespace {\n\n")
+string(APPEND output "${tables}")
+if (count GREATER 0)
+    string(APPEND output "static const QEloquent::MetaObjectDescriptor descriptors[] = {\n${descriptors}};\n\n")
+    string(APPEND output "[[maybe_unused]] static const bool registered = QEloquent::MetaObjectRegistry::registerDescriptors(descriptors, ${count});\n\n")
+endif()
+string(APPEND output "} // namespace\n")
+
+# Only touching the output when it changes, to avoid useless rebuilds
+if (EXISTS ${QELOQUENT_METADATA_OUTPUT})
+    file(READ ${QELOQUENT_METADATA_OUTPUT} previous)
+    if (previous STREQUAL output)
+        return()
+    endif()
+endif()
+
+file(WRITE ${QELOQUENT_METADATA_OUTPUT} "${output}")
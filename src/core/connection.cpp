@@ -1,15 +1,26 @@
 #include "connection.h"
 
 #include <QEloquent/driver.h>
+#include <QEloquent/queryrunner.h>
+#include <QEloquent/metaobjectregistry.h>
 
 #include <QDateTime>
 #include <QTimeZone>
 #include <QSqlDatabase>
 #include <QSqlQuery>
 #include <QSqlError>
+#include <QSqlRecord>
+#include <QSqlField>
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QSaveFile>
+#include <QFile>
 #include <QUrl>
 #include <QUrlQuery>
 
+#define SCHEMA_SNAPSHOT_MAGIC   0x51455353 // "QESS"
+#define SCHEMA_SNAPSHOT_VERSION 1
+
 namespace QEloquent {
 
 class ConnectionData : public QSharedData
@@ -20,6 +31,15 @@ public:
     bool databaseConnectionOwned = false;
 
     Driver *driver = nullptr;
+
+    // Table records, fetched once per table or loaded from a schema snapshot
+    QHash<QString, QSqlRecord> tableRecords;
+
+    // Session settings (e.g. SQLite PRAGMAs), applied each time the connection is opened
+    QMap<QString, QString> sessionSettings;
+
+    // Whether a transaction was started through this connection and not yet ended
+    bool transactionOpen = false;
 };
 
 /*!
@@ -99,18 +119,22 @@ bool Connection::isOpen() const
 
 /*!
  * @brief Opens the connection using pre-configured parameters.
+ *
+ * The connection is closed again if its session settings can't be applied.
  */
 bool Connection::open()
 {
-    return database().open();
+    return database().open() && applySessionSettings();
 }
 
 /*!
  * @brief Opens the connection with specific credentials.
+ *
+ * The connection is closed again if its session settings can't be applied.
  */
 bool Connection::open(const QString &user, const QString &password)
 {
-    return database().open(user, password);
+    return database().open(user, password) && applySessionSettings();
 }
 
 /*!
@@ -118,6 +142,7 @@ bool Connection::open(const QString &user, const QString &password)
  */
 void Connection::close()
 {
+    data->transactionOpen = false;
     database().close();
 }
 
@@ -126,7 +151,10 @@ void Connection::close()
  */
 bool Connection::beginTransaction()
 {
-    return database().transaction();
+    const bool began = database().transaction();
+    if (began)
+        data->transactionOpen = true;
+    return began;
 }
 
 /*!
@@ -134,7 +162,10 @@ bool Connection::beginTransaction()
  */
 bool Connection::commitTransaction()
 {
-    return database().commit();
+    const bool committed = database().commit();
+    if (committed)
+        data->transactionOpen = false;
+    return committed;
 }
 
 /*!
@@ -142,9 +173,20 @@ bool Connection::commitTransaction()
  */
 bool Connection::rollbackTransaction()
 {
+    data->transactionOpen = false;
     return database().rollback();
 }
 
+/*!
+ * @brief Returns true while a transaction begun with beginTransaction() is neither committed nor rolled back.
+ *
+ * Transactions started by running BEGIN statements directly are not tracked.
+ */
+bool Connection::isInTransaction() const
+{
+    return data->transactionOpen;
+}
+
 QDateTime Connection::now() const
 {
     const QString statement = "SELECT " + data->driver->timestampDefault();
@@ -158,17 +200,81 @@ QDateTime Connection::now() const
     return QDateTime::currentDateTimeUtc();
 }
 
+/*!
+ * @brief Returns the session settings applied each time the connection is opened.
+ */
+QMap<QString, QString> Connection::sessionSettings() const
+{
+    return data->sessionSettings;
+}
+
+/*!
+ * @brief Sets the session setting \a name to \a value, applying it right away if the connection is open.
+ *
+ * Settings are driver specific (PRAGMAs on SQLite), unknown settings and invalid values are rejected.
+ *
+ * @sa Driver::sessionStatement()
+ */
+bool Connection::setSessionSetting(const QString &name, const QString &value)
+{
+    const QString statement = (data->driver ? data->driver->sessionStatement(name, value) : QString());
+    if (statement.isEmpty()) {
+        qWarning().noquote() << "QEloquent: unsupported setting" << name + '=' + value << "on connection" << data->connectionName;
+        return false;
+    }
+
+    data->sessionSettings.insert(name, value);
+    return !isOpen() || exec(statement).has_value();
+}
+
+/*!
+ * @brief Adds the session settings of the driver's performance profile \a profile, returns false if unknown.
+ *
+ * SQLite understands "throughput", "durable" and "bulk", see Driver::profileSettings().
+ */
+bool Connection::applyProfile(const QString &profile)
+{
+    const QMap<QString, QString> settings = (data->driver ? data->driver->profileSettings(profile) : QMap<QString, QString>());
+    if (settings.isEmpty()) {
+        qWarning().noquote() << "QEloquent: unknown profile" << profile << "on connection" << data->connectionName;
+        return false;
+    }
+
+    bool ok = true;
+    for (auto it = settings.constBegin(); it != settings.constEnd(); ++it)
+        ok = setSessionSetting(it.key(), it.value()) && ok;
+    return ok;
+}
+
+// Runs the session statements on a freshly opened database, closing it on failure
+bool Connection::applySessionSettings()
+{
+    for (auto it = data->sessionSettings.constBegin(); it != data->sessionSettings.constEnd(); ++it) {
+        auto result = exec(data->driver->sessionStatement(it.key(), it.value()));
+        if (!result) {
+            qWarning().noquote() << "QEloquent: can't apply" << it.key() + '=' + it.value() << "on connection" << data->connectionName
+                                 << '-' << result.error().text();
+            // Not left open half configured
+            close();
+            return false;
+        }
+    }
+
+    return true;
+}
+
 /*!
  * @brief Executes a raw SQL query on this connection.
  */
 Result<QSqlQuery, QSqlError> Connection::exec(const QString &query, bool cache) const
 {
-    QSqlQuery q(database());
-    q.setForwardOnly(!cache);
-    if (q.exec(query))
-        return q;
-    else
-        return failWith(q.lastError());
+    if (!QueryRunner::hasListeners())
+        return QueryRunner::execute(query, *this, !cache, nullptr);
+
+    QueryRecord record;
+    auto result = QueryRunner::execute(query, *this, !cache, &record);
+    QueryRunner::notify(record);
+    return result;
 }
 
 /*!
@@ -184,6 +290,165 @@ Driver *Connection::driver() const
     return data->driver;
 }
 
+/*!
+ * @brief Returns the record (field layout) of a table.
+ *
+ * The record is fetched from the database once per table then served from a cache,
+ * which can also be populated from a schema snapshot (see loadSchemaSnapshot()).
+ * An empty record is returned if the table can't be found or the connection is down.
+ */
+QSqlRecord Connection::record(const QString &tableName) const
+{
+    auto it = data->tableRecords.constFind(tableName);
+    if (it != data->tableRecords.constEnd())
+        return it.value();
+
+    if (!isOpen())
+        return QSqlRecord();
+
+    const QSqlRecord record = database().record(tableName);
+
+    // We don't cache missing tables, they might be created later
+    if (!record.isEmpty())
+        data->tableRecords.insert(tableName, record);
+
+    return record;
+}
+
+/*!
+ * @brief Drops cached table records, all of them if no table name is given.
+ *
+ * Call this after a schema change so that the next record() call hits the database again.
+ */
+void Connection::invalidateSchema(const QString &tableName)
+{
+    if (tableName.isEmpty())
+        data->tableRecords.clear();
+    else
+        data->tableRecords.remove(tableName);
+
+    MetaObjectRegistry::invalidateTableSchemas(data->connectionName, tableName);
+}
+
+/*!
+ * @brief Returns a token identifying the current database schema.
+ *
+ * The driver's schema version is used when available (e.g. PRAGMA schema_version on SQLite),
+ * otherwise a hash of the table names is computed, which doesn't change with columns.
+ */
+QString Connection::schemaVersion() const
+{
+    if (!isOpen())
+        return QString();
+
+    const QString statement = (data->driver ? data->driver->schemaVersionStatement() : QString());
+    if (!statement.isEmpty()) {
+        auto result = exec(statement);
+        if (result && result->next())
+            return result->value(0).toString();
+    }
+
+    QStringList tables = database().tables();
+    tables.sort();
+
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(tables.join(',').toUtf8());
+    return QString::fromLatin1(hash.result().toHex());
+}
+
+/*!
+ * @brief Loads table records from a snapshot file written by saveSchemaSnapshot().
+ *
+ * The snapshot is only accepted if it was saved with the same \a version, when no version
+ * is provided, schemaVersion() is used. On success, no introspection query is needed
+ * for the tables it contains.
+ *
+ * Without a driver schema version (see Driver::schemaVersionStatement()), an explicit \a version
+ * is required: the table names hash can't tell a column change.
+ */
+bool Connection::loadSchemaSnapshot(const QString &fileName, const QString &version)
+{
+    if (version.isEmpty() && (!data->driver || data->driver->schemaVersionStatement().isEmpty())) {
+        qWarning().noquote() << "QEloquent: schema snapshot" << fileName << "needs an explicit version on connection" << data->connectionName;
+        return false;
+    }
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_6_0);
+
+    quint32 magic = 0;
+    quint16 formatVersion = 0;
+    in >> magic >> formatVersion;
+    if (magic != SCHEMA_SNAPSHOT_MAGIC || formatVersion != SCHEMA_SNAPSHOT_VERSION)
+        return false;
+
+    QString snapshotVersion;
+    in >> snapshotVersion;
+    if (snapshotVersion != (version.isEmpty() ? schemaVersion() : version))
+        return false;
+
+    QHash<QString, QSqlRecord> records;
+
+    quint32 tableCount = 0;
+    in >> tableCount;
+    for (quint32 i(0); i < tableCount && in.status() == QDataStream::Ok; ++i) {
+        QString tableName;
+        quint32 fieldCount = 0;
+        in >> tableName >> fieldCount;
+
+        QSqlRecord record;
+        for (quint32 j(0); j < fieldCount && in.status() == QDataStream::Ok; ++j) {
+            QString fieldName;
+            int typeId = QMetaType::UnknownType;
+            in >> fieldName >> typeId;
+            record.append(QSqlField(fieldName, QMetaType(typeId), tableName));
+        }
+
+        records.insert(tableName, record);
+    }
+
+    if (in.status() != QDataStream::Ok)
+        return false;
+
+    data->tableRecords.insert(records);
+    return true;
+}
+
+/*!
+ * @brief Saves the record of every table of the database to a snapshot file.
+ *
+ * When no \a version is provided, schemaVersion() is used.
+ */
+bool Connection::saveSchemaSnapshot(const QString &fileName, const QString &version) const
+{
+    if (!isOpen())
+        return false;
+
+    QSaveFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_6_0);
+    out << quint32(SCHEMA_SNAPSHOT_MAGIC) << quint16(SCHEMA_SNAPSHOT_VERSION);
+    out << (version.isEmpty() ? schemaVersion() : version);
+
+    const QStringList tables = database().tables();
+    out << quint32(tables.size());
+    for (const QString &table : tables) {
+        const QSqlRecord record = this->record(table);
+        out << table << quint32(record.count());
+        for (int i(0); i < record.count(); ++i)
+            out << record.fieldName(i) << record.field(i).metaType().id();
+    }
+
+    return file.commit();
+}
+
 /*!
  * @brief Returns the underlaying QSqlDatabase (const).
  */
@@ -208,6 +473,23 @@ bool Connection::isValid() const
     return database().isValid();
 }
 
+/*!
+ * @brief Registers a copy of this connection as \a name, typically for use in another thread.
+ *
+ * The clone has its own database connection, sharing parameters and session settings, it is not opened.
+ */
+Connection Connection::clone(const QString &name) const
+{
+    QSqlDatabase db = QSqlDatabase::cloneDatabase(data->databaseConnectionName, name);
+    if (!db.isValid())
+        return Connection();
+
+    Connection con = addConnection(name, db, true);
+    con.data->sessionSettings = data->sessionSettings;
+    con.data->tableRecords = data->tableRecords;
+    return con;
+}
+
 /*!
  * @brief Implicit conversion to QSqlDatabase.
  */
@@ -237,6 +519,9 @@ Connection Connection::connection(const QString &name)
 
 /*!
  * @brief Adds a new connection using a URL.
+ *
+ * Besides the "options" and "numerical_precision" query items, a "profile" item selects a driver performance
+ * profile, other items being session settings overriding it, e.g. sqlite:///data.db?profile=throughput&cache_size=-32768.
  */
 Connection Connection::addConnection(const QString &name, const QUrl &url)
 {
@@ -265,25 +550,34 @@ Connection Connection::addConnection(const QString &name, const QUrl &url)
     db.setUserName(url.userName());
     db.setPassword(url.password());
 
-    if (url.hasQuery()) {
-        const QUrlQuery query(url.query());
+    const QUrlQuery query(url.query());
 
-        // Add connection options (if any)
-        if (query.hasQueryItem("options"))
-            db.setConnectOptions(query.queryItemValue("options"));
+    // Add connection options (if any)
+    if (query.hasQueryItem("options"))
+        db.setConnectOptions(query.queryItemValue("options"));
 
-        // Add numerical preceision (if defined)
-        if (query.hasQueryItem("numerical_precision")) {
-            const QString precesion = query.queryItemValue("numerical_precision");
-            if (precesion == "high")
-                db.setNumericalPrecisionPolicy(QSql::HighPrecision);
-            else
-                db.setNumericalPrecisionPolicy(QSql::LowPrecisionDouble);
-        }
+    // Add numerical preceision (if defined)
+    if (query.hasQueryItem("numerical_precision")) {
+        const QString precesion = query.queryItemValue("numerical_precision");
+        if (precesion == "high")
+            db.setNumericalPrecisionPolicy(QSql::HighPrecision);
+        else
+            db.setNumericalPrecisionPolicy(QSql::LowPrecisionDouble);
     }
 
-    // Registering and returning the connection
-    return addConnection(name, db, true);
+    // Registering the connection
+    Connection con = addConnection(name, db, true);
+
+    // Performance profile, then individual settings overriding it
+    if (query.hasQueryItem("profile"))
+        con.applyProfile(query.queryItemValue("profile"));
+
+    const QList<QPair<QString, QString>> items = query.queryItems(QUrl::FullyDecoded);
+    for (const QPair<QString, QString> &item : items)
+        if (item.first != "options" && item.first != "numerical_precision" && item.first != "profile")
+            con.setSessionSetting(item.first, item.second);
+
+    return con;
 }
 
 /*!
@@ -351,6 +645,9 @@ void Connection::removeConnection(const QString &name)
         if (s_defaultConnection == name)
             s_defaultConnection.clear();
 
+        // A connection added later under the same name may reach another database
+        MetaObjectRegistry::invalidateTableSchemas(name);
+
         if (con.data->databaseConnectionOwned)
             QSqlDatabase::removeDatabase(name);
     }
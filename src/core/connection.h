@@ -10,6 +10,7 @@ class QDateTime;
 class QSqlDatabase;
 class QSqlQuery;
 class QSqlError;
+class QSqlRecord;
 class QUrl;
 
 namespace QEloquent {
@@ -37,19 +38,33 @@ public:
     bool beginTransaction();
     bool commitTransaction();
     bool rollbackTransaction();
+    bool isInTransaction() const;
 
     QDateTime now() const;
 
+    QMap<QString, QString> sessionSettings() const;
+    bool setSessionSetting(const QString &name, const QString &value);
+    bool applyProfile(const QString &profile);
+
     Result<QSqlQuery, QSqlError> exec(const QString &query, bool cache = false) const;
     QSqlError lastError() const;
 
     Driver *driver() const;
 
+    QSqlRecord record(const QString &tableName) const;
+    void invalidateSchema(const QString &tableName = QString());
+
+    QString schemaVersion() const;
+    bool loadSchemaSnapshot(const QString &fileName, const QString &version = QString());
+    bool saveSchemaSnapshot(const QString &fileName, const QString &version = QString()) const;
+
     const QSqlDatabase database() const;
     QSqlDatabase database();
 
     bool isValid() const;
 
+    Connection clone(const QString &name) const;
+
     operator const QSqlDatabase() const;
     operator QSqlDatabase();
 
@@ -67,6 +82,8 @@ public:
 private:
     Connection(ConnectionData *data);
 
+    bool applySessionSettings();
+
     QExplicitlySharedDataPointer<ConnectionData> data;
 
     static QString s_defaultConnection;
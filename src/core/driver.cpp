@@ -2,6 +2,9 @@
 #include "driver_p.h"
 
 #include <QSqlDriver>
+#include <QSqlRecord>
+#include <QSqlQuery>
+#include <QRegularExpression>
 
 namespace QEloquent {
 
@@ -37,11 +40,359 @@ QString Driver::columnType(FieldType baseType, int length) const
     return QString();
 }
 
+/*!
+ * @brief Returns a statement giving a token which changes with the database schema, empty if unsupported.
+ *
+ * The default implementation hashes the columns listed by information_schema on PostgreSQL.
+ */
+QString Driver::schemaVersionStatement() const
+{
+    if (m_driver->dbmsType() != QSqlDriver::PostgreSQL)
+        return QString();
+
+    return QStringLiteral("SELECT md5(string_agg(table_name || ':' || column_name || ':' || data_type, ',' ORDER BY table_name, ordinal_position)) "
+                          "FROM information_schema.columns WHERE table_schema = current_schema()");
+}
+
+/*!
+ * @brief Returns the statement producing the execution plan of \a statement, empty if unsupported.
+ */
+QString Driver::explainStatement(const QString &statement) const
+{
+    return QStringLiteral("EXPLAIN ") + statement;
+}
+
+/*!
+ * @brief Returns the table fully scanned by the plan step \a planRow, if any.
+ *
+ * The default implementation understands MySQL ("type" ALL) and PostgreSQL ("Seq Scan on") plans.
+ */
+QString Driver::fullScanTable(const QSqlRecord &planRow) const
+{
+    if (planRow.contains("type") && planRow.contains("table")) {
+        if (planRow.value("type").toString().compare("ALL", Qt::CaseInsensitive) == 0)
+            return planRow.value("table").toString();
+        return QString();
+    }
+
+    static const QRegularExpression seqScan(QStringLiteral("Seq Scan on (\\S+)"));
+    for (int i(0); i < planRow.count(); ++i) {
+        const QRegularExpressionMatch match = seqScan.match(planRow.value(i).toString());
+        if (match.hasMatch())
+            return match.captured(1);
+    }
+
+    return QString();
+}
+
+/*!
+ * @brief Returns a statement reading the row count of \a tableName estimated by the server statistics, empty if unsupported.
+ *
+ * The first column of the first row holds the estimate, which must be cheap to obtain: no table is counted.
+ * The default implementation reads pg_class.reltuples on PostgreSQL.
+ */
+QString Driver::tableRowsEstimateStatement(const QString &tableName) const
+{
+    if (m_driver->dbmsType() != QSqlDriver::PostgreSQL)
+        return QString();
+
+    return QStringLiteral("SELECT reltuples FROM pg_class WHERE oid = to_regclass('%1')")
+        .arg(QString(tableName).replace('\'', "''"));
+}
+
+/*!
+ * @brief Returns the statement giving the server version, empty if unknown.
+ */
+QString Driver::versionStatement() const
+{
+    return QString();
+}
+
+/*!
+ * @brief Returns the server version, read once the connection is open then cached.
+ *
+ * A null version is returned while it can't be known, capabilities then assume an old server.
+ */
+QVersionNumber Driver::serverVersion() const
+{
+    if (m_version.isNull() && m_driver && m_driver->isOpen()) {
+        const QString statement = versionStatement();
+        if (!statement.isEmpty()) {
+            QSqlQuery query(m_driver->createResult());
+            if (query.exec(statement) && query.next())
+                m_version = QVersionNumber::fromString(query.value(0).toString());
+        }
+    }
+
+    return m_version;
+}
+
+/*!
+ * @brief Returns the maximum number of parameters bound to a single statement.
+ *
+ * Defaults are conservative, drivers describe what their backend actually supports.
+ */
+int Driver::maxBoundParameters() const
+{
+    return 999;
+}
+
+/*!
+ * @brief Returns the maximum length of a statement, in bytes.
+ */
+qint64 Driver::maxStatementLength() const
+{
+    return 1024 * 1024;
+}
+
+/*!
+ * @brief Returns true if INSERT, UPDATE and DELETE statements accept a RETURNING clause.
+ */
+bool Driver::supportsReturning() const
+{
+    return false;
+}
+
+/*!
+ * @brief Returns the syntax used to insert or update rows in a single statement.
+ */
+Driver::UpsertSyntax Driver::upsertSyntax() const
+{
+    return NoUpsert;
+}
+
+/*!
+ * @brief Returns true if INSERT statements accept several rows in their VALUES clause.
+ *
+ * The default implementation only assumes it on PostgreSQL and SQL Server (2008 and later).
+ */
+bool Driver::supportsMultiRowValues() const
+{
+    const QSqlDriver::DbmsType type = m_driver->dbmsType();
+    return type == QSqlDriver::PostgreSQL || type == QSqlDriver::MSSqlServer;
+}
+
+/*!
+ * @brief Returns true if window functions (OVER clauses) are available.
+ */
+bool Driver::supportsWindowFunctions() const
+{
+    return false;
+}
+
+/*!
+ * @brief Returns true if SAVEPOINT, RELEASE SAVEPOINT and ROLLBACK TO SAVEPOINT are available.
+ *
+ * The default implementation only assumes it on PostgreSQL, SQL Server having SAVE TRANSACTION instead.
+ */
+bool Driver::supportsSavepoints() const
+{
+    return m_driver->dbmsType() == QSqlDriver::PostgreSQL;
+}
+
+/*!
+ * @brief Returns the session settings of the performance profile \a profile, empty if unknown.
+ *
+ * Connections apply them, along with the settings given on their URL, each time they are opened.
+ *
+ * @sa sessionStatement()
+ */
+QMap<QString, QString> Driver::profileSettings(const QString &profile) const
+{
+    Q_UNUSED(profile);
+    return QMap<QString, QString>();
+}
+
+/*!
+ * @brief Returns true if \a name is a session setting understood by sessionStatement().
+ */
+bool Driver::supportsSessionSetting(const QString &name) const
+{
+    Q_UNUSED(name);
+    return false;
+}
+
+/*!
+ * @brief Returns the statement setting \a name to \a value for the current session, empty if invalid.
+ */
+QString Driver::sessionStatement(const QString &name, const QString &value) const
+{
+    Q_UNUSED(name);
+    Q_UNUSED(value);
+    return QString();
+}
+
+/*!
+ * @brief Returns a statement listing the secondary indexes of \a tableName, empty if unsupported.
+ *
+ * Rows hold the index name, a column name and whether the index is unique, columns of an index being listed in order.
+ * The default implementation reads pg_index on PostgreSQL, expression columns being left out.
+ */
+QString Driver::indexColumnsStatement(const QString &tableName) const
+{
+    if (m_driver->dbmsType() != QSqlDriver::PostgreSQL)
+        return QString();
+
+    return QStringLiteral("SELECT i.relname, a.attname, x.indisunique FROM pg_index x "
+                          "JOIN pg_class i ON i.oid = x.indexrelid "
+                          "CROSS JOIN LATERAL unnest(x.indkey) WITH ORDINALITY AS k(attnum, position) "
+                          "JOIN pg_attribute a ON a.attrelid = x.indrelid AND a.attnum = k.attnum "
+                          "WHERE x.indrelid = to_regclass('%1') AND NOT x.indisprimary ORDER BY i.relname, k.position")
+        .arg(QString(tableName).replace('\'', "''"));
+}
+
+// Plan details look like "SCAN Products" or "SCAN TABLE Products" (before 3.36), indexed scans mention "USING"
+QString SQLiteDriver::fullScanTable(const QSqlRecord &planRow) const
+{
+    static const QRegularExpression scan(QStringLiteral("^SCAN (?:TABLE )?([^\\s()]+)(.*)$"));
+
+    const QRegularExpressionMatch match = scan.match(planRow.value("detail").toString());
+    if (!match.hasMatch())
+        return QString();
+
+    const QString table = match.captured(1);
+    if (match.captured(2).contains("USING") || table == "CONSTANT" || table == "SUBQUERY")
+        return QString();
+    return table;
+}
+
+// sqlite_stat1 only exists once ANALYZE ran, its "stat" column starts with the table row count
+QString SQLiteDriver::tableRowsEstimateStatement(const QString &tableName) const
+{
+    return QStringLiteral("SELECT CAST(stat AS INTEGER) FROM sqlite_stat1 WHERE tbl = '%1' LIMIT 1")
+        .arg(QString(tableName).replace('\'', "''"));
+}
+
+QString SQLiteDriver::indexColumnsStatement(const QString &tableName) const
+{
+    return QStringLiteral("SELECT il.name, ii.name, il.\"unique\" FROM pragma_index_list('%1') AS il, pragma_index_info(il.name) AS ii ORDER BY il.seq, ii.seqno")
+        .arg(QString(tableName).replace('\'', "''"));
+}
+
+// Limit raised from 999 in 3.32.0
+int SQLiteDriver::maxBoundParameters() const
+{
+    return (serverVersion() >= QVersionNumber(3, 32) ? 32766 : 999);
+}
+
+// SQLITE_MAX_SQL_LENGTH default
+qint64 SQLiteDriver::maxStatementLength() const
+{
+    return 1000000000;
+}
+
+bool SQLiteDriver::supportsReturning() const
+{
+    return serverVersion() >= QVersionNumber(3, 35);
+}
+
+Driver::UpsertSyntax SQLiteDriver::upsertSyntax() const
+{
+    return (serverVersion() >= QVersionNumber(3, 24) ? OnConflictUpsert : NoUpsert);
+}
+
+bool SQLiteDriver::supportsMultiRowValues() const
+{
+    return serverVersion() >= QVersionNumber(3, 7, 11);
+}
+
+bool SQLiteDriver::supportsWindowFunctions() const
+{
+    return serverVersion() >= QVersionNumber(3, 25);
+}
+
+// Profiles:
+// - throughput: WAL journal, relaxed syncs, larger page cache and memory mapped I/O
+// - durable: WAL journal with full syncs
+// - bulk: in memory journal and no syncs, for one-off loads where the database can be rebuilt after a crash
+QMap<QString, QString> SQLiteDriver::profileSettings(const QString &profile) const
+{
+    if (profile == QStringLiteral("throughput")) {
+        return {
+            { "journal_mode", "WAL" },
+            { "synchronous", "NORMAL" },
+            { "cache_size", "-65536" },     // 64 MiB
+            { "mmap_size", "268435456" },   // 256 MiB
+            { "temp_store", "MEMORY" },
+            { "busy_timeout", "5000" }
+        };
+    }
+
+    if (profile == QStringLiteral("durable")) {
+        return {
+            { "journal_mode", "WAL" },
+            { "synchronous", "FULL" },
+            { "busy_timeout", "5000" }
+        };
+    }
+
+    if (profile == QStringLiteral("bulk")) {
+        return {
+            { "journal_mode", "MEMORY" },
+            { "synchronous", "OFF" },
+            { "cache_size", "-262144" },    // 256 MiB
+            { "temp_store", "MEMORY" },
+            { "busy_timeout", "5000" }
+        };
+    }
+
+    return QMap<QString, QString>();
+}
+
+bool SQLiteDriver::supportsSessionSetting(const QString &name) const
+{
+    static const QStringList pragmas = {
+        "journal_mode", "synchronous", "cache_size", "mmap_size", "temp_store", "busy_timeout",
+        "foreign_keys", "locking_mode", "wal_autocheckpoint", "page_size", "cache_spill"
+    };
+    return pragmas.contains(name);
+}
+
+QString SQLiteDriver::sessionStatement(const QString &name, const QString &value) const
+{
+    // Values end up in the statement, only plain keywords and numbers are accepted
+    static const QRegularExpression validValue(QStringLiteral("^-?[A-Za-z0-9_]+$"));
+    if (!supportsSessionSetting(name) || !validValue.match(value).hasMatch())
+        return QString();
+
+    return QStringLiteral("PRAGMA %1 = %2").arg(name, value);
+}
+
+// Order independent checksum of the columns, GROUP_CONCAT() results being truncated to group_concat_max_len
+QString MySQLDriver::schemaVersionStatement() const
+{
+    return QStringLiteral("SELECT CONCAT(COUNT(*), '-', SUM(CRC32(CONCAT_WS(':', TABLE_NAME, COLUMN_NAME, COLUMN_TYPE, ORDINAL_POSITION)))) "
+                          "FROM information_schema.COLUMNS WHERE TABLE_SCHEMA = DATABASE()");
+}
+
+// InnoDB estimate, refreshed by ANALYZE TABLE and background statistics updates
+QString MySQLDriver::tableRowsEstimateStatement(const QString &tableName) const
+{
+    return QStringLiteral("SELECT TABLE_ROWS FROM information_schema.TABLES WHERE TABLE_SCHEMA = DATABASE() AND TABLE_NAME = '%1'")
+        .arg(QString(tableName).replace('\'', "''"));
+}
+
+QString MySQLDriver::indexColumnsStatement(const QString &tableName) const
+{
+    return QStringLiteral("SELECT INDEX_NAME, COLUMN_NAME, NON_UNIQUE = 0 FROM information_schema.STATISTICS "
+                          "WHERE TABLE_SCHEMA = DATABASE() AND TABLE_NAME = '%1' ORDER BY INDEX_NAME, SEQ_IN_INDEX")
+        .arg(QString(tableName).replace('\'', "''"));
+}
+
+// MySQL 8.0, MariaDB versions (10.2 and later) being above too
+bool MySQLDriver::supportsWindowFunctions() const
+{
+    return serverVersion() >= QVersionNumber(8);
+}
+
 Driver *Driver::create(const QString &qtDriverName, QSqlDriver *qtDriver)
 {
     if (qtDriverName == QStringLiteral("QSQLITE"))
         return new SQLiteDriver(qtDriver);
 
+    if (qtDriverName == QStringLiteral("QMYSQL") || qtDriverName == QStringLiteral("QMARIADB"))
+        return new MySQLDriver(qtDriver);
+
     return new DefaultDriver(qtDriver);
 }
 
@@ -3,7 +3,11 @@
 
 #include <QEloquent/global.h>
 
+#include <QMap>
+#include <QVersionNumber>
+
 class QSqlDriver;
+class QSqlRecord;
 
 namespace QEloquent {
 
@@ -20,6 +24,13 @@ public:
         Timestamp
     };
 
+    enum UpsertSyntax {
+        NoUpsert,
+        OnConflictUpsert,       // INSERT ... ON CONFLICT (...) DO UPDATE
+        OnDuplicateKeyUpsert,   // INSERT ... ON DUPLICATE KEY UPDATE
+        MergeUpsert             // MERGE INTO ...
+    };
+
     Driver(QSqlDriver *qtDriver);
     virtual ~Driver() = default;
 
@@ -30,6 +41,28 @@ public:
 
     virtual QString columnType(FieldType baseType, int length) const;
 
+    virtual QString schemaVersionStatement() const;
+
+    virtual QString explainStatement(const QString &statement) const;
+    virtual QString fullScanTable(const QSqlRecord &planRow) const;
+    virtual QString tableRowsEstimateStatement(const QString &tableName) const;
+    virtual QString indexColumnsStatement(const QString &tableName) const;
+
+    virtual QString versionStatement() const;
+    QVersionNumber serverVersion() const;
+
+    virtual int maxBoundParameters() const;
+    virtual qint64 maxStatementLength() const;
+    virtual bool supportsReturning() const;
+    virtual UpsertSyntax upsertSyntax() const;
+    virtual bool supportsMultiRowValues() const;
+    virtual bool supportsWindowFunctions() const;
+    virtual bool supportsSavepoints() const;
+
+    virtual QMap<QString, QString> profileSettings(const QString &profile) const;
+    virtual bool supportsSessionSetting(const QString &name) const;
+    virtual QString sessionStatement(const QString &name, const QString &value) const;
+
     virtual bool supportsForeignKeys() const = 0;
     virtual QString foreignKeyConstraint(const QString& column,
                                          const QString& refTable,
@@ -41,6 +74,8 @@ public:
 
 private:
     QSqlDriver *m_driver;
+
+    mutable QVersionNumber m_version;
 };
 
 } // namespace QEloquent
@@ -42,6 +42,33 @@ public:
     QString timestampDefault() const override
     { return QStringLiteral("CURRENT_TIMESTAMP"); }
 
+    QString schemaVersionStatement() const override
+    { return QStringLiteral("PRAGMA schema_version"); }
+
+    QString explainStatement(const QString &statement) const override
+    { return QStringLiteral("EXPLAIN QUERY PLAN ") + statement; }
+
+    QString fullScanTable(const QSqlRecord &planRow) const override;
+    QString tableRowsEstimateStatement(const QString &tableName) const override;
+    QString indexColumnsStatement(const QString &tableName) const override;
+
+    QString versionStatement() const override
+    { return QStringLiteral("SELECT sqlite_version()"); }
+
+    int maxBoundParameters() const override;
+    qint64 maxStatementLength() const override;
+    bool supportsReturning() const override;
+    UpsertSyntax upsertSyntax() const override;
+    bool supportsMultiRowValues() const override;
+    bool supportsWindowFunctions() const override;
+
+    bool supportsSavepoints() const override
+    { return true; }
+
+    QMap<QString, QString> profileSettings(const QString &profile) const override;
+    bool supportsSessionSetting(const QString &name) const override;
+    QString sessionStatement(const QString &name, const QString &value) const override;
+
     bool supportsForeignKeys() const override
     { return true; }
 
@@ -63,6 +90,30 @@ public:
     QString timestampDefault() const override
     { return QStringLiteral("NOW()"); }
 
+    QString schemaVersionStatement() const override;
+    QString tableRowsEstimateStatement(const QString &tableName) const override;
+    QString indexColumnsStatement(const QString &tableName) const override;
+
+    QString versionStatement() const override
+    { return QStringLiteral("SELECT VERSION()"); }
+
+    int maxBoundParameters() const override
+    { return 65535; }
+
+    qint64 maxStatementLength() const override
+    { return 4 * 1024 * 1024; } // Default max_allowed_packet of MySQL 5.7
+
+    UpsertSyntax upsertSyntax() const override
+    { return OnDuplicateKeyUpsert; }
+
+    bool supportsMultiRowValues() const override
+    { return true; }
+
+    bool supportsWindowFunctions() const override;
+
+    bool supportsSavepoints() const override
+    { return true; }
+
     bool supportsForeignKeys() const override
     { return true; }
 
@@ -1,18 +1,28 @@
 #include "genericmodel.h"
-#include "genericmodel_p.h"
-
-#include <QEloquent/private/model_p.h>
 
 namespace QEloquent {
 
+/*!
+ * @class QEloquent::GenericModel
+ * @brief Model of a table known only at runtime, described by MetaObject::fromTable().
+ *
+ * Columns are dynamic properties, each instance only holds their values. Use it through Generic:
+ * @code
+ * auto products = Generic<"products">::all();
+ * @endcode
+ */
+
 GenericModel::GenericModel()
-    : GenericModel(ModelInfo())
+    : Model(MetaObject())
 {}
 
-GenericModel::GenericModel(const ModelInfo &info)
-    : Model(new GenericModelData(info))
-{
-}
+GenericModel::GenericModel(const MetaObject &metaObject)
+    : Model(metaObject)
+{}
+
+GenericModel::GenericModel(const QString &tableName, const QString &connectionName)
+    : Model(MetaObject::fromTable(tableName, connectionName))
+{}
 
 GenericModel::GenericModel(const GenericModel &other)
     : Model(other)
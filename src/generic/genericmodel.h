@@ -5,6 +5,8 @@
 #include <QEloquent/model.h>
 #include <QEloquent/modelhelpers.h>
 
+#include <algorithm>
+
 namespace QEloquent {
 
 class QELOQUENT_EXPORT GenericModel : public Model
@@ -13,7 +15,8 @@ class QELOQUENT_EXPORT GenericModel : public Model
 
 public:
     GenericModel();
-    GenericModel(const ModelInfo &info);
+    GenericModel(const MetaObject &metaObject);
+    GenericModel(const QString &tableName, const QString &connectionName = QString());
     GenericModel(const GenericModel &other);
     GenericModel(GenericModel &&other);
     GenericModel &operator=(const GenericModel &other);
@@ -48,12 +51,14 @@ class GenericModelMaker
 {
 public:
     static GenericModel make()
-    { return GenericModel(info()); }
+    { return GenericModel(metaObject()); }
 
-    static ModelInfo info()
+    // Resolved through the schema cache, names being converted once
+    static MetaObject metaObject()
     {
-        const Connection con = (connection ? Connection::connection(connection.string()) : Connection::defaultConnection());
-        return con.modelInfo(table.string());
+        static const QString tableName = table.string();
+        static const QString connectionName = connection.string();
+        return MetaObject::fromTable(tableName, connectionName);
     }
 };
 
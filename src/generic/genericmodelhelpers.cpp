@@ -1,7 +0,0 @@
-#include "genericmodelhelpers.h"
-
-namespace QEloquent {
-
-GenericModelHelpers::GenericModelHelpers() {}
-
-} // namespace QEloquent
@@ -0,0 +1,118 @@
+#ifndef QELOQUENT_FIELDACCESSOR_H
+#define QELOQUENT_FIELDACCESSOR_H
+
+#include <QEloquent/global.h>
+
+#include <QVariant>
+#include <QMetaType>
+
+#define QELOQUENT_PARENS ()
+
+#define QELOQUENT_EXPAND(...) QELOQUENT_EXPAND4(QELOQUENT_EXPAND4(QELOQUENT_EXPAND4(QELOQUENT_EXPAND4(__VA_ARGS__))))
+#define QELOQUENT_EXPAND4(...) QELOQUENT_EXPAND3(QELOQUENT_EXPAND3(QELOQUENT_EXPAND3(QELOQUENT_EXPAND3(__VA_ARGS__))))
+#define QELOQUENT_EXPAND3(...) QELOQUENT_EXPAND2(QELOQUENT_EXPAND2(QELOQUENT_EXPAND2(QELOQUENT_EXPAND2(__VA_ARGS__))))
+#define QELOQUENT_EXPAND2(...) QELOQUENT_EXPAND1(QELOQUENT_EXPAND1(QELOQUENT_EXPAND1(QELOQUENT_EXPAND1(__VA_ARGS__))))
+#define QELOQUENT_EXPAND1(...) __VA_ARGS__
+
+#define QELOQUENT_FOR_EACH(macro, Class, ...) \
+    __VA_OPT__(QELOQUENT_EXPAND(QELOQUENT_FOR_EACH_HELPER(macro, Class, __VA_ARGS__)))
+#define QELOQUENT_FOR_EACH_HELPER(macro, Class, member, ...) \
+    macro(Class, member) __VA_OPT__(QELOQUENT_FOR_EACH_AGAIN QELOQUENT_PARENS (macro, Class, __VA_ARGS__))
+#define QELOQUENT_FOR_EACH_AGAIN() QELOQUENT_FOR_EACH_HELPER
+
+#define QELOQUENT_FIELD_ACCESSOR(Class, member) QEloquent::FieldAccessor::make<&Class::member>(#member),
+
+/*!
+ * Declares typed accessors for the listed data members, each one must back a property of the same name.
+ * @code
+ * QELOQUENT_FIELDS(Product, id, name, price, barcode)
+ * @endcode
+ */
+#define QELOQUENT_FIELDS(Class, ...) \
+public: \
+    static QList<QEloquent::FieldAccessor> qeloquentFields() \
+    { return { QELOQUENT_FOR_EACH(QELOQUENT_FIELD_ACCESSOR, Class, __VA_ARGS__) }; } \
+private:
+
+namespace QEloquent {
+
+class Model;
+
+/*!
+ * @brief Direct, member pointer based, access to a model property.
+ *
+ * Accessors bypass the Qt meta-object system when reading and writing standard properties.
+ * They are declared using QELOQUENT_FIELDS() and installed by MetaObject::from().
+ */
+struct FieldAccessor
+{
+    typedef QVariant (*Reader)(const Model *model);
+    typedef bool (*Writer)(Model *model, const QVariant &value);
+
+    const char *propertyName;
+    QMetaType metaType;
+    Reader reader;
+    Writer writer;
+
+    template<auto Member>
+    static FieldAccessor make(const char *propertyName);
+
+private:
+    template<typename M> struct MemberTraits;
+    template<typename C, typename T> struct MemberTraits<T C::*>
+    {
+        typedef C Class;
+        typedef T Type;
+    };
+
+    template<auto Member>
+    static QVariant read(const Model *model);
+
+    template<auto Member>
+    static bool write(Model *model, const QVariant &value);
+};
+
+template<auto Member>
+inline FieldAccessor FieldAccessor::make(const char *propertyName)
+{
+    typedef typename MemberTraits<decltype(Member)>::Type Type;
+    return { propertyName, QMetaType::fromType<Type>(), &read<Member>, &write<Member> };
+}
+
+template<auto Member>
+inline QVariant FieldAccessor::read(const Model *model)
+{
+    typedef typename MemberTraits<decltype(Member)>::Class Class;
+    return QVariant::fromValue(static_cast<const Class *>(model)->*Member);
+}
+
+template<auto Member>
+inline bool FieldAccessor::write(Model *model, const QVariant &value)
+{
+    typedef typename MemberTraits<decltype(Member)>::Class Class;
+    typedef typename MemberTraits<decltype(Member)>::Type Type;
+
+    Class *object = static_cast<Class *>(model);
+
+    // Same behavior as QMetaProperty::write(): invalid values reset to default
+    if (!value.isValid()) {
+        object->*Member = Type();
+        return true;
+    }
+
+    if (value.metaType() == QMetaType::fromType<Type>()) {
+        object->*Member = *static_cast<const Type *>(value.constData());
+        return true;
+    }
+
+    QVariant converted = value;
+    if (!converted.convert(QMetaType::fromType<Type>()))
+        return false;
+
+    object->*Member = *static_cast<const Type *>(converted.constData());
+    return true;
+}
+
+} // namespace QEloquent
+
+#endif // QELOQUENT_FIELDACCESSOR_H
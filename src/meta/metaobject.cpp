@@ -4,12 +4,21 @@
 #include <QEloquent/datamap.h>
 #include <QEloquent/metaproperty.h>
 #include <QEloquent/metaobjectgenerator.h>
+#include <QEloquent/metaobjectregistry.h>
 #include <QEloquent/namingconvention.h>
 #include <QEloquent/connection.h>
 #include <QEloquent/model.h>
 #include <QEloquent/private/model_p.h>
 #include <QEloquent/private/metaproperty_p.h>
 
+#include <QSqlQuery>
+#include <QSqlRecord>
+#include <QHash>
+#include <QMutex>
+#include <QReadLocker>
+#include <QWriteLocker>
+#include <QDebug>
+
 namespace QEloquent {
 
 MetaObject::MetaObject()
@@ -47,7 +56,7 @@ MetaObject::~MetaObject()
 
 QString MetaObject::className() const
 {
-    return (d->metaObject == nullptr ? QString() : QString(d->metaObject->className()));
+    return (d->metaObject == nullptr ? d->className : QString(d->metaObject->className()));
 }
 
 QString MetaObject::tableName() const
@@ -128,6 +137,22 @@ MetaProperty MetaObject::deletionTimestamp() const
 
 MetaProperty MetaObject::property(const QString &name, PropertyNameResolution resolution) const
 {
+    const int index = propertyIndex(name, resolution);
+    return (index < 0 ? MetaProperty() : d->properties.at(index));
+}
+
+/*!
+ * \brief Returns the index of the property named \a name, or -1.
+ *
+ * Generated meta objects look names up in hashes, others are searched linearly.
+ */
+int MetaObject::propertyIndex(const QString &name, PropertyNameResolution resolution) const
+{
+    if (d->indexed) {
+        const QHash<QString, int> &index = (resolution == ResolveByFieldName ? d->fieldNameIndex : d->propertyNameIndex);
+        return index.value(name, -1);
+    }
+
     auto it = std::find_if(d->properties.constBegin(), d->properties.constEnd(), [&name, &resolution](const MetaProperty &property) {
         switch (resolution) {
         case ResolveByPropertyName:
@@ -141,13 +166,36 @@ MetaProperty MetaObject::property(const QString &name, PropertyNameResolution re
         }
     });
 
-    return (it == d->properties.constEnd() ? MetaProperty() : *it);
+    return (it == d->properties.constEnd() ? -1 : int(it - d->properties.constBegin()));
 }
 
 QList<MetaProperty> MetaObject::properties(
     MetaProperty::PropertyAttributes attributes,
     PropertyFilters filters) const
 {
+    return properties(attributes, filters, MetaProperty::NoAttibutes);
+}
+
+/*!
+ * \brief Returns properties having any of \a attributes and none of \a exclusions, filtered by type.
+ *
+ * Subsets are computed once per meta object and shared afterwards.
+ */
+QList<MetaProperty> MetaObject::properties(
+    MetaProperty::PropertyAttributes attributes,
+    PropertyFilters filters,
+    MetaProperty::PropertyAttributes exclusions) const
+{
+    const quint64 key = quint64(attributes.toInt())
+                        | (quint64(exclusions.toInt()) << 16)
+                        | (quint64(filters.toInt()) << 32);
+
+    QMutexLocker locker(&d->subsetsMutex);
+
+    auto it = d->propertySubsets.constFind(key);
+    if (it != d->propertySubsets.constEnd())
+        return it.value();
+
     QList<MetaProperty> result;
 
     for (const MetaProperty& prop : std::as_const(d->properties)) {
@@ -175,42 +223,21 @@ QList<MetaProperty> MetaObject::properties(
         else
             filterMatch = (prop.attributes() & attributes) != MetaProperty::NoAttibutes;
 
+        if ((prop.attributes() & exclusions) != MetaProperty::NoAttibutes)
+            filterMatch = false;
+
         if (typeMatch && filterMatch)
             result.append(prop);
     }
 
+    d->propertySubsets.insert(key, result);
     return result;
 }
 
 QList<MetaProperty> MetaObject::properties(PropertyFilters filters) const
 {
     if (filters == AllProperties) return d->properties;
-
-    QList<MetaProperty> result;
-
-    for (const MetaProperty& prop : std::as_const(d->properties)) {
-        bool typeMatch;
-
-        // Filter by type
-        if (filters == AllProperties) {
-            typeMatch = true;
-        } else {
-            typeMatch = false;
-            if (filters.testFlag(StandardProperties) && prop.propertyType() == MetaProperty::StandardProperty)
-                typeMatch = true;
-            if (filters.testFlag(DynamicProperties) && prop.propertyType() == MetaProperty::DynamicProperty)
-                typeMatch = true;
-            if (filters.testFlag(AppendedProperties) && prop.propertyType() == MetaProperty::AppendedProperty)
-                typeMatch = true;
-            if (filters.testFlag(RelationProperties) && prop.propertyType() == MetaProperty::RelationProperty)
-                typeMatch = true;
-        }
-
-        if (typeMatch)
-            result.append(prop);
-    }
-
-    return result;
+    return properties(MetaProperty::NoAttibutes, filters, MetaProperty::NoAttibutes);
 }
 
 DataMap MetaObject::read(const Model *model,
@@ -275,6 +302,46 @@ int MetaObject::write(Model *model, const DataMap &data, PropertyNameResolution
     return written;
 }
 
+/*!
+ * \brief Maps each column of \a record to the property it hydrates.
+ *
+ * The mapping is meant to be computed once per result set, columns without a matching
+ * property (or not writable from database rows) are mapped to an invalid property.
+ */
+QList<MetaProperty> MetaObject::recordMapping(const QSqlRecord &record) const
+{
+    static const MetaProperty::PropertyAttributes attributes =
+        MetaProperty::PrimaryProperty | MetaProperty::FillableProperty |
+        MetaProperty::CreationTimestamp | MetaProperty::UpdateTimestamp | MetaProperty::DeletionTimestamp;
+
+    QHash<QString, MetaProperty> fields;
+    const QList<MetaProperty> properties = this->properties(attributes, StandardProperties | DynamicProperties);
+    for (const MetaProperty &property : properties)
+        fields.insert(property.fieldName(), property);
+
+    QList<MetaProperty> mapping;
+    mapping.reserve(record.count());
+    for (int i(0); i < record.count(); ++i)
+        mapping.append(fields.value(record.fieldName(i)));
+    return mapping;
+}
+
+/*!
+ * \brief Writes the current row of \a query to \a model, following a mapping from recordMapping().
+ */
+int MetaObject::write(Model *model, const QSqlQuery &query, const QList<MetaProperty> &mapping) const
+{
+    int written = 0;
+
+    for (int i(0); i < mapping.size(); ++i) {
+        const MetaProperty &property = mapping.at(i);
+        if (property.isValid() && property.write(model, query.value(i)))
+            ++written;
+    }
+
+    return written;
+}
+
 DataMap MetaObject::readFillableFields(const Model *model) const
 {
     return read(model,
@@ -287,9 +354,9 @@ bool MetaObject::writeFillableFields(Model *model, const DataMap &data)
 {
     bool allWritten = true;
 
-    const QStringList fields = data.keys();
-    for (const MetaProperty &property : std::as_const(d->properties))
-        if (property.hasAttribute(MetaProperty::FillableProperty) && fields.contains(property.fieldName()))
+    const QList<MetaProperty> properties = this->properties(MetaProperty::FillableProperty, AllProperties);
+    for (const MetaProperty &property : properties)
+        if (data.contains(property.fieldName()))
             if (!property.write(model, data.value(property.fieldName())))
                 allWritten = false;
 
@@ -348,15 +415,121 @@ Connection MetaObject::connection() const
     return Connection::connection(d->connectionName);
 }
 
+/*!
+ * \brief Returns the slot holding the dynamic value named \a propertyName in models, or -1.
+ *
+ * Slots are shared by all models of this meta object, which only store values.
+ * Declared dynamic properties get theirs at generation, other names when \a create is true.
+ */
+int MetaObject::dynamicSlot(const QString &propertyName, bool create) const
+{
+    {
+        QReadLocker locker(&d->dynamicLock);
+        const int slot = d->dynamicSlots.value(propertyName, -1);
+        if (slot >= 0 || !create)
+            return slot;
+    }
+
+    QWriteLocker locker(&d->dynamicLock);
+    auto it = d->dynamicSlots.constFind(propertyName);
+    if (it != d->dynamicSlots.constEnd())
+        return it.value();
+
+    const int slot = d->dynamicNames.size();
+    d->dynamicNames.append(propertyName);
+    d->dynamicSlots.insert(propertyName, slot);
+    return slot;
+}
+
+/*!
+ * \brief Same as dynamicSlot() for a field name, converted by the naming convention only once.
+ */
+int MetaObject::dynamicFieldSlot(const QString &fieldName, bool create) const
+{
+    {
+        QReadLocker locker(&d->dynamicLock);
+        const int slot = d->dynamicFieldSlots.value(fieldName, -1);
+        if (slot >= 0)
+            return slot;
+    }
+
+    const QString propertyName = namingConvention()->propertyName(fieldName, d->tableName);
+    const int slot = dynamicSlot(propertyName, create);
+
+    if (slot >= 0) {
+        QWriteLocker locker(&d->dynamicLock);
+        d->dynamicFieldSlots.insert(fieldName, slot);
+    }
+
+    return slot;
+}
+
+QString MetaObject::dynamicSlotName(int slot) const
+{
+    QReadLocker locker(&d->dynamicLock);
+    return d->dynamicNames.value(slot);
+}
+
+int MetaObject::dynamicSlotCount() const
+{
+    QReadLocker locker(&d->dynamicLock);
+    return d->dynamicNames.size();
+}
+
 bool MetaObject::isValid() const
 {
     return d->primaryPropertyIndex >= 0 && !d->connectionName.isEmpty();
 }
 
+bool MetaObject::hasFieldAccessors() const
+{
+    return d->hasFieldAccessors.load(std::memory_order_acquire);
+}
+
+void MetaObject::installFieldAccessors(const QList<FieldAccessor> &accessors)
+{
+    static QMutex mutex;
+    QMutexLocker locker(&mutex);
+
+    if (hasFieldAccessors())
+        return;
+
+    for (const FieldAccessor &accessor : accessors) {
+        const QString propertyName = QString::fromLatin1(accessor.propertyName);
+
+        auto it = std::find_if(d->properties.begin(), d->properties.end(), [&propertyName](const MetaProperty &property) {
+            return property.propertyName() == propertyName;
+        });
+
+        // Accessors only apply to standard properties of the very same type
+        if (it == d->properties.end() || it->propertyType() != MetaProperty::StandardProperty || it->metaType() != accessor.metaType) {
+            qWarning().noquote().nospace() << "MetaObject: no accessor installed for " << d->metaObject->className()
+                                           << "::" << propertyName << ", no matching property found";
+            continue;
+        }
+
+        it->data->reader.store(accessor.reader, std::memory_order_release);
+        it->data->writer.store(accessor.writer, std::memory_order_release);
+    }
+
+    d->hasFieldAccessors.store(true, std::memory_order_release);
+}
+
 MetaObject MetaObject::fromQtMetaObject(const QMetaObject &metaObject)
 {
     static MetaObjectGenerator generator;
     return generator.generate(metaObject, true);
 }
 
+/*!
+ * \brief Returns a meta object describing \a tableName, read from the schema of \a connectionName.
+ *
+ * Meta objects are cached per connection and table, and shared by all GenericModel instances.
+ * Connection::invalidateSchema() drops them.
+ */
+MetaObject MetaObject::fromTable(const QString &tableName, const QString &connectionName)
+{
+    return MetaObjectRegistry::tableSchemaMetaObject(tableName, (connectionName.isEmpty() ? Connection::defaultConnectionName() : connectionName));
+}
+
 }
@@ -3,6 +3,7 @@
 
 #include <QEloquent/global.h>
 #include <QEloquent/metaproperty.h>
+#include <QEloquent/fieldaccessor.h>
 
 #include <QSharedDataPointer>
 
@@ -12,6 +13,7 @@ class QMetaMethod;
 
 class QSqlRecord;
 class QSqlField;
+class QSqlQuery;
 
 namespace QEloquent {
 
@@ -65,8 +67,12 @@ public:
     MetaProperty deletionTimestamp() const;
 
     MetaProperty property(const QString &name, PropertyNameResolution resolution = ResolveByPropertyName) const;
+    int propertyIndex(const QString &name, PropertyNameResolution resolution = ResolveByPropertyName) const;
     QList<MetaProperty> properties(MetaProperty::PropertyAttributes attributes,
                                    PropertyFilters filters = AllProperties) const;
+    QList<MetaProperty> properties(MetaProperty::PropertyAttributes attributes,
+                                   PropertyFilters filters,
+                                   MetaProperty::PropertyAttributes exclusions) const;
     QList<MetaProperty> properties(PropertyFilters filters = AllProperties) const;
 
     DataMap read(const Model *model,
@@ -82,6 +88,9 @@ public:
               const DataMap &data,
               PropertyNameResolution resolution = ResolveByPropertyName) const;
 
+    QList<MetaProperty> recordMapping(const QSqlRecord &record) const;
+    int write(Model *model, const QSqlQuery &query, const QList<MetaProperty> &mapping) const;
+
     DataMap readFillableFields(const Model *model) const;
     bool writeFillableFields(Model *model, const DataMap &data);
 
@@ -96,15 +105,24 @@ public:
     QString connectionName() const;
     Connection connection() const;
 
+    int dynamicSlot(const QString &propertyName, bool create = false) const;
+    int dynamicFieldSlot(const QString &fieldName, bool create = false) const;
+    QString dynamicSlotName(int slot) const;
+    int dynamicSlotCount() const;
+
     bool isValid() const;
 
     template<typename T, std::enable_if<std::is_base_of<Model, T>::value>::type* = nullptr>
-    static MetaObject from() { return fromQtMetaObject(T::staticMetaObject); }
+    static MetaObject from();
     static MetaObject fromQtMetaObject(const QMetaObject &metaObject);
+    static MetaObject fromTable(const QString &tableName, const QString &connectionName = QString());
 
 private:
     MetaObject(MetaObjectPrivate *data);
 
+    bool hasFieldAccessors() const;
+    void installFieldAccessors(const QList<FieldAccessor> &accessors);
+
     QExplicitlySharedDataPointer<MetaObjectPrivate> d;
 
     friend class MetaObjectGenerator;
@@ -114,4 +132,22 @@ private:
 
 Q_DECLARE_OPERATORS_FOR_FLAGS(QEloquent::MetaObject::PropertyFilters)
 
+namespace QEloquent {
+
+template<typename T, std::enable_if<std::is_base_of<Model, T>::value>::type*>
+inline MetaObject MetaObject::from()
+{
+    MetaObject object = fromQtMetaObject(T::staticMetaObject);
+
+    // Typed accessors declared with QELOQUENT_FIELDS() are installed once per meta object
+    if constexpr (requires { T::qeloquentFields(); }) {
+        if (object.isValid() && !object.hasFieldAccessors())
+            object.installFieldAccessors(T::qeloquentFields());
+    }
+
+    return object;
+}
+
+} // namespace QEloquent
+
 #endif // QELOQUENT_METAOBJECT_H
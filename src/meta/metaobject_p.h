@@ -6,8 +6,13 @@
 #include <QEloquent/metaproperty.h>
 
 #include <QMap>
+#include <QHash>
+#include <QMutex>
+#include <QReadWriteLock>
 #include <QMetaType>
 
+#include <atomic>
+
 namespace QEloquent {
 
 class MetaObjectPrivate : public QSharedData
@@ -15,6 +20,7 @@ class MetaObjectPrivate : public QSharedData
 public:
     virtual ~MetaObjectPrivate() = default;
 
+    QString className; // When not backed by a QMetaObject
     QString tableName;
 
     int primaryPropertyIndex = -1;
@@ -29,6 +35,42 @@ public:
 
     QString namingConvention = QStringLiteral("Laravel");
     const QMetaObject *metaObject = nullptr;
+
+    std::atomic<bool> hasFieldAccessors = false;
+
+    // Property subsets, keyed by attributes, exclusions and filters
+    QHash<quint64, QList<MetaProperty>> propertySubsets;
+    QMutex subsetsMutex;
+
+    // Hashed lookups, built once properties are known
+    bool indexed = false;
+    QHash<QString, int> propertyNameIndex;
+    QHash<QString, int> fieldNameIndex;
+
+    void buildIndexes()
+    {
+        propertyNameIndex.clear();
+        fieldNameIndex.clear();
+        propertyNameIndex.reserve(properties.size());
+        fieldNameIndex.reserve(properties.size());
+
+        // First property wins, as with a linear search
+        for (int i(0); i < properties.size(); ++i) {
+            const MetaProperty &property = properties.at(i);
+            if (!propertyNameIndex.contains(property.propertyName()))
+                propertyNameIndex.insert(property.propertyName(), i);
+            if (!fieldNameIndex.contains(property.fieldName()))
+                fieldNameIndex.insert(property.fieldName(), i);
+        }
+
+        indexed = true;
+    }
+
+    // Slots of dynamic values, shared by all models of this meta object
+    QStringList dynamicNames;
+    QHash<QString, int> dynamicSlots;      // By property name
+    QHash<QString, int> dynamicFieldSlots; // By field name
+    QReadWriteLock dynamicLock;
 };
 
 }
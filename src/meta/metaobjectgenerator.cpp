@@ -8,6 +8,9 @@
 
 #include <QSqlDatabase>
 #include <QSqlRecord>
+#include <QSqlField>
+#include <QSqlIndex>
+#include <QHash>
 
 #define META_TABLE          "table"
 #define META_PRIMARY        "primary"
@@ -32,6 +35,7 @@ struct MetaObjectGeneration {
         , qtMetaObject(qtMetaObject)
         , convention(nullptr) {
         object->metaObject = qtMetaObject;
+        loadDescriptors();
     }
 
     MetaObjectPrivate *object;
@@ -39,22 +43,37 @@ struct MetaObjectGeneration {
 
     NamingConvention *convention;
     Connection connection;
+    QSqlRecord record;
 
     QStringList append;
     QStringList fillable;
     QStringList hidden;
 
+    // Build-time metadata, merged along the class hierarchy (see qeloquent_generate_metadata())
+    bool hasDescriptors = false;
+    QHash<QString, QStringList> descriptorInfos;
+    QHash<QString, QString> descriptorRawInfos;
+    QHash<QString, QString> descriptorFields;
+
     bool hasInfo(const QString &name) const
-    { return infoIndex(name) >= 0; }
+    { return (hasDescriptors ? descriptorInfos.contains(name) : infoIndex(name) >= 0); }
 
     QString info(const QString &name, const QString &defaultValue = QString()) const
     {
+        if (hasDescriptors) {
+            auto it = descriptorRawInfos.constFind(name);
+            return (it == descriptorRawInfos.constEnd() ? defaultValue : it.value());
+        }
+
         const int index = infoIndex(name);
         return (index < 0 ? defaultValue : QString(qtMetaObject->classInfo(index).value()));
     }
 
     QStringList infoList(const QString &name) const
     {
+        if (hasDescriptors)
+            return descriptorInfos.value(name);
+
         QStringList items = info(name).split(',', Qt::SkipEmptyParts);
         for (QString &item : items)
             item = item.trimmed();
@@ -63,6 +82,68 @@ struct MetaObjectGeneration {
 
     int infoIndex(const QString &name) const
     { return qtMetaObject->indexOfClassInfo(name.toStdString().c_str()); }
+
+    QString fieldName(const QString &propertyName) const
+    {
+        if (hasDescriptors)
+            return descriptorFields.value(propertyName);
+
+        const int index = infoIndex(QStringLiteral(META_PROPERTY_FIELD).arg(propertyName));
+        return (index < 0 ? QString() : QString(qtMetaObject->classInfo(index).value()));
+    }
+
+    void loadDescriptors()
+    {
+        // Every class down to Model must be described, otherwise we fall back to Qt class infos
+        QList<const MetaObjectDescriptor *> descriptors;
+        for (const QMetaObject *mo = qtMetaObject; mo && qstrcmp(mo->className(), "QEloquent::Model") != 0; mo = mo->superClass()) {
+            const MetaObjectDescriptor *descriptor = MetaObjectRegistry::descriptor(mo->className());
+            if (!descriptor)
+                return;
+            descriptors.append(descriptor);
+        }
+
+        if (descriptors.isEmpty())
+            return;
+
+        // Derived classes infos take precedence, just like QMetaObject::indexOfClassInfo()
+        for (const MetaObjectDescriptor *descriptor : std::as_const(descriptors)) {
+            for (int i(0); i < descriptor->infoCount; ++i) {
+                const MetaInfoDescriptor &info = descriptor->infos[i];
+                const QString name = QString::fromLatin1(info.name);
+                if (descriptorInfos.contains(name))
+                    continue;
+
+                QStringList values;
+                values.reserve(info.valueCount);
+                for (int j(0); j < info.valueCount; ++j)
+                    values.append(QString::fromUtf8(info.values[j]));
+                descriptorInfos.insert(name, values);
+                descriptorRawInfos.insert(name, QString::fromUtf8(info.value));
+            }
+        }
+
+        // Precomputed field names are only valid under the naming in effect
+        const QString naming = descriptorRawInfos.value(META_NAMING, QStringLiteral("Laravel"));
+        for (const MetaObjectDescriptor *descriptor : std::as_const(descriptors)) {
+            if (naming != QLatin1String(descriptor->naming))
+                continue;
+
+            for (int i(0); i < descriptor->fieldCount; ++i) {
+                const QString propertyName = QString::fromLatin1(descriptor->fields[i].propertyName);
+                if (!descriptorFields.contains(propertyName))
+                    descriptorFields.insert(propertyName, QString::fromLatin1(descriptor->fields[i].fieldName));
+            }
+        }
+
+        // Explicit overrides always win
+        for (auto it = descriptorRawInfos.constBegin(); it != descriptorRawInfos.constEnd(); ++it) {
+            if (it.key().size() > 5 && it.key().endsWith(QLatin1String("Field")))
+                descriptorFields.insert(it.key().chopped(5), it.value());
+        }
+
+        hasDescriptors = true;
+    }
 };
 
 MetaObjectGenerator::MetaObjectGenerator()
@@ -94,6 +175,66 @@ MetaObject MetaObjectGenerator::generate(const QMetaObject &modelMetaObject, boo
     return object;
 }
 
+/*!
+ * \brief Generates a meta object describing \a tableName from the database schema, for GenericModel.
+ *
+ * Every column becomes a dynamic property stored in a slot. The primary key comes from the database, falling back to 'id'.
+ * Timestamps are detected by their conventional field names. The result is not cached, see MetaObject::fromTable().
+ */
+MetaObject MetaObjectGenerator::generate(const QString &tableName, const QString &connectionName)
+{
+    Connection connection = Connection::connection(connectionName);
+    const QSqlRecord record = connection.record(tableName);
+    if (record.isEmpty()) {
+        qWarning().noquote().nospace() << "MetaObjectGenerator: table '" << tableName << "' not found on connection '" << connectionName << '\'';
+        return MetaObject();
+    }
+
+    MetaObjectPrivate *object = new MetaObjectPrivate();
+    object->className = QStringLiteral("QEloquent::GenericModel");
+    object->tableName = tableName;
+    object->connectionName = connection.name();
+
+    NamingConvention *convention = NamingConvention::convention(object->namingConvention);
+    const QSqlIndex primaryIndex = connection.database().primaryIndex(tableName);
+    const QString primaryField = (primaryIndex.isEmpty() ? convention->fieldName(QStringLiteral("id"), tableName) : primaryIndex.fieldName(0));
+    const QString creationField = convention->fieldName(QStringLiteral("createdAt"), tableName);
+    const QString updateField = convention->fieldName(QStringLiteral("updatedAt"), tableName);
+    const QString deletionField = convention->fieldName(QStringLiteral("deletedAt"), tableName);
+
+    for (int i(0); i < record.count(); ++i) {
+        MetaPropertyData *property = new MetaPropertyData();
+        property->fieldName = record.fieldName(i);
+        property->propertyName = convention->propertyName(property->fieldName, tableName);
+        property->metaType = record.field(i).metaType();
+        property->propertyType = MetaProperty::DynamicProperty;
+        property->attributes = MetaProperty::DatabaseField | MetaProperty::FillableProperty;
+
+        property->slot = object->dynamicNames.size();
+        object->dynamicNames.append(property->propertyName);
+        object->dynamicSlots.insert(property->propertyName, property->slot);
+
+        if (property->fieldName == primaryField) {
+            property->attributes = MetaProperty::DatabaseField | MetaProperty::PrimaryProperty;
+            object->primaryPropertyIndex = i;
+        } else if (property->fieldName == creationField) {
+            property->attributes = MetaProperty::DatabaseField | MetaProperty::CreationTimestamp;
+            object->creationTimestampIndex = i;
+        } else if (property->fieldName == updateField) {
+            property->attributes = MetaProperty::DatabaseField | MetaProperty::UpdateTimestamp;
+            object->updateTimestampIndex = i;
+        } else if (property->fieldName == deletionField) {
+            property->attributes = MetaProperty::DatabaseField | MetaProperty::DeletionTimestamp;
+            object->deletionTimestampIndex = i;
+        }
+
+        object->properties.append(MetaProperty(property));
+    }
+
+    object->buildIndexes();
+    return MetaObject(object);
+}
+
 bool MetaObjectGenerator::initGeneration(MetaObjectGeneration *generation)
 {
     generation->convention = (generation->hasInfo(META_NAMING) ? NamingConvention::convention(generation->info(META_NAMING)) : NamingConvention::convention());
@@ -104,13 +245,12 @@ bool MetaObjectGenerator::initGeneration(MetaObjectGeneration *generation)
     generation->object->connectionName = generation->connection.name();
     generation->object->relations = generation->infoList("with");
 
-    if (generation->connection.isOpen()) {
-        const QSqlRecord record = generation->connection.database().record(generation->object->tableName);
-        if (record.isEmpty()) {
-            qWarning().noquote().nospace()
-                    << "MetaObjectGenerator: can't check if " << className
-                << " has an actual database table named '" << generation->object->tableName << '\'';
-        }
+    // Table record is fetched once and shared by all properties
+    generation->record = generation->connection.record(generation->object->tableName);
+    if (generation->record.isEmpty() && generation->connection.isOpen()) {
+        qWarning().noquote().nospace()
+                << "MetaObjectGenerator: can't check if " << className
+            << " has an actual database table named '" << generation->object->tableName << '\'';
     }
 
     generation->append = generation->infoList(META_APPEND);
@@ -161,8 +301,9 @@ void MetaObjectGenerator::discoverProperties(MetaObjectGeneration *generation)
             continue;
         }
 
+        // Getters taking a call site are listed twice by moc, the parameterless clone is the one we invoke
         const QByteArray typeName(method.returnMetaType().name());
-        if (typeName.startsWith("QEloquent::Relation<") || typeName.startsWith("Relation<")) {
+        if (method.parameterCount() == 0 && (typeName.startsWith("QEloquent::Relation<") || typeName.startsWith("Relation<"))) {
             MetaPropertyData *property = new MetaPropertyData();
             property->propertyName = method.name();
             property->propertyType = MetaProperty::RelationProperty;
@@ -202,6 +343,9 @@ void MetaObjectGenerator::discoverProperties(MetaObjectGeneration *generation)
         property->propertyType = MetaProperty::DynamicProperty;
         property->metaType = QMetaType::fromType<QVariant>();
         property->attributes = MetaProperty::FillableProperty | MetaProperty::DatabaseField;
+        property->slot = generation->object->dynamicNames.size();
+        generation->object->dynamicNames.append(propertyName);
+        generation->object->dynamicSlots.insert(propertyName, property->slot);
         dynamicProperties.append(property);
     }
 
@@ -211,6 +355,8 @@ void MetaObjectGenerator::discoverProperties(MetaObjectGeneration *generation)
     const QList<MetaPropertyData *> allProperties = firstClass + append + relations + dynamicProperties;
     for (MetaPropertyData *property : allProperties)
         tuneProperty(index, property, generation, true);
+
+    generation->object->buildIndexes();
 }
 
 void MetaObjectGenerator::tuneProperty(int &index, MetaPropertyData *property, MetaObjectGeneration *generation, bool save)
@@ -220,11 +366,9 @@ void MetaObjectGenerator::tuneProperty(int &index, MetaPropertyData *property, M
         ++index;
 
     // Field name: first we check if it get ovirriden by the user (META_PROPERTY_FIELD for the format), if not, we deduce using convention
-    const int fieldNameIndex = generation->qtMetaObject->indexOfClassInfo(QStringLiteral(META_PROPERTY_FIELD).arg(property->propertyName).toStdString().c_str());
-    if (fieldNameIndex < 0)
+    property->fieldName = generation->fieldName(property->propertyName);
+    if (property->fieldName.isEmpty())
         property->fieldName = generation->convention->fieldName(property->propertyName, generation->object->tableName);
-    else
-        property->fieldName = generation->qtMetaObject->classInfo(fieldNameIndex).value();
 
     // Fillable default if no fillable directives set or if the property has been marked explicitly
     if (property->attributes.testFlag(MetaProperty::FillableProperty)) {
@@ -239,21 +383,17 @@ void MetaObjectGenerator::tuneProperty(int &index, MetaPropertyData *property, M
     // Is DB field ?
     if (property->attributes.testFlag(MetaProperty::DatabaseField)) {
         const Connection &conn = generation->connection;
-        static const QString errorStrPrefixTemplate = "MetaObjectGenerator: can't check if %1::%2 has an actual database field named '%3', ";
-        const QString errorStrPrefix = errorStrPrefixTemplate
-                                           .arg(generation->qtMetaObject->className(),
-                                                property->propertyName,
-                                                property->fieldName);
-
-        if (conn.isOpen()) {
-            const QSqlRecord record = conn.database().record(generation->object->tableName);
-            if (!record.isEmpty()) {
-                const int index = record.indexOf(property->fieldName);
-                if (index < 0)
-                    property->attributes.setFlag(MetaProperty::DatabaseField, false);
-            } else {
-                qDebug() .noquote().nospace() << errorStrPrefix << "database table '" << generation->object->tableName << "' not found.";
-            }
+
+        if (!generation->record.isEmpty()) {
+            if (generation->record.indexOf(property->fieldName) < 0)
+                property->attributes.setFlag(MetaProperty::DatabaseField, false);
+        } else if (conn.isOpen()) {
+            static const QString errorStrPrefixTemplate = "MetaObjectGenerator: can't check if %1::%2 has an actual database field named '%3', ";
+            const QString errorStrPrefix = errorStrPrefixTemplate
+                                               .arg(generation->qtMetaObject->className(),
+                                                    property->propertyName,
+                                                    property->fieldName);
+            qDebug() .noquote().nospace() << errorStrPrefix << "database table '" << generation->object->tableName << "' not found.";
         } else {
             qDebug().noquote().nospace() << "connection '" << conn.name() << "' is down.";
         }
@@ -299,7 +439,7 @@ void MetaObjectGenerator::tuneProperty(int &index, MetaPropertyData *property, M
     }
 
     if (property->propertyName == generation->info(META_DELETED_AT, "deletedAt")) {
-        property->attributes.setFlag(MetaProperty::CreationTimestamp);
+        property->attributes.setFlag(MetaProperty::DeletionTimestamp);
         property->attributes.setFlag(MetaProperty::FillableProperty, false);
         generation->object->deletionTimestampIndex = index;
     }
@@ -17,6 +17,7 @@ public:
 
     template<typename Model> MetaObject generate(bool cache = true) { return generate(Model::staticMetaObject, cache); }
     MetaObject generate(const QMetaObject &modelMetaObject, bool cache = true);
+    MetaObject generate(const QString &tableName, const QString &connectionName);
 
 private:
     bool initGeneration(MetaObjectGeneration *generation);
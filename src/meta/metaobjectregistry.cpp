@@ -1,9 +1,12 @@
 #include "metaobjectregistry.h"
 
 #include <QEloquent/metaobject.h>
+#include <QEloquent/metaobjectgenerator.h>
 #include <QEloquent/connection.h>
 
 #include <QList>
+#include <QHash>
+#include <QMutex>
 
 namespace QEloquent {
 
@@ -51,6 +54,103 @@ void MetaObjectRegistry::registerMetaObject(const MetaObject &object)
         s_metaObjects.replace(std::distance(s_metaObjects.constBegin(), it), object);
 }
 
+// Schema driven meta objects, by connection and table name
+static QHash<QPair<QString, QString>, MetaObject> &tableSchemaRegistry()
+{
+    static QHash<QPair<QString, QString>, MetaObject> metaObjects;
+    return metaObjects;
+}
+
+static QMutex &tableSchemaMutex()
+{
+    static QMutex mutex;
+    return mutex;
+}
+
+/*!
+ * @brief Returns the meta object generated from the schema of \a tableName, generating it on first use.
+ */
+MetaObject MetaObjectRegistry::tableSchemaMetaObject(const QString &tableName, const QString &connectionName)
+{
+    const QPair<QString, QString> key(connectionName, tableName);
+
+    {
+        QMutexLocker locker(&tableSchemaMutex());
+        auto it = tableSchemaRegistry().constFind(key);
+        if (it != tableSchemaRegistry().constEnd())
+            return it.value();
+    }
+
+    // Generated unlocked, it queries the database
+    MetaObjectGenerator generator;
+    const MetaObject object = generator.generate(tableName, connectionName);
+    if (object.tableName().isEmpty())
+        return object; // Unknown table, not cached
+
+    QMutexLocker locker(&tableSchemaMutex());
+    return *tableSchemaRegistry().insert(key, object);
+}
+
+/*!
+ * @brief Drops schema driven meta objects of \a connectionName, only the one of \a tableName if not empty.
+ *
+ * Models already created keep their meta object.
+ */
+void MetaObjectRegistry::invalidateTableSchemas(const QString &connectionName, const QString &tableName)
+{
+    QMutexLocker locker(&tableSchemaMutex());
+    QHash<QPair<QString, QString>, MetaObject> &metaObjects = tableSchemaRegistry();
+
+    if (!tableName.isEmpty()) {
+        metaObjects.remove(QPair<QString, QString>(connectionName, tableName));
+        return;
+    }
+
+    metaObjects.removeIf([&connectionName](const QHash<QPair<QString, QString>, MetaObject>::iterator &it) {
+        return it.key().first == connectionName;
+    });
+}
+
+// Descriptors are registered by static initializers, possibly before s_metaObjects exists
+static QHash<QString, const MetaObjectDescriptor *> &descriptorRegistry()
+{
+    static QHash<QString, const MetaObjectDescriptor *> descriptors;
+    return descriptors;
+}
+
+static QMutex &descriptorMutex()
+{
+    static QMutex mutex;
+    return mutex;
+}
+
+const MetaObjectDescriptor *MetaObjectRegistry::descriptor(const QString &className)
+{
+    QMutexLocker locker(&descriptorMutex());
+    const QHash<QString, const MetaObjectDescriptor *> &descriptors = descriptorRegistry();
+
+    auto it = descriptors.constFind(className);
+    return (it == descriptors.constEnd() ? nullptr : it.value());
+}
+
+bool MetaObjectRegistry::registerDescriptors(const MetaObjectDescriptor *descriptors, int count)
+{
+    QMutexLocker locker(&descriptorMutex());
+    QHash<QString, const MetaObjectDescriptor *> &registry = descriptorRegistry();
+
+    for (int i(0); i < count; ++i) {
+        const QString className = QString::fromLatin1(descriptors[i].className);
+
+        // Another target describing the same class, one of them would get the wrong metadata
+        auto it = registry.constFind(className);
+        if (it != registry.constEnd() && it.value() != descriptors + i)
+            qFatal("MetaObjectRegistry: %s is described more than once", descriptors[i].className);
+
+        registry.insert(className, descriptors + i);
+    }
+    return true;
+}
+
 QList<MetaObject> MetaObjectRegistry::s_metaObjects;
 
 } // namespace QEloquent
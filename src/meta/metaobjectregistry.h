@@ -7,6 +7,42 @@ namespace QEloquent {
 
 class MetaObject;
 
+/*!
+ * @brief Build-time class info, raw value as declared and list values already split and trimmed.
+ */
+struct MetaInfoDescriptor
+{
+    const char *name;
+    const char *value;
+    const char *const *values;
+    int valueCount;
+};
+
+/*!
+ * @brief Build-time property to field name mapping.
+ */
+struct MetaFieldDescriptor
+{
+    const char *propertyName;
+    const char *fieldName;
+};
+
+/*!
+ * @brief Build-time metadata of a model class, as emitted by qeloquent_generate_metadata().
+ *
+ * Only the class own declarations are described, inherited ones come from the parent descriptor.
+ * Class names are fully qualified, as reported by QMetaObject::className().
+ */
+struct MetaObjectDescriptor
+{
+    const char *className;
+    const char *naming;
+    const MetaInfoDescriptor *infos;
+    int infoCount;
+    const MetaFieldDescriptor *fields;
+    int fieldCount;
+};
+
 class QELOQUENT_EXPORT MetaObjectRegistry
 {
 public:
@@ -17,6 +53,12 @@ public:
     static MetaObject tableMetaObject(const QString &tableName, const QString &connectionName);
     static void registerMetaObject(const MetaObject &object);
 
+    static MetaObject tableSchemaMetaObject(const QString &tableName, const QString &connectionName);
+    static void invalidateTableSchemas(const QString &connectionName, const QString &tableName = QString());
+
+    static const MetaObjectDescriptor *descriptor(const QString &className);
+    static bool registerDescriptors(const MetaObjectDescriptor *descriptors, int count);
+
 private:
     static QList<MetaObject> s_metaObjects;
 };
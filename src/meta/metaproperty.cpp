@@ -77,12 +77,19 @@ QVariant MetaProperty::read(const Model *model) const
 {
     QVariant value;
 
+    if (data->propertyType == StandardProperty) {
+        const FieldAccessor::Reader reader = data->reader.load(std::memory_order_acquire);
+        if (reader)
+            return reader(model);
+    }
+
     if (data->propertyType == StandardProperty && data->metaProperty.isValid()) {
         value = data->metaProperty.readOnGadget(model);
     }
 
-    if (data->propertyType == DynamicProperty && model->data->dynamicProperties.contains(data->propertyName)) {
-        value = model->data->dynamicProperties.value(data->propertyName);
+    if (data->propertyType == DynamicProperty) {
+        const int slot = (data->slot >= 0 ? data->slot : model->data->metaObject.dynamicSlot(data->propertyName));
+        value = model->data->dynamicValue(slot);
     }
 
     if (data->propertyType == AppendedProperty && data->getter.isValid()) {
@@ -116,12 +123,15 @@ bool MetaProperty::write(Model *model, const QVariant &value) const
     }
 
     if (data->propertyType == StandardProperty) {
+        const FieldAccessor::Writer writer = data->writer.load(std::memory_order_acquire);
+        if (writer)
+            return writer(model, val);
         return data->metaProperty.writeOnGadget(model, val);
     }
 
     if (data->propertyType == DynamicProperty) {
-        DataMap &dynamic = model->data->dynamicProperties;
-        dynamic.insert(data->propertyName, val);
+        const int slot = (data->slot >= 0 ? data->slot : model->data->metaObject.dynamicSlot(data->propertyName, true));
+        model->data->setDynamicValue(slot, val);
         return true;
     }
 
@@ -3,10 +3,14 @@
 
 #include "metaproperty.h"
 
+#include <QEloquent/fieldaccessor.h>
+
 #include <QMetaType>
 #include <QMetaProperty>
 #include <QMetaMethod>
 
+#include <atomic>
+
 namespace QEloquent {
 
 class MetaPropertyData : public QSharedData
@@ -22,6 +26,13 @@ public:
     QMetaMethod getter;
     QMetaMethod setter;
 
+    // Typed accessors, see QELOQUENT_FIELDS(), installed while other threads may already use the property
+    std::atomic<FieldAccessor::Reader> reader = nullptr;
+    std::atomic<FieldAccessor::Writer> writer = nullptr;
+
+    // Dynamic value slot, see MetaObject::dynamicSlot()
+    int slot = -1;
+
     bool isReadable() const {
         if (propertyType == MetaProperty::DynamicProperty) return true;
         return (metaProperty.isValid() && metaProperty.isReadable())
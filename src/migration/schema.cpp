@@ -22,6 +22,7 @@ void Schema::create(const QString &tableName, const std::function<void (TableBlu
 
     const QString statement = QueryBuilder::createTableStatement(tableName, blueprint, connection());
     exec(statement);
+    connection().invalidateSchema(tableName);
 }
 
 void Schema::table(const QString &tableName, const std::function<void (TableBlueprint &)> &callback)
@@ -31,18 +32,21 @@ void Schema::table(const QString &tableName, const std::function<void (TableBlue
 
     const QString statement = QueryBuilder::alterTableStatement(tableName, blueprint, connection());
     exec(statement);
+    connection().invalidateSchema(tableName);
 }
 
 void Schema::drop(const QString &tableName)
 {
     const QString statement = "DROP TABLE " + QueryBuilder::escapeTableName(tableName, connection());
     exec(statement);
+    connection().invalidateSchema(tableName);
 }
 
 void Schema::dropIfExists(const QString &tableName)
 {
     const QString statement = "DROP TABLE IF EXISTS " + QueryBuilder::escapeTableName(tableName, connection());
     exec(statement);
+    connection().invalidateSchema(tableName);
 }
 
 QString Schema::connectionName()
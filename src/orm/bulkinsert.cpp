@@ -0,0 +1,366 @@
+#include "bulkinsert.h"
+
+#include <QEloquent/metaobject.h>
+#include <QEloquent/metaproperty.h>
+#include <QEloquent/connection.h>
+#include <QEloquent/driver.h>
+#include <QEloquent/datamap.h>
+#include <QEloquent/query.h>
+#include <QEloquent/querybuilder.h>
+#include <QEloquent/queryrunner.h>
+#include <QEloquent/tracer.h>
+
+#include <QElapsedTimer>
+#include <QDateTime>
+#include <QSqlQuery>
+#include <QSqlError>
+
+namespace QEloquent {
+
+class BulkInsertPrivate
+{
+public:
+    bool flush();
+    bool insert(qsizetype first, qsizetype count);
+    void insertRows(qsizetype first, qsizetype count, bool savepoint);
+    bool exec(const QString &statement);
+    void rollbackSavepoint();
+    bool commit();
+    void fail(qint64 record, const QString &message);
+
+    MetaObject metaObject;
+    Connection connection;
+    Query query;
+    BulkInsertOptions options;
+
+    QList<DataMap> rows;
+    QList<qint64> records;
+    QStringList fields;
+
+    QDateTime now;
+    QString creationField;
+    QString updateField;
+
+    bool inTransaction = false;
+    bool callerTransaction = false; // Opened by the caller, never committed nor rolled back here
+    qint64 transactionRows = 0;
+    qint64 transactionInserted = 0;
+    bool fatal = false;
+
+    // Driver capabilities
+    qint64 maxStatementLength = 0;
+    bool savepoints = false;
+
+    ImportReport report;
+    QElapsedTimer timer;
+};
+
+void BulkInsertPrivate::fail(qint64 record, const QString &message)
+{
+    ++report.rowsFailed;
+    report.errors.append({ record, message });
+}
+
+// Inserts buffered rows with a single statement, falling back to row by row inserts to isolate failures.
+// A failure no savepoint protects may have aborted the transaction (PostgreSQL does), it is then rolled back
+// and the rows retried outside of it. Without savepoints, transactions hold a single flush to lose nothing else.
+// Rows go into the transaction of the caller when there is one, only savepoints isolating failures.
+bool BulkInsertPrivate::flush()
+{
+    if (rows.isEmpty())
+        return true;
+
+    TraceSpan span("BulkInsert::flush", "query");
+
+    if (!inTransaction)
+        callerTransaction = connection.isInTransaction();
+
+    if (options.transactionSize > 0 && !inTransaction && !callerTransaction) {
+        if (!connection.beginTransaction()) {
+            fatal = true;
+            report.errors.append({ -1, "Unable to start transaction: " + connection.database().lastError().text() });
+            return false;
+        }
+        inTransaction = true;
+    }
+
+    const qint64 insertedBefore = report.rowsInserted;
+    if (!insert(0, rows.size())) {
+        inTransaction = false;
+        connection.rollbackTransaction();
+
+        report.rowsInserted = insertedBefore - transactionInserted;
+        if (transactionInserted > 0) {
+            report.rowsFailed += transactionInserted;
+            report.errors.append({ -1, QStringLiteral("%1 rows rolled back with the aborted transaction").arg(transactionInserted) });
+        }
+
+        insertRows(0, rows.size(), false);
+        transactionRows = 0;
+        transactionInserted = 0;
+    } else if (inTransaction) {
+        transactionRows += rows.size();
+        transactionInserted += report.rowsInserted - insertedBefore;
+    }
+
+    rows.clear();
+    records.clear();
+    fields.clear();
+
+    if (inTransaction && (!savepoints || transactionRows >= options.transactionSize))
+        return commit();
+    return true;
+}
+
+// Inserts a range of buffered rows, batches too long for the driver being split in halves.
+// Returns false, without retrying, when a statement failed inside a transaction no savepoint protects.
+bool BulkInsertPrivate::insert(qsizetype first, qsizetype count)
+{
+    const QString statement = QueryBuilder::insertStatement(rows.mid(first, count), query);
+    if (count > 1 && maxStatementLength > 0 && statement.size() * 3 > maxStatementLength && statement.toUtf8().size() > maxStatementLength) {
+        const qsizetype half = count / 2;
+        return insert(first, half) && insert(first + half, count - half);
+    }
+
+    // Some backends abort the whole transaction on error, savepoints keep previous rows
+    const bool savepoint = (inTransaction || callerTransaction) && savepoints && exec("SAVEPOINT qeloquent_bulk");
+
+    if (QueryRunner::exec(statement, connection)) {
+        report.rowsInserted += count;
+        if (savepoint)
+            exec("RELEASE SAVEPOINT qeloquent_bulk");
+        return true;
+    }
+
+    if (inTransaction && !savepoint)
+        return false;
+
+    if (savepoint)
+        rollbackSavepoint();
+
+    insertRows(first, count, savepoint);
+    return true;
+}
+
+// Retries rows one by one, each in its own savepoint when \a savepoint is true
+void BulkInsertPrivate::insertRows(qsizetype first, qsizetype count, bool savepoint)
+{
+    for (qsizetype i(first); i < first + count; ++i) {
+        const bool rowSavepoint = savepoint && exec("SAVEPOINT qeloquent_bulk");
+
+        auto result = QueryRunner::exec(QueryBuilder::insertStatement(rows.at(i), query), connection);
+        if (result) {
+            ++report.rowsInserted;
+            if (rowSavepoint)
+                exec("RELEASE SAVEPOINT qeloquent_bulk");
+        } else {
+            fail(records.at(i), result.error().text());
+            if (rowSavepoint)
+                rollbackSavepoint();
+        }
+    }
+}
+
+bool BulkInsertPrivate::exec(const QString &statement)
+{
+    return QueryRunner::exec(statement, connection).has_value();
+}
+
+void BulkInsertPrivate::rollbackSavepoint()
+{
+    exec("ROLLBACK TO SAVEPOINT qeloquent_bulk");
+    exec("RELEASE SAVEPOINT qeloquent_bulk");
+}
+
+bool BulkInsertPrivate::commit()
+{
+    transactionRows = 0;
+    transactionInserted = 0;
+    if (!inTransaction)
+        return true;
+
+    inTransaction = false;
+    if (connection.commitTransaction())
+        return true;
+
+    fatal = true;
+    report.errors.append({ -1, "Unable to commit transaction: " + connection.database().lastError().text() });
+    connection.rollbackTransaction();
+    return false;
+}
+
+/*!
+ * @class QEloquent::BulkInsert
+ * @brief Inserts rows into the table of a model using multi-row INSERT statements, grouped in transactions.
+ *
+ * Rows are DataMap keyed by field names. When a statement fails, its rows are retried one by one
+ * and only the failing ones are reported, inside savepoints when the driver supports them. Otherwise
+ * transactions hold a single batch, rolled back before its rows are retried outside of any transaction.
+ * When the connection is already in a transaction, rows are inserted in it and left for the caller to commit.
+ * Batches are sized according to the driver capabilities, see Driver::maxStatementLength().
+ * @code
+ * BulkInsert insert(MetaObject::from<Product>());
+ * for (const DataMap &row : rows)
+ *     insert.add(row);
+ * insert.finish();
+ * qDebug() << insert.report().rowsPerSecond();
+ * @endcode
+ */
+
+BulkInsert::BulkInsert(const MetaObject &metaObject, const BulkInsertOptions &options)
+    : d(new BulkInsertPrivate())
+{
+    d->metaObject = metaObject;
+    d->connection = metaObject.connection();
+    d->query.table(metaObject.tableName()).connection(metaObject.connectionName());
+    d->options = options;
+    d->options.batchSize = qMax(1, options.batchSize);
+
+    if (const Driver *driver = d->connection.driver()) {
+        if (!driver->supportsMultiRowValues())
+            d->options.batchSize = 1;
+        d->maxStatementLength = driver->maxStatementLength();
+        d->savepoints = driver->supportsSavepoints();
+    }
+
+    if (options.timestamps) {
+        if (metaObject.hasCreationTimestamp())
+            d->creationField = metaObject.creationTimestamp().fieldName();
+        if (metaObject.hasUpdateTimestamp())
+            d->updateField = metaObject.updateTimestamp().fieldName();
+    }
+
+    d->timer.start();
+}
+
+/*!
+ * @brief Pending rows are inserted and the transaction committed if finish() was not called.
+ */
+BulkInsert::~BulkInsert()
+{
+    finish();
+}
+
+/*!
+ * @brief Buffers \a row, \a record identifies it in error reports. Returns false on fatal (transaction) errors.
+ */
+bool BulkInsert::add(const DataMap &row, qint64 record)
+{
+    if (d->fatal)
+        return false;
+
+    ++d->report.rowsRead;
+
+    DataMap values = row;
+    if (!d->creationField.isEmpty() || !d->updateField.isEmpty()) {
+        if (!d->now.isValid())
+            d->now = d->connection.now();
+
+        if (!d->creationField.isEmpty() && values.value(d->creationField).isNull())
+            values.insert(d->creationField, d->now);
+        if (!d->updateField.isEmpty() && values.value(d->updateField).isNull())
+            values.insert(d->updateField, d->now);
+    }
+
+    // A statement holds rows sharing the same fields
+    const QStringList fields = values.keys();
+    if (!d->rows.isEmpty() && fields != d->fields && !d->flush())
+        return false;
+
+    if (d->rows.isEmpty())
+        d->fields = fields;
+
+    d->rows.append(values);
+    d->records.append(record);
+
+    if (d->rows.size() >= d->options.batchSize)
+        return d->flush();
+    return true;
+}
+
+/*!
+ * @brief Reports a row rejected before insertion, parsing errors for example.
+ */
+void BulkInsert::addError(qint64 record, const QString &message)
+{
+    ++d->report.rowsRead;
+    d->fail(record, message);
+}
+
+/*!
+ * @brief Inserts pending rows and commits the current transaction, unless it was opened by the caller.
+ */
+bool BulkInsert::finish()
+{
+    if (d->fatal)
+        return false;
+
+    const bool flushed = d->flush();
+    return d->commit() && flushed;
+}
+
+ImportReport BulkInsert::report() const
+{
+    ImportReport report = d->report;
+    report.elapsedNs = d->timer.nsecsElapsed();
+    return report;
+}
+
+/*!
+ * @brief Returns the insertable properties of \a metaObject by field name.
+ */
+QHash<QString, MetaProperty> BulkInsert::fieldPlan(const MetaObject &metaObject)
+{
+    const QList<MetaProperty> insertable = defaultColumns(metaObject);
+
+    QHash<QString, MetaProperty> plan;
+    plan.reserve(insertable.size());
+    for (const MetaProperty &property : insertable)
+        plan.insert(property.fieldName(), property);
+    return plan;
+}
+
+/*!
+ * @brief Maps \a fieldNames to the insertable properties of \a metaObject, unknown fields giving invalid properties.
+ */
+QList<MetaProperty> BulkInsert::columnMapping(const MetaObject &metaObject, const QStringList &fieldNames)
+{
+    const QHash<QString, MetaProperty> properties = fieldPlan(metaObject);
+
+    QList<MetaProperty> columns;
+    columns.reserve(fieldNames.size());
+    for (const QString &fieldName : fieldNames)
+        columns.append(properties.value(fieldName.trimmed()));
+    return columns;
+}
+
+/*!
+ * @brief Returns the properties which can be inserted: primary key, fillable and timestamps.
+ */
+QList<MetaProperty> BulkInsert::defaultColumns(const MetaObject &metaObject)
+{
+    return metaObject.properties(
+        MetaProperty::PrimaryProperty | MetaProperty::FillableProperty |
+        MetaProperty::CreationTimestamp | MetaProperty::UpdateTimestamp | MetaProperty::DeletionTimestamp,
+        MetaObject::StandardProperties | MetaObject::DynamicProperties);
+}
+
+/*!
+ * @brief Converts \a value to the type of \a property, empty values become NULL except for strings.
+ */
+bool BulkInsert::convertValue(const MetaProperty &property, QVariant *value)
+{
+    const QMetaType type = property.metaType();
+
+    if (value->isNull() || (value->metaType().id() == QMetaType::QString && value->toString().isEmpty())) {
+        *value = (type.id() == QMetaType::QString ? QVariant(QString()) : QVariant());
+        return true;
+    }
+
+    if (!type.isValid() || value->metaType() == type)
+        return true;
+
+    return value->convert(type);
+}
+
+} // namespace QEloquent
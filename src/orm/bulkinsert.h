@@ -0,0 +1,72 @@
+#ifndef QELOQUENT_BULKINSERT_H
+#define QELOQUENT_BULKINSERT_H
+
+#include <QEloquent/global.h>
+
+#include <QScopedPointer>
+#include <QHash>
+
+namespace QEloquent {
+
+class MetaObject;
+class MetaProperty;
+class DataMap;
+
+struct BulkInsertOptions
+{
+    int batchSize = 500;          // Rows per INSERT statement
+    int transactionSize = 10000;  // Rows per transaction, 0 disables transactions
+    bool timestamps = true;       // Fills creation and update timestamps when missing
+};
+
+struct ImportError
+{
+    qint64 record = -1;
+    QString message;
+};
+
+/*!
+ * @brief Outcome of a bulk insert or import, failed rows don't abort the whole operation.
+ */
+struct ImportReport
+{
+    qint64 rowsRead = 0;
+    qint64 rowsInserted = 0;
+    qint64 rowsFailed = 0;
+    qint64 elapsedNs = 0;
+    QList<ImportError> errors;
+
+    bool hasErrors() const
+    { return rowsFailed > 0; }
+
+    double rowsPerSecond() const
+    { return (elapsedNs > 0 ? rowsInserted * 1e9 / elapsedNs : 0.0); }
+};
+
+class BulkInsertPrivate;
+class QELOQUENT_EXPORT BulkInsert
+{
+public:
+    explicit BulkInsert(const MetaObject &metaObject, const BulkInsertOptions &options = BulkInsertOptions());
+    ~BulkInsert();
+
+    bool add(const DataMap &row, qint64 record = -1);
+    void addError(qint64 record, const QString &message);
+    bool finish();
+
+    ImportReport report() const;
+
+    static QHash<QString, MetaProperty> fieldPlan(const MetaObject &metaObject);
+    static QList<MetaProperty> columnMapping(const MetaObject &metaObject, const QStringList &fieldNames);
+    static QList<MetaProperty> defaultColumns(const MetaObject &metaObject);
+    static bool convertValue(const MetaProperty &property, QVariant *value);
+
+private:
+    Q_DISABLE_COPY(BulkInsert)
+
+    QScopedPointer<BulkInsertPrivate> d;
+};
+
+} // namespace QEloquent
+
+#endif // QELOQUENT_BULKINSERT_H
@@ -3,6 +3,9 @@
 
 #include <QEloquent/metaproperty.h>
 #include <QEloquent/querybuilder.h>
+#include <QEloquent/tracer.h>
+#include <QEloquent/queryscope.h>
+#include <QEloquent/jsonwriter.h>
 
 #include <QVariant>
 #include <QDateTime>
@@ -28,6 +31,12 @@ Model::Model(const QMetaObject &metaObject)
     data->metaObject = MetaObject::fromQtMetaObject(metaObject);
 }
 
+Model::Model(const MetaObject &metaObject)
+    : data(new ModelData())
+{
+    data->metaObject = metaObject;
+}
+
 Model::Model(ModelData *data)
     : data(data)
 {}
@@ -95,7 +104,7 @@ QVariant Model::property(const QString &name) const
 {
     MODEL_DATA(const Model);
     const MetaProperty property = data.metaObject.property(name, MetaObject::ResolveByPropertyName);
-    return (property.isValid() ? property.read(this) : data.dynamicProperties.value(name));
+    return (property.isValid() ? property.read(this) : data.dynamicValue(data.metaObject.dynamicSlot(name)));
 }
 
 /*!
@@ -107,10 +116,10 @@ void Model::setProperty(const QString &name, const QVariant &value)
     const MetaProperty property = data.metaObject.property(name);
     if (property.isValid())
         property.write(this, value);
-    else if (value.isNull() && data.dynamicProperties.contains(name))
-        data.dynamicProperties.remove(name);
+    else if (value.isNull())
+        data.setDynamicValue(data.metaObject.dynamicSlot(name), QVariant());
     else
-        data.dynamicProperties.insert(name, value);
+        data.setDynamicValue(data.metaObject.dynamicSlot(name, true), value);
 }
 
 QVariant Model::label() const
@@ -128,8 +137,7 @@ QVariant Model::field(const QString &name) const
     if (property.isValid()) return property.read(this);
 
     // Fallback to dynamic properties
-    const QString prop = data.metaObject.namingConvention()->propertyName(name, data.metaObject.tableName());
-    return data.dynamicProperties.value(prop);
+    return data.dynamicValue(data.metaObject.dynamicFieldSlot(name));
 }
 
 void Model::setField(const QString &name, const QVariant &value)
@@ -142,8 +150,7 @@ void Model::setField(const QString &name, const QVariant &value)
     }
 
     // Fallback to dynamic properties
-    const QString prop = data.metaObject.namingConvention()->propertyName(name, data.metaObject.tableName());
-    data.dynamicProperties.insert(prop, value);
+    data.setDynamicValue(data.metaObject.dynamicFieldSlot(name, true), value);
 }
 
 /*!
@@ -179,7 +186,17 @@ bool Model::get()
 
     if (result) {
         if (result->next()) {
-            fill(result->record());
+            {
+                TraceSpan span("Model::fill", "hydration");
+                if (span.isActive())
+                    span.setDetail(data.metaObject.className());
+
+                const QList<MetaProperty> mapping = data.metaObject.recordMapping(result->record());
+                data.metaObject.write(this, *result, mapping);
+            }
+
+            // The "with" relations are eager loads, not reported by QueryScope
+            QueryScope::EagerLoading eager;
             load(data.metaObject.relations());
             return true;
         } else {
@@ -269,6 +286,8 @@ bool Model::load(const QString &relation)
 bool Model::load(const QStringList &relations)
 {
     for (const QString &relation : relations) {
+        const bool existed = data->relationData.contains(relation);
+
         const MetaProperty property = data->metaObject.property(relation);
         if (property.isValid()) {
             property.read(this); // We just read to init the relation
@@ -279,7 +298,12 @@ bool Model::load(const QStringList &relations)
 
         auto r = data->relationData.value(relation);
         r->parent = this; // We make sure that the relation is linked to 'this' instance
-        if (!r->get()) return false;
+
+        // A relation created by the read above has just been loaded
+        if (!existed && r->isLoaded)
+            continue;
+
+        if (!r->load()) return false;
     }
 
     return true;
@@ -343,19 +367,46 @@ bool Model::isListSerializable() const
 
 QList<DataMap> Model::serialize() const
 {
-    QList<MetaProperty> properties = data->metaObject.properties(
+    // Hidden properties are excluded
+    const QList<MetaProperty> properties = data->metaObject.properties(
         MetaProperty::PrimaryProperty | MetaProperty::LabelProperty | MetaProperty::FillableProperty |
         MetaProperty::CreationTimestamp | MetaProperty::UpdateTimestamp | MetaProperty::DeletionTimestamp,
-        MetaObject::AllProperties);
-
-    // We remove hidden properties
-    properties.removeIf([](const MetaProperty &property) {
-        return property.hasAttribute(MetaProperty::HiddenProperty);
-    });
+        MetaObject::AllProperties, MetaProperty::HiddenProperty);
 
     return { data->metaObject.read(this, properties, MetaObject::ResolveByFieldName) };
 }
 
+/*!
+ * \brief Streams the same fields as serialize() to \a writer, without intermediate maps.
+ */
+void Model::writeJson(JsonWriter &writer) const
+{
+    const QList<MetaProperty> properties = data->metaObject.properties(
+        MetaProperty::PrimaryProperty | MetaProperty::LabelProperty | MetaProperty::FillableProperty |
+        MetaProperty::CreationTimestamp | MetaProperty::UpdateTimestamp | MetaProperty::DeletionTimestamp,
+        MetaObject::AllProperties, MetaProperty::HiddenProperty);
+
+    writer.beginObject();
+
+    for (const MetaProperty &property : properties) {
+        if (property.propertyType() != MetaProperty::RelationProperty) {
+            writer.writeKey(property.fieldName());
+            writer.writeValue(property.read(this));
+            continue;
+        }
+
+        property.read(this); // We trigger lazy load
+        auto relation = data->relationData.value(property.propertyName());
+        if (!relation)
+            continue;
+
+        writer.writeKey(property.fieldName());
+        relation->writeJson(writer);
+    }
+
+    writer.endObject();
+}
+
 void Model::deserialize(const QList<DataMap> &data, bool all)
 {
     if (data.isEmpty()) return;
@@ -385,7 +436,7 @@ DataMap Model::fullDataMap() const
         MetaObject::StandardProperties | MetaObject::AppendedProperties | MetaObject::RelationProperties,
         MetaObject::ResolveByFieldName);
 
-    map.insert(data->dynamicProperties);
+    map.insert(data->dynamicProperties());
     return map;
 }
 
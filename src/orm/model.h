@@ -67,6 +67,7 @@ public:
     QString serializationContext() const override final;
     bool isListSerializable() const override final;
     QList<DataMap> serialize() const override final;
+    void writeJson(JsonWriter &writer) const override final;
     void deserialize(const QList<DataMap> &data, bool all = false) override final;
 
     DataMap fullDataMap() const;
@@ -74,36 +75,43 @@ public:
 protected:
     template<typename T, std::enable_if<std::is_base_of<Model, T>::value>::type* = nullptr> Model(T *self);
     Model(const QMetaObject &metaObject);
+    Model(const MetaObject &metaObject);
     Model(ModelData *data);
 
     template<typename T>
     Relation<T> hasOne(const QString &foreignKey = QString(), const QString &localKey = QString(),
-                       const std::source_location &location = std::source_location::current()) const;
+                       const std::source_location &location = std::source_location::current(),
+                       const std::source_location &callSite = std::source_location::current()) const;
 
     template<typename T>
     Relation<T> hasMany(const QString &foreignKey = QString(), const QString &localKey = QString(),
-                        const std::source_location &location = std::source_location::current()) const;
+                        const std::source_location &location = std::source_location::current(),
+                        const std::source_location &callSite = std::source_location::current()) const;
 
     template<typename T, typename Through>
     Relation<T> hasManyThrough(const QString &foreignKey = QString(), const QString &localKey = QString(),
                                const QString &throughForeignKey = QString(), const QString &throughLocalKey = QString(),
-                               const std::source_location &location = std::source_location::current()) const;
+                               const std::source_location &location = std::source_location::current(),
+                               const std::source_location &callSite = std::source_location::current()) const;
 
     template<typename T>
     Relation<T> belongsTo(const QString &foreignKey = QString(), const QString &ownerKey = QString(),
-                          const std::source_location &location = std::source_location::current()) const;
+                          const std::source_location &location = std::source_location::current(),
+                          const std::source_location &callSite = std::source_location::current()) const;
 
     template<typename T>
     Relation<T> belongsToMany(const QString &table = QString(), const QString &foreignPivotKey = QString(),
                               const QString &relatedPivotKey = QString(), const QString &parentKey = QString(),
                               const QString &relatedKey = QString(),
-                              const std::source_location &location = std::source_location::current()) const;
+                              const std::source_location &location = std::source_location::current(),
+                              const std::source_location &callSite = std::source_location::current()) const;
 
     template<typename T, typename Through>
     Relation<T> belongsToManyThrough(const QString &table = QString(), const QString &foreignPivotKey = QString(),
                                      const QString &relatedPivotKey = QString(), const QString &parentKey = QString(),
                                      const QString &relatedKey = QString(),
-                                     const std::source_location &location = std::source_location::current()) const;
+                                     const std::source_location &location = std::source_location::current(),
+                                     const std::source_location &callSite = std::source_location::current()) const;
 
     QSharedDataPointer<ModelData> data;
 
@@ -123,7 +131,7 @@ private:
 namespace QEloquent {
 
 template<typename T, std::enable_if<std::is_base_of<Model, T>::value>::type*>
-inline Model::Model(T *) : Model(T::staticMetaObject) {}
+inline Model::Model(T *) : Model(MetaObject::from<T>()) {}
 
 /*!
  * \fn QEloquent::Model::hasOne
@@ -131,12 +139,14 @@ inline Model::Model(T *) : Model(T::staticMetaObject) {}
  * \param foreignKey The foreign key of the related model.
  * \param localKey The local key of the parent model.
  * \param location The source location, used to compute the function name to name relation.
+ * \param callSite Where the relation is accessed from, reported by QueryScope. Getters can forward their caller's location.
  * \return A Relation object.
  */
 template<typename T>
-inline Relation<T> Model::hasOne(const QString &foreignKey, const QString &localKey, const std::source_location &location) const
+inline Relation<T> Model::hasOne(const QString &foreignKey, const QString &localKey, const std::source_location &location,
+                                 const std::source_location &callSite) const
 {
-    return Relation<T>(location, this, [=]() {
+    return Relation<T>(location, callSite, this, [=]() {
         auto d = new HasOneRelationData<T>();
         d->foreignKey = foreignKey;
         d->localKey = localKey;
@@ -150,12 +160,14 @@ inline Relation<T> Model::hasOne(const QString &foreignKey, const QString &local
  * \param foreignKey The foreign key of the related model.
  * \param localKey The local key of the parent model.
  * \param location The source location, used to compute the function name to name relation.
+ * \param callSite Where the relation is accessed from, reported by QueryScope. Getters can forward their caller's location.
  * \return A Relation object.
  */
 template<typename T>
-inline Relation<T> Model::hasMany(const QString &foreignKey, const QString &localKey, const std::source_location &location) const
+inline Relation<T> Model::hasMany(const QString &foreignKey, const QString &localKey, const std::source_location &location,
+                                  const std::source_location &callSite) const
 {
-    return Relation<T>(location, this, [=]() {
+    return Relation<T>(location, callSite, this, [=]() {
         auto d = new HasManyRelationData<T>();
         d->foreignKey = foreignKey;
         d->localKey = localKey;
@@ -170,13 +182,15 @@ inline Relation<T> Model::hasMany(const QString &foreignKey, const QString &loca
  * \param localKey The local key of the parent model.
  * \param throughForeignKey The foreignKey referenced on the through table
  * \param location The source location, used to compute the function name to name relation.
+ * \param callSite Where the relation is accessed from, reported by QueryScope. Getters can forward their caller's location.
  * \return A Relation object.
  */
 template<typename T, typename Through>
 inline Relation<T> Model::hasManyThrough(const QString &foreignKey, const QString &localKey,
-                                         const QString &throughForeignKey, const QString &throughLocalKey, const std::source_location &location) const
+                                         const QString &throughForeignKey, const QString &throughLocalKey, const std::source_location &location,
+                                         const std::source_location &callSite) const
 {
-    return Relation<T>(location, this, [=]() {
+    return Relation<T>(location, callSite, this, [=]() {
         auto d = new HasManyThroughRelationData<T, Through>();
         d->foreignKey = foreignKey;
         d->localKey = localKey;
@@ -192,12 +206,14 @@ inline Relation<T> Model::hasManyThrough(const QString &foreignKey, const QStrin
  * \param foreignKey The foreign key of the current model.
  * \param ownerKey The owner key of the related model.
  * \param location The source location, used to compute the function name to name relation.
+ * \param callSite Where the relation is accessed from, reported by QueryScope. Getters can forward their caller's location.
  * \return A Relation object.
  */
 template<typename T>
-inline Relation<T> Model::belongsTo(const QString &foreignKey, const QString &ownerKey, const std::source_location &location) const
+inline Relation<T> Model::belongsTo(const QString &foreignKey, const QString &ownerKey, const std::source_location &location,
+                                    const std::source_location &callSite) const
 {
-    return Relation<T>(location, this, [=]() {
+    return Relation<T>(location, callSite, this, [=]() {
         auto d = new BelongsToRelationData<T>();
         d->foreignKey = foreignKey;
         d->ownerKey = ownerKey;
@@ -212,14 +228,16 @@ inline Relation<T> Model::belongsTo(const QString &foreignKey, const QString &ow
  * \param foreignPivotKey The foreign key of the current model in the pivot table.
  * \param relatedPivotKey The foreign key of the related model in the pivot table.
  * \param location The source location, used to compute the function name to name relation.
+ * \param callSite Where the relation is accessed from, reported by QueryScope. Getters can forward their caller's location.
  * \return A Relation object.
  */
 template<typename T>
 inline Relation<T> Model::belongsToMany(const QString &table, const QString &foreignPivotKey,
                                         const QString &relatedPivotKey, const QString &parentKey,
-                                        const QString &relatedKey, const std::source_location &location) const
+                                        const QString &relatedKey, const std::source_location &location,
+                                        const std::source_location &callSite) const
 {
-    return Relation<T>(location, this, [=]() {
+    return Relation<T>(location, callSite, this, [=]() {
         auto d = new BelongsToManyRelationData<T>();
         d->table = table;
         d->foreignPivotKey = foreignPivotKey;
@@ -237,14 +255,16 @@ inline Relation<T> Model::belongsToMany(const QString &table, const QString &for
  * \param foreignPivotKey The foreign key of the intermediate model in the pivot table.
  * \param relatedPivotKey The foreign key of the related model in the pivot table.
  * \param location The source location, used to compute the function name to name relation.
+ * \param callSite Where the relation is accessed from, reported by QueryScope. Getters can forward their caller's location.
  * \return A Relation object.
  */
 template<typename T, typename Through>
 inline Relation<T> Model::belongsToManyThrough(const QString &table, const QString &foreignPivotKey,
                                                const QString &relatedPivotKey, const QString &parentKey,
-                                               const QString &relatedKey, const std::source_location &location) const
+                                               const QString &relatedKey, const std::source_location &location,
+                                               const std::source_location &callSite) const
 {
-    return Relation<T>(location, this, [=]() {
+    return Relation<T>(location, callSite, this, [=]() {
         auto d = new BelongsToManyThroughRelationData<T, Through>();
         d->table = table;
         d->foreignPivotKey = foreignPivotKey;
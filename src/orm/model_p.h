@@ -19,7 +19,34 @@ namespace QEloquent {
 class ModelData : public QSharedData
 {
 public:
-    DataMap dynamicProperties;
+    QVariant dynamicValue(int slot) const
+    { return dynamicValues.value(slot); }
+
+    void setDynamicValue(int slot, const QVariant &value)
+    {
+        if (slot < 0)
+            return;
+
+        if (slot >= dynamicValues.size()) {
+            if (!value.isValid())
+                return;
+            dynamicValues.resize(slot + 1);
+        }
+
+        dynamicValues[slot] = value;
+    }
+
+    DataMap dynamicProperties() const
+    {
+        DataMap map;
+        for (int slot(0); slot < dynamicValues.size(); ++slot)
+            if (dynamicValues.at(slot).isValid())
+                map.insert(metaObject.dynamicSlotName(slot), dynamicValues.at(slot));
+        return map;
+    }
+
+    // Dynamic values by slot, names being held once by the meta object, see MetaObject::dynamicSlot()
+    QVariantList dynamicValues;
     QMap<QString, QExplicitlySharedDataPointer<RelationData>> relationData;
     MetaObject metaObject;
 
@@ -33,7 +60,16 @@ public:
             .table(metaObject.tableName())
             .connection(metaObject.connectionName());
 
-        auto result = QueryRunner::exec(statement, query.connection());
+        Result<::QSqlQuery, ::QSqlError> result;
+        if (QueryRunner::hasListeners()) {
+            QueryRecord record;
+            record.modelClass = metaObject.className();
+            result = QueryRunner::exec(statement, query.connection(), &record);
+            QueryRunner::notify(record);
+        } else {
+            result = QueryRunner::exec(statement, query.connection());
+        }
+
         lastQuery = query.raw(statement);
         if (!result)
             lastError = Error::fromSqlError(result.error());
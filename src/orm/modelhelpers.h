@@ -8,19 +8,41 @@
 #include <QEloquent/connection.h>
 #include <QEloquent/querybuilder.h>
 #include <QEloquent/queryrunner.h>
+#include <QEloquent/tracer.h>
+#include <QEloquent/queryscope.h>
+#include <QEloquent/jsonwriter.h>
+#include <QEloquent/csvwriter.h>
+#include <QEloquent/csvreader.h>
+#include <QEloquent/jsonarrayreader.h>
+#include <QEloquent/binarywriter.h>
+#include <QEloquent/binaryreader.h>
+#include <QEloquent/bulkinsert.h>
 
 #include <QSqlQuery>
 #include <QSqlRecord>
 #include <QJsonObject>
+#include <QElapsedTimer>
+#include <QIODevice>
+
+#include <algorithm>
+#include <functional>
 
 #define QELOQUENT_HELPERS(Class) \
 public: \
     using QEloquent::ModelHelpers<Class>::make; \
     using QEloquent::ModelHelpers<Class>::find; \
+    using QEloquent::ModelHelpers<Class>::each; \
     using QEloquent::ModelHelpers<Class>::paginate; \
     using QEloquent::ModelHelpers<Class>::all; \
+    using QEloquent::ModelHelpers<Class>::exportJson; \
+    using QEloquent::ModelHelpers<Class>::exportCsv; \
+    using QEloquent::ModelHelpers<Class>::exportBinary; \
+    using QEloquent::ModelHelpers<Class>::importBinary; \
+    using QEloquent::ModelHelpers<Class>::importCsv; \
+    using QEloquent::ModelHelpers<Class>::importJson; \
     using QEloquent::ModelHelpers<Class>::count; \
     using QEloquent::ModelHelpers<Class>::create; \
+    using QEloquent::ModelHelpers<Class>::updateAll; \
     using QEloquent::ModelHelpers<Class>::remove; \
     using QEloquent::ModelHelpers<Class>::query; \
     using QEloquent::ModelHelpers<Class>::fixQuery; \
@@ -38,7 +60,7 @@ public:
     /** @brief Creates a default model instance */
     static Model make() { return Model(); }
     /** @brief Returns the MetaObject for the model type */
-    static MetaObject metaObject() { return MetaObject::fromQtMetaObject(Model::staticMetaObject); }
+    static MetaObject metaObject() { return MetaObject::from<Model>(); }
 };
 
 /**
@@ -66,12 +88,29 @@ public:
     /** @brief Finds models matching the given query */
     static Result<QList<Model>, Error> find(Query query);
 
+    /** @brief Hydrates models matching the query one at a time, until \a callback returns false. Returns the number of models visited */
+    static Result<int, Error> each(Query query, const std::function<bool (Model &)> &callback, bool loadRelations = true);
+
     /** @brief Finds models matching the given query and limit output using pagination */
     static Result<QList<Model>, Error> paginate(int page = 1, int itemsPerPage = 20, Query query = Query());
 
     /** @brief Finds all models, optionaly matching the given query */
     static Result<QList<Model>, Error> all(Query query = Query());
 
+    /** @brief Streams models matching the query to \a device as a JSON array, returns the number of models written */
+    static Result<int, Error> exportJson(QIODevice *device, Query query = Query(), SerializationFormat format = SerializationFormat::Compact);
+    /** @brief Streams models matching the query to \a device as CSV, relations excluded. Returns the number of rows written */
+    static Result<int, Error> exportCsv(QIODevice *device, Query query = Query(), const CsvOptions &options = CsvOptions());
+    /** @brief Writes the stored fields of models matching the query to \a device, in the binary row format */
+    static Result<int, Error> exportBinary(QIODevice *device, Query query = Query());
+    /** @brief Reads models written by exportBinary(), without querying the database */
+    static Result<QList<Model>, Error> importBinary(QIODevice *device);
+    /** @brief Inserts CSV rows read from \a device using bulk inserts, rows failing are reported without aborting the import */
+    static Result<ImportReport, Error> importCsv(QIODevice *device, const CsvOptions &options = CsvOptions(),
+                                                 const BulkInsertOptions &insertOptions = BulkInsertOptions());
+    /** @brief Inserts the objects of a JSON array read from \a device one at a time, using bulk inserts */
+    static Result<ImportReport, Error> importJson(QIODevice *device, const BulkInsertOptions &insertOptions = BulkInsertOptions());
+
     /** @brief Returns the number of records matching the query */
     static Result<int, Error> count(Query query = Query());
 
@@ -80,6 +119,9 @@ public:
     /** @brief Creates and persists multiple models from JSON data */
     static Result<QList<Model>, Error> create(const QList<QJsonObject> &objects);
 
+    /** @brief Updates records matching the given query with a single statement, returns the number of rows affected */
+    static Result<int, Error> updateAll(Query query, const DataMap &data);
+
     /** @brief Deletes records matching the given query */
     static Result<int, Error> remove(Query query);
 
@@ -129,28 +171,105 @@ inline Result<Model, Error> ModelHelpers<Model, Maker>::find(const QVariant &pri
 
 template<typename Model, typename Maker>
 inline Result<QList<Model>, Error> ModelHelpers<Model, Maker>::find(Query query)
+{
+    QList<Model> models;
+
+    auto result = each(query, [&models](Model &model) {
+        models.append(model);
+        return true;
+    });
+
+    if (result)
+        return models;
+    else
+        return failWith(result.error());
+}
+
+template<typename Model, typename Maker>
+inline Result<int, Error> ModelHelpers<Model, Maker>::each(Query query, const std::function<bool (Model &)> &callback, bool loadRelations)
 {
     const MetaObject metaObject = Maker::metaObject();
     const QString statement = QueryBuilder::selectStatement(fixQuery(query, metaObject));
 
-    auto result = QueryRunner::exec(statement, query.connectionName());
+    // Instrumentation, record is only filled when someone listens
+    const bool instrumented = QueryRunner::hasListeners();
+    QueryRecord record;
+    record.modelClass = metaObject.className();
+    QElapsedTimer timer;
+
+    auto result = QueryRunner::exec(statement, query.connection(), (instrumented ? &record : nullptr));
     if (result) {
-        QList<Model> models;
+        int count = 0;
+
+        QStringList relations;
+        if (loadRelations) {
+            relations = metaObject.relations() + query.relations();
+            relations.removeDuplicates();
+        }
 
-        QStringList relations = metaObject.relations() + query.relations();
-        relations.removeDuplicates();
+        // Column to property mapping is computed once for the whole result set
+        MetaObject modelMetaObject;
+        QList<MetaProperty> mapping;
+
+        while (true) {
+            if (instrumented)
+                timer.start();
+
+            if (!result->next())
+                break;
 
-        while (result->next()) {
             Model m = Maker::make();
-            m.fill(result->record());
-            if (m.load(relations))
-                models.append(m);
-            else
-                return failWith(m.lastError());
+            {
+                // One span per row, the callback work isn't hydration, relations loads appear as children
+                TraceSpan span("Model::fill", "hydration");
+                if (span.isActive())
+                    span.setDetail(metaObject.className());
+
+                if (mapping.isEmpty()) {
+                    modelMetaObject = m.metaObject();
+                    mapping = modelMetaObject.recordMapping(result->record());
+                }
+
+                modelMetaObject.write(&m, *result, mapping);
+
+                // Relations loading is not part of the fetch, it is reported on its own
+                if (instrumented)
+                    record.fetchNs += timer.nsecsElapsed();
+
+                // Requested relations, not lazy loads from user code
+                bool loaded;
+                {
+                    QueryScope::EagerLoading eager;
+                    loaded = m.load(relations);
+                }
+
+                if (!loaded) {
+                    if (instrumented) {
+                        record.rowsReturned = count + 1;
+                        QueryRunner::notify(record);
+                    }
+                    return failWith(m.lastError());
+                }
+            }
+
+            ++count;
+            if (!callback(m)) {
+                if (instrumented)
+                    timer.start(); // Already accounted for
+                break;
+            }
         }
 
-        return models;
+        if (instrumented) {
+            record.fetchNs += timer.nsecsElapsed();
+            record.rowsReturned = count;
+            QueryRunner::notify(record);
+        }
+
+        return count;
     } else {
+        if (instrumented)
+            QueryRunner::notify(record);
         return failWith(Error::fromSqlError(result.error()));
     }
 }
@@ -167,14 +286,250 @@ inline Result<QList<Model>, Error> ModelHelpers<Model, Maker>::all(Query query)
     return find(query);
 }
 
+template<typename Model, typename Maker>
+inline Result<int, Error> ModelHelpers<Model, Maker>::exportJson(QIODevice *device, Query query, SerializationFormat format)
+{
+    JsonWriter writer(device, format);
+    writer.beginArray();
+
+    auto result = each(query, [&writer](Model &model) {
+        TraceSpan span("ModelHelpers::exportJson", "serialization");
+        if (span.isActive())
+            span.setDetail(model.metaObject().className());
+
+        model.writeJson(writer);
+        return !writer.hasError();
+    });
+
+    writer.endArray();
+
+    if (!writer.flush())
+        return failWith(Error(Error::IOError, "Unable to write JSON: " + device->errorString()));
+    return result;
+}
+
+template<typename Model, typename Maker>
+inline Result<int, Error> ModelHelpers<Model, Maker>::exportCsv(QIODevice *device, Query query, const CsvOptions &options)
+{
+    // Same fields as serialization, relations don't fit in a flat row
+    const QList<MetaProperty> properties = Maker::make().metaObject().properties(
+        MetaProperty::PrimaryProperty | MetaProperty::LabelProperty | MetaProperty::FillableProperty |
+        MetaProperty::CreationTimestamp | MetaProperty::UpdateTimestamp | MetaProperty::DeletionTimestamp,
+        MetaObject::StandardProperties | MetaObject::DynamicProperties | MetaObject::AppendedProperties,
+        MetaProperty::HiddenProperty);
+
+    CsvWriter writer(device, options);
+
+    if (options.header) {
+        for (const MetaProperty &property : properties)
+            writer.writeField(property.fieldName());
+        writer.endRow();
+    }
+
+    auto result = each(query, [&writer, &properties](Model &model) {
+        TraceSpan span("ModelHelpers::exportCsv", "serialization");
+        if (span.isActive())
+            span.setDetail(model.metaObject().className());
+
+        for (const MetaProperty &property : properties)
+            writer.writeField(property.read(&model));
+        writer.endRow();
+        return !writer.hasError();
+    }, false);
+
+    if (!writer.flush())
+        return failWith(Error(Error::IOError, "Unable to write CSV: " + device->errorString()));
+    return result;
+}
+
+template<typename Model, typename Maker>
+inline Result<int, Error> ModelHelpers<Model, Maker>::exportBinary(QIODevice *device, Query query)
+{
+    const MetaObject metaObject = Maker::make().metaObject();
+    const QList<MetaProperty> properties = BinaryWriter::defaultProperties(metaObject);
+
+    BinaryWriter writer(device);
+    writer.writeHeader(metaObject.tableName(), BinaryWriter::columns(properties));
+
+    QVariantList values;
+    values.reserve(properties.size());
+
+    auto result = each(query, [&writer, &properties, &values](Model &model) {
+        TraceSpan span("ModelHelpers::exportBinary", "serialization");
+        if (span.isActive())
+            span.setDetail(model.metaObject().className());
+
+        values.clear();
+        for (const MetaProperty &property : properties)
+            values.append(property.read(&model));
+        return writer.writeRow(values);
+    }, false);
+
+    if (!writer.finish() || writer.hasError())
+        return failWith(Error(Error::IOError, "Unable to write binary data: " + writer.errorString()));
+    return result;
+}
+
+template<typename Model, typename Maker>
+inline Result<QList<Model>, Error> ModelHelpers<Model, Maker>::importBinary(QIODevice *device)
+{
+    const MetaObject metaObject = Maker::make().metaObject();
+    const QList<MetaProperty> properties = BinaryWriter::defaultProperties(metaObject);
+
+    BinaryReader reader(device);
+    if (!reader.readHeader())
+        return failWith(Error(Error::IOError, reader.errorString()));
+
+    // Cached data written before a model change is rejected
+    if (reader.schemaTag() != BinaryWriter::schemaTag(metaObject.tableName(), BinaryWriter::columns(properties)))
+        return failWith(Error(Error::IOError, "Binary data doesn't match the layout of " + metaObject.className()));
+
+    QList<Model> models;
+    QVariantList values;
+
+    TraceSpan span("Model::fill", "hydration");
+    if (span.isActive())
+        span.setDetail(metaObject.className());
+
+    while (reader.readRow(&values)) {
+        Model model = Maker::make();
+        for (qsizetype i(0); i < properties.size(); ++i)
+            properties.at(i).write(&model, values.at(i));
+        models.append(model);
+    }
+
+    if (reader.hasError())
+        return failWith(Error(Error::IOError, reader.errorString()));
+    return models;
+}
+
+template<typename Model, typename Maker>
+inline Result<ImportReport, Error> ModelHelpers<Model, Maker>::importCsv(QIODevice *device, const CsvOptions &options, const BulkInsertOptions &insertOptions)
+{
+    const MetaObject metaObject = Maker::make().metaObject();
+    CsvReader reader(device, options);
+    QByteArrayList fields;
+
+    // Columns are mapped to properties once, using the header if any
+    QList<MetaProperty> columns;
+    if (options.header) {
+        if (!reader.readRow(&fields)) {
+            if (reader.hasError())
+                return failWith(Error(Error::IOError, reader.errorString()));
+            return ImportReport();
+        }
+
+        QStringList fieldNames;
+        for (const QByteArray &field : std::as_const(fields))
+            fieldNames.append(QString::fromUtf8(field));
+        columns = BulkInsert::columnMapping(metaObject, fieldNames);
+    } else {
+        columns = BulkInsert::defaultColumns(metaObject);
+    }
+
+    if (std::none_of(columns.begin(), columns.end(), [](const MetaProperty &property) { return property.isValid(); }))
+        return failWith(Error(Error::NotFoundError, "No CSV column matches a field of " + metaObject.tableName()));
+
+    BulkInsert insert(metaObject, insertOptions);
+
+    while (reader.readRow(&fields)) {
+        const qint64 record = reader.recordNumber();
+        if (fields.size() != columns.size()) {
+            insert.addError(record, QStringLiteral("Expected %1 fields, got %2").arg(columns.size()).arg(fields.size()));
+            continue;
+        }
+
+        DataMap row;
+        bool valid = true;
+        for (qsizetype i(0); i < columns.size(); ++i) {
+            const MetaProperty &property = columns.at(i);
+            if (!property.isValid())
+                continue;
+
+            QVariant value(QString::fromUtf8(fields.at(i)));
+            if (!BulkInsert::convertValue(property, &value)) {
+                insert.addError(record, "Invalid value for " + property.fieldName() + ": " + QString::fromUtf8(fields.at(i)));
+                valid = false;
+                break;
+            }
+            row.insert(property.fieldName(), value);
+        }
+
+        if (valid && !insert.add(row, record))
+            break;
+    }
+
+    if (reader.hasError())
+        insert.addError(reader.recordNumber() + 1, reader.errorString());
+
+    insert.finish();
+    return insert.report();
+}
+
+template<typename Model, typename Maker>
+inline Result<ImportReport, Error> ModelHelpers<Model, Maker>::importJson(QIODevice *device, const BulkInsertOptions &insertOptions)
+{
+    const MetaObject metaObject = Maker::make().metaObject();
+    const QHash<QString, MetaProperty> plan = BulkInsert::fieldPlan(metaObject);
+
+    JsonArrayReader reader(device);
+    QJsonObject object;
+
+    BulkInsert insert(metaObject, insertOptions);
+
+    while (reader.readObject(&object)) {
+        const qint64 record = reader.elementNumber();
+
+        DataMap row;
+        bool valid = true;
+        for (auto it = object.constBegin(); it != object.constEnd(); ++it) {
+            const auto property = plan.constFind(it.key());
+            if (property == plan.constEnd())
+                continue; // Unknown or not insertable
+
+            QVariant value = it.value().toVariant();
+            if (!BulkInsert::convertValue(property.value(), &value)) {
+                insert.addError(record, "Invalid value for " + it.key());
+                valid = false;
+                break;
+            }
+            row.insert(it.key(), value);
+        }
+
+        if (valid && !insert.add(row, record))
+            break;
+    }
+
+    if (reader.hasError()) {
+        if (reader.elementNumber() == 0)
+            return failWith(Error(Error::IOError, reader.errorString()));
+        insert.addError(reader.elementNumber(), reader.errorString());
+    }
+
+    insert.finish();
+    return insert.report();
+}
+
 template<typename Model, typename Maker>
 inline Result<int, Error> ModelHelpers<Model, Maker>::count(Query query)
 {
     const QString statement = QueryBuilder::selectStatement("COUNT(1)", fixQuery(query));
 
-    auto result = QueryRunner::exec(statement, query.connectionName());
+    // The single row is fetched here, hence reported here
+    const bool instrumented = QueryRunner::hasListeners();
+    QueryRecord record;
+    record.modelClass = Maker::metaObject().className();
+
+    auto result = QueryRunner::exec(statement, query.connection(), (instrumented ? &record : nullptr));
+    const bool fetched = (result && result->next());
+
+    if (instrumented) {
+        record.rowsReturned = (fetched ? 1 : 0);
+        QueryRunner::notify(record);
+    }
+
     if (result)
-        return (result->next() ? result->value(0).toInt() : 0);
+        return (fetched ? result->value(0).toInt() : 0);
     else
         return failWith(Error::fromSqlError(result.error()));
 }
@@ -206,6 +561,43 @@ inline Result<QList<Model>, Error> ModelHelpers<Model, Maker>::create(const QLis
     return models;
 }
 
+template<typename Model, typename Maker>
+inline Result<int, Error> ModelHelpers<Model, Maker>::updateAll(Query query, const DataMap &data)
+{
+    const MetaObject metaObject = Maker::metaObject();
+    fixQuery(query, metaObject);
+
+    if (data.isEmpty())
+        return failWith(Error(Error::DatabaseError, "No field to update on " + metaObject.tableName()));
+
+    DataMap values = data;
+    if (metaObject.hasUpdateTimestamp()) {
+        const QString field = metaObject.updateTimestamp().fieldName();
+        if (!values.contains(field))
+            values.insert(field, query.connection().now());
+    }
+
+    // Deleted records are left untouched, existing filters are grouped so OR conditions can't bypass the scope
+    if (metaObject.hasDeletionTimestamp()) {
+        Query scoped;
+        fixQuery(scoped, metaObject);
+
+        if (query.hasWhere())
+            scoped.where(query);
+
+        scoped.andWhere(metaObject.deletionTimestamp().fieldName(), "IS", QVariant());
+        query = scoped;
+    }
+
+    const QString statement = QueryBuilder::updateStatement(values, query);
+
+    auto result = QueryRunner::exec(statement, query.connectionName());
+    if (result)
+        return result->numRowsAffected();
+    else
+        return failWith(Error(Error::DatabaseError, QString(), result.error()));
+}
+
 template<typename Model, typename Maker>
 inline Result<int, Error> ModelHelpers<Model, Maker>::remove(Query query)
 {
@@ -0,0 +1,152 @@
+#include "queryscope.h"
+
+#include <QAbstractEventDispatcher>
+#include <QThread>
+#include <QHash>
+#include <QDebug>
+
+namespace QEloquent {
+
+class QueryScopePrivate
+{
+public:
+    int threshold;
+    QueryScope::Callback callback;
+    QHash<QString, int> counts;
+    QList<QueryScopeReport> reports;
+};
+
+// Innermost scope last, per thread
+static thread_local QList<QueryScope *> s_scopes;
+
+// Event loop scope of the current thread, reset each time the loop is about to block
+static thread_local QueryScope *s_eventLoopScope = nullptr;
+static thread_local QMetaObject::Connection s_eventLoopConnection;
+
+// Nesting depth of eager loads on the current thread
+static thread_local int s_eagerLoading = 0;
+
+/*!
+ * @class QEloquent::QueryScope
+ * @brief Detects relations lazily loaded more than a threshold number of times while the scope lives.
+ *
+ * Reports are emitted once per relation and call site, through the callback or qWarning() if none.
+ * @code
+ * QueryScope scope(10);
+ * for (Product &product : products)
+ *     qDebug() << product.category()->name; // Reported on the 11th load
+ * @endcode
+ */
+QueryScope::QueryScope(int threshold, const Callback &callback)
+    : d(new QueryScopePrivate())
+{
+    d->threshold = threshold;
+    d->callback = callback;
+    s_scopes.append(this);
+}
+
+QueryScope::~QueryScope()
+{
+    s_scopes.removeOne(this);
+}
+
+int QueryScope::threshold() const
+{
+    return d->threshold;
+}
+
+QList<QueryScopeReport> QueryScope::reports() const
+{
+    return d->reports;
+}
+
+/*!
+ * @brief Forgets load counts and reports, the event loop scope does it before each wait.
+ */
+void QueryScope::reset()
+{
+    d->counts.clear();
+    d->reports.clear();
+}
+
+QueryScope *QueryScope::current()
+{
+    return (s_scopes.isEmpty() ? nullptr : s_scopes.last());
+}
+
+/*!
+ * @brief Installs a scope on the current thread, covering each event loop iteration.
+ */
+void QueryScope::installEventLoopScope(int threshold, const Callback &callback)
+{
+    removeEventLoopScope();
+
+    QAbstractEventDispatcher *dispatcher = QAbstractEventDispatcher::instance(QThread::currentThread());
+    if (!dispatcher) {
+        qWarning() << "QueryScope: no event dispatcher on the current thread";
+        return;
+    }
+
+    // Scope must stay at the bottom of the stack, explicit scopes are nested inside
+    s_eventLoopScope = new QueryScope(threshold, callback);
+    s_scopes.removeOne(s_eventLoopScope);
+    s_scopes.prepend(s_eventLoopScope);
+
+    s_eventLoopConnection = QObject::connect(dispatcher, &QAbstractEventDispatcher::aboutToBlock, dispatcher, []() {
+        if (s_eventLoopScope)
+            s_eventLoopScope->reset();
+    });
+}
+
+void QueryScope::removeEventLoopScope()
+{
+    if (!s_eventLoopScope)
+        return;
+
+    QObject::disconnect(s_eventLoopConnection);
+    delete s_eventLoopScope;
+    s_eventLoopScope = nullptr;
+}
+
+void QueryScope::reportRelationLoad(const QString &modelClass, const QString &relation, const std::source_location &location)
+{
+    QueryScope *scope = current();
+    if (!scope || s_eagerLoading > 0)
+        return;
+
+    const QString key = modelClass + '.' + relation + '@' + location.file_name() + ':' + QString::number(location.line());
+    const int count = ++scope->d->counts[key];
+    if (count != scope->d->threshold + 1)
+        return;
+
+    QueryScopeReport report;
+    report.modelClass = modelClass;
+    report.relation = relation;
+    report.fileName = QString::fromUtf8(location.file_name());
+    report.line = int(location.line());
+    report.functionName = QString::fromUtf8(location.function_name());
+    report.count = count;
+    scope->d->reports.append(report);
+
+    if (scope->d->callback) {
+        scope->d->callback(report);
+        return;
+    }
+
+    qWarning().noquote().nospace()
+        << "QueryScope: relation " << modelClass << "::" << relation << " loaded more than "
+        << scope->d->threshold << " times in scope, consider eager loading it with with() ("
+        << report.fileName << ':' << report.line << ')';
+}
+
+QueryScope::EagerLoading::EagerLoading()
+{
+    ++s_eagerLoading;
+}
+
+QueryScope::EagerLoading::~EagerLoading()
+{
+    --s_eagerLoading;
+}
+
+} // namespace QEloquent
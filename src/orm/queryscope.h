@@ -0,0 +1,67 @@
+#ifndef QELOQUENT_QUERYSCOPE_H
+#define QELOQUENT_QUERYSCOPE_H
+
+#include <QEloquent/global.h>
+
+#include <QScopedPointer>
+
+#include <functional>
+#include <source_location>
+
+namespace QEloquent {
+
+/*!
+ * @brief Lazy relation loading repeated within a scope, likely an N+1 pattern.
+ */
+struct QueryScopeReport
+{
+    QString modelClass;
+    QString relation;
+    QString fileName;
+    int line = 0;
+    QString functionName;
+    int count = 0;
+};
+
+class QueryScopePrivate;
+class QELOQUENT_EXPORT QueryScope
+{
+public:
+    typedef std::function<void (const QueryScopeReport &report)> Callback;
+
+    explicit QueryScope(int threshold = 5, const Callback &callback = nullptr);
+    ~QueryScope();
+
+    int threshold() const;
+    QList<QueryScopeReport> reports() const;
+    void reset();
+
+    static QueryScope *current();
+
+    static void installEventLoopScope(int threshold = 5, const Callback &callback = nullptr);
+    static void removeEventLoopScope();
+
+    static void reportRelationLoad(const QString &modelClass, const QString &relation, const std::source_location &location);
+
+    /*!
+     * @brief Marks relation loads done while it lives as eager ones, they are not counted.
+     */
+    class QELOQUENT_EXPORT EagerLoading
+    {
+    public:
+        EagerLoading();
+        ~EagerLoading();
+
+    private:
+        Q_DISABLE_COPY(EagerLoading)
+    };
+
+private:
+    Q_DISABLE_COPY(QueryScope)
+
+    QScopedPointer<QueryScopePrivate> d;
+};
+
+} // namespace QEloquent
+
+#endif // QELOQUENT_QUERYSCOPE_H
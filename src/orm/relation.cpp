@@ -2,6 +2,8 @@
 
 #include <QEloquent/model.h>
 #include <QEloquent/private/model_p.h>
+#include <QEloquent/queryscope.h>
+#include <QEloquent/tracer.h>
 
 namespace QEloquent {
 
@@ -14,6 +16,22 @@ QString RelationData::serializationContext() const
     return parent->serializationContext() + '.' + name;
 }
 
+/*!
+ * @brief Fetches related models, reporting the load to the current QueryScope.
+ */
+bool RelationData::load()
+{
+    QueryScope::reportRelationLoad(primaryObject.className(), name, location);
+
+    TraceSpan span("RelationData::get", "relation");
+    if (span.isActive())
+        span.setDetail(primaryObject.className() + '.' + name);
+
+    const bool loaded = get();
+    isLoaded = true;
+    return loaded;
+}
+
 QExplicitlySharedDataPointer<RelationData> RelationData::create(const QString &name, const Model *parent, const std::function<RelationData *()> &creationCallback)
 {
     Model *pa = const_cast<Model *>(parent);
@@ -34,6 +52,15 @@ QExplicitlySharedDataPointer<RelationData> RelationData::create(const QString &n
 }
 
 QExplicitlySharedDataPointer<RelationData> RelationData::create(const std::source_location &location, const Model *parent, const std::function<RelationData *()> &creationCallback)
+{
+    return create(location, location, parent, creationCallback);
+}
+
+/*!
+ * @brief Creates the relation named after the function holding \a location, its loads being reported at \a callSite.
+ */
+QExplicitlySharedDataPointer<RelationData> RelationData::create(const std::source_location &location, const std::source_location &callSite,
+                                                                const Model *parent, const std::function<RelationData *()> &creationCallback)
 {
     QString name(location.function_name());
 
@@ -46,7 +73,9 @@ QExplicitlySharedDataPointer<RelationData> RelationData::create(const std::sourc
         name.remove(i, name.length() - i);
     }
 
-    return create(name, parent, creationCallback);
+    auto p = create(name, parent, creationCallback);
+    p->location = callSite;
+    return p;
 }
 
 QVariant RelationData::parentPrimary() const
@@ -45,16 +45,21 @@ public:
 
     virtual RelationData *clone() const = 0;
 
+    bool load();
+
     QString name;
     QMap<int, DataMap> pivotData;
     MetaObject primaryObject;
     MetaObject relatedObject;
     Model *parent = nullptr;
+    std::source_location location; // Where the relation is accessed from, see QueryScope
 
     bool isLoaded = false;
 
     static QExplicitlySharedDataPointer<RelationData> create(const QString &name, const Model *parent, const std::function<RelationData *()> &creationCallback);
     static QExplicitlySharedDataPointer<RelationData> create(const std::source_location &location, const Model *parent, const std::function<RelationData *()> &creationCallback);
+    static QExplicitlySharedDataPointer<RelationData> create(const std::source_location &location, const std::source_location &callSite,
+                                                             const Model *parent, const std::function<RelationData *()> &creationCallback);
 
 protected:
     QVariant parentPrimary() const;
@@ -98,6 +103,10 @@ public:
     /** @brief Constructor */
     Relation(const std::source_location &location, const ParentModel *parent, const std::function<RelationData *()> &creationCallback)
         : data(RelationData::create(location, parent, creationCallback)) { ensureLoaded(); }
+    /** @brief Constructor, loads being reported at \a callSite */
+    Relation(const std::source_location &location, const std::source_location &callSite, const ParentModel *parent,
+             const std::function<RelationData *()> &creationCallback)
+        : data(RelationData::create(location, callSite, parent, creationCallback)) { ensureLoaded(); }
     /** @brief Copy constructor */
     Relation(const Relation &other) = default;
     /** @brief Move constructor */
@@ -122,7 +131,7 @@ public:
     /** @brief Returns true if related models exist in the database (triggers load) */
     bool exists() override { ensureLoaded(); return data->exists(); }
     /** @brief Manually fetches related models from the database */
-    bool get() override { ensureLoaded(); return data->get(); }
+    bool get() override { return data->load(); }
     /** @brief Unsupported for relations directly */
     bool save() override { return data->save(); }
     /** @brief Unsupported for relations directly */
@@ -138,14 +147,13 @@ public:
     QString serializationContext() const override final { return data->serializationContext(); }
     bool isListSerializable() const override final { return data->multiple(); }
     QList<DataMap> serialize() const override final { return data->serialize(); }
+    void writeJson(JsonWriter &writer) const override final { data->writeJson(writer); }
 
 private:
     /** @brief Internal helper to trigger lazy loading if needed */
     void ensureLoaded() const {
-        if (!data->isLoaded) {
-            data->get();
-            data->isLoaded = true;
-        }
+        if (!data->isLoaded)
+            data->load();
     }
 
     const RelatedModel *constItem() const override {
@@ -4,6 +4,7 @@
 #include <QEloquent/relation.h>
 #include <QEloquent/namingconvention.h>
 #include <QEloquent/query.h>
+#include <QEloquent/jsonwriter.h>
 
 namespace QEloquent {
 
@@ -32,6 +33,19 @@ public:
         return maps;
     }
 
+    void writeJson(JsonWriter &writer) const override final {
+        if (this->multiple()) {
+            writer.beginArray();
+            for (const RelatedModel &model : related)
+                model.writeJson(writer);
+            writer.endArray();
+        } else if (related.isEmpty()) {
+            writer.writeNull();
+        } else {
+            related.first().writeJson(writer);
+        }
+    }
+
     QList<RelatedModel> related;
 };
 
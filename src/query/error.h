@@ -18,7 +18,8 @@ public:
     enum ErrorType {
         NoError,
         NotFoundError,
-        DatabaseError
+        DatabaseError,
+        IOError
     };
 
     Error();
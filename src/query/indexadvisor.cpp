@@ -0,0 +1,572 @@
+#include "indexadvisor.h"
+
+#include <QEloquent/connection.h>
+#include <QEloquent/driver.h>
+#include <QEloquent/querybuilder.h>
+
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QSqlRecord>
+#include <QSqlIndex>
+#include <QHash>
+#include <QSet>
+
+#include <algorithm>
+
+// Suggested indexes have at most this many columns
+#define MAX_INDEX_COLUMNS 4
+
+// Sample fingerprints kept per suggestion
+#define MAX_FINGERPRINTS 5
+
+namespace QEloquent {
+
+namespace {
+
+struct Token
+{
+    enum Type {
+        Word,
+        QuotedWord,
+        Symbol,
+        Value,
+        End
+    };
+
+    Type type = End;
+    QString text;
+
+    bool isKeyword(QLatin1String keyword) const
+    { return type == Word && text.compare(keyword, Qt::CaseInsensitive) == 0; }
+
+    bool isSymbol(QLatin1String symbol) const
+    { return type == Symbol && text == symbol; }
+
+    // Identifier, reserved words aside
+    bool isName() const
+    {
+        static const QSet<QString> keywords = {
+            "SELECT", "DISTINCT", "FROM", "WHERE", "JOIN", "INNER", "LEFT", "RIGHT", "FULL", "CROSS", "OUTER", "NATURAL",
+            "ON", "USING", "AND", "OR", "NOT", "IN", "IS", "NULL", "LIKE", "BETWEEN", "EXISTS", "AS", "ORDER", "GROUP",
+            "BY", "HAVING", "LIMIT", "OFFSET", "ASC", "DESC", "NULLS", "UNION", "EXCEPT", "INTERSECT", "ALL", "INSERT",
+            "INTO", "VALUES", "UPDATE", "SET", "DELETE", "RETURNING", "DEFAULT", "CASE", "WHEN", "THEN", "ELSE", "END",
+            "TRUE", "FALSE", "WITH", "WINDOW"
+        };
+        return type == QuotedWord || (type == Word && !keywords.contains(text.toUpper()));
+    }
+};
+
+struct ColumnUse
+{
+    QString table;
+    QString column;
+};
+
+struct Candidate
+{
+    QString table;
+    QStringList columns;
+    qsizetype equalities = 0; // Leading columns compared for equality, in any order
+};
+
+QList<Token> tokenize(const QString &statement)
+{
+    QList<Token> tokens;
+
+    const qsizetype size = statement.size();
+    qsizetype i = 0;
+    while (i < size) {
+        const QChar c = statement.at(i);
+
+        if (c.isSpace()) {
+            ++i;
+            continue;
+        }
+
+        // Quoted identifiers
+        if (c == '"' || c == '`' || c == '[') {
+            const QChar close = (c == '[' ? QChar(']') : c);
+            qsizetype end = statement.indexOf(close, i + 1);
+            if (end < 0)
+                end = size;
+            tokens.append({ Token::QuotedWord, statement.mid(i + 1, end - i - 1) });
+            i = end + 1;
+            continue;
+        }
+
+        // String literals, quotes being doubled inside
+        if (c == '\'') {
+            qsizetype end = i + 1;
+            while (end < size && (statement.at(end) != '\'' || (end + 1 < size && statement.at(end + 1) == '\'')))
+                end += (statement.at(end) == '\'' ? 2 : 1);
+            tokens.append({ Token::Value, QString() });
+            i = end + 1;
+            continue;
+        }
+
+        // Numbers and placeholders, including fingerprint ones
+        if (c.isDigit() || c == '?' || ((c == ':' || c == '$') && i + 1 < size && statement.at(i + 1).isLetterOrNumber())) {
+            qsizetype end = i + 1;
+            while (end < size && (statement.at(end).isLetterOrNumber() || statement.at(end) == '.' || statement.at(end) == '_'))
+                ++end;
+            tokens.append({ Token::Value, QString() });
+            i = end;
+            continue;
+        }
+
+        if (c.isLetter() || c == '_') {
+            qsizetype end = i + 1;
+            while (end < size && (statement.at(end).isLetterOrNumber() || statement.at(end) == '_' || statement.at(end) == '$'))
+                ++end;
+            tokens.append({ Token::Word, statement.mid(i, end - i) });
+            i = end;
+            continue;
+        }
+
+        static const QStringList operators = { "<=", ">=", "<>", "!=", "==" };
+        const QString pair = statement.mid(i, 2);
+        if (operators.contains(pair)) {
+            tokens.append({ Token::Symbol, pair });
+            i += 2;
+        } else {
+            tokens.append({ Token::Symbol, QString(c) });
+            ++i;
+        }
+    }
+
+    return tokens;
+}
+
+// Finds the columns a statement filters, joins and sorts on, per table
+class StatementAnalyzer
+{
+public:
+    explicit StatementAnalyzer(const QString &statement)
+        : tokens(tokenize(statement))
+    {}
+
+    QList<Candidate> candidates();
+
+private:
+    const Token &at(qsizetype index) const
+    {
+        static const Token end;
+        return (index < tokens.size() ? tokens.at(index) : end);
+    }
+
+    qsizetype readName(qsizetype index, QString *qualifier, QString *name) const;
+    QString resolve(const QString &qualifier) const;
+    void collectTables();
+    void collectColumns();
+
+    const QList<Token> tokens;
+    QHash<QString, QString> tables; // Lower case table names and aliases
+    QString mainTable;
+
+    QList<ColumnUse> equalities;
+    QList<ColumnUse> ranges;
+    QList<ColumnUse> orders;
+    QList<ColumnUse> joins;
+};
+
+// Reads an optionally qualified name, returns the index of the next token or index if there is no name
+qsizetype StatementAnalyzer::readName(qsizetype index, QString *qualifier, QString *name) const
+{
+    if (!at(index).isName())
+        return index;
+
+    qualifier->clear();
+    *name = at(index).text;
+
+    if (at(index + 1).isSymbol(QLatin1String(".")) && at(index + 2).isName()) {
+        *qualifier = *name;
+        *name = at(index + 2).text;
+        return index + 3;
+    }
+
+    return index + 1;
+}
+
+QString StatementAnalyzer::resolve(const QString &qualifier) const
+{
+    return (qualifier.isEmpty() ? mainTable : tables.value(qualifier.toLower()));
+}
+
+void StatementAnalyzer::collectTables()
+{
+    for (qsizetype i(0); i < tokens.size(); ++i) {
+        const Token &token = tokens.at(i);
+        if (!token.isKeyword(QLatin1String("FROM")) && !token.isKeyword(QLatin1String("JOIN"))
+            && !token.isKeyword(QLatin1String("UPDATE")) && !token.isKeyword(QLatin1String("INTO")))
+            continue;
+
+        // Comma separated lists, with optional aliases
+        qsizetype j = i + 1;
+        while (true) {
+            QString schema;
+            QString table;
+            const qsizetype next = readName(j, &schema, &table);
+            if (next == j)
+                break;
+
+            tables.insert(table.toLower(), table);
+            if (mainTable.isEmpty())
+                mainTable = table;
+
+            j = next;
+            if (at(j).isKeyword(QLatin1String("AS")))
+                ++j;
+            if (at(j).isName())
+                tables.insert(at(j++).text.toLower(), table);
+
+            if (!at(j).isSymbol(QLatin1String(",")))
+                break;
+            ++j;
+        }
+    }
+}
+
+void StatementAnalyzer::collectColumns()
+{
+    enum Clause {
+        OtherClause,
+        ConditionClause,
+        OrderClause
+    };
+
+    Clause clause = OtherClause;
+    for (qsizetype i(0); i < tokens.size(); ++i) {
+        const Token &token = tokens.at(i);
+
+        if (token.type == Token::Word) {
+            if (token.isKeyword(QLatin1String("WHERE")) || token.isKeyword(QLatin1String("ON")) || token.isKeyword(QLatin1String("HAVING"))) {
+                clause = ConditionClause;
+                continue;
+            }
+
+            if (token.isKeyword(QLatin1String("ORDER")) && at(i + 1).isKeyword(QLatin1String("BY"))) {
+                clause = OrderClause;
+                ++i;
+                continue;
+            }
+
+            static const QStringList clauses = { "SELECT", "FROM", "JOIN", "GROUP", "LIMIT", "OFFSET", "SET", "VALUES", "UNION", "RETURNING" };
+            if (clauses.contains(token.text, Qt::CaseInsensitive)) {
+                clause = OtherClause;
+                continue;
+            }
+        }
+
+        if (clause == OtherClause)
+            continue;
+
+        QString qualifier;
+        QString column;
+        const qsizetype next = readName(i, &qualifier, &column);
+        if (next == i)
+            continue;
+
+        // Function calls aren't indexable
+        i = next - 1;
+        if (at(next).isSymbol(QLatin1String("(")))
+            continue;
+
+        const QString table = resolve(qualifier);
+        if (table.isEmpty())
+            continue;
+
+        if (clause == OrderClause) {
+            orders.append({ table, column });
+            continue;
+        }
+
+        const Token &op = at(next);
+        const bool equality = op.isSymbol(QLatin1String("=")) || op.isSymbol(QLatin1String("==")) || op.isKeyword(QLatin1String("IN"))
+                              || (op.isKeyword(QLatin1String("IS")) && !at(next + 1).isKeyword(QLatin1String("NOT")));
+        const bool range = op.isSymbol(QLatin1String("<")) || op.isSymbol(QLatin1String(">")) || op.isSymbol(QLatin1String("<="))
+                           || op.isSymbol(QLatin1String(">=")) || op.isKeyword(QLatin1String("BETWEEN")) || op.isKeyword(QLatin1String("LIKE"));
+
+        // Join conditions compare two columns, each side being looked up by its own key
+        if (equality && op.type == Token::Symbol) {
+            QString otherQualifier;
+            QString otherColumn;
+            const qsizetype end = readName(next + 1, &otherQualifier, &otherColumn);
+            if (end != next + 1 && !at(end).isSymbol(QLatin1String("("))) {
+                joins.append({ table, column });
+                const QString otherTable = resolve(otherQualifier);
+                if (!otherTable.isEmpty())
+                    joins.append({ otherTable, otherColumn });
+                i = end - 1;
+                continue;
+            }
+        }
+
+        if (equality)
+            equalities.append({ table, column });
+        else if (range)
+            ranges.append({ table, column });
+    }
+}
+
+QList<Candidate> StatementAnalyzer::candidates()
+{
+    collectTables();
+    if (mainTable.isEmpty())
+        return QList<Candidate>();
+
+    collectColumns();
+
+    QStringList tableOrder;
+    for (const QList<ColumnUse> *uses : { &equalities, &ranges, &orders, &joins })
+        for (const ColumnUse &use : *uses)
+            if (!tableOrder.contains(use.table))
+                tableOrder.append(use.table);
+
+    QList<Candidate> candidates;
+    for (const QString &table : tableOrder) {
+        Candidate filter;
+        filter.table = table;
+
+        const auto appendTo = [&table](Candidate *candidate, const ColumnUse &use) {
+            if (use.table == table && !candidate->columns.contains(use.column, Qt::CaseInsensitive)) {
+                candidate->columns.append(use.column);
+                return true;
+            }
+            return false;
+        };
+        const auto append = [&appendTo, &filter](const ColumnUse &use) { return appendTo(&filter, use); };
+
+        // Equality columns first, then a single range column, or sort columns
+        for (const ColumnUse &use : std::as_const(equalities))
+            append(use);
+        filter.equalities = filter.columns.size();
+
+        const bool ranged = std::any_of(ranges.cbegin(), ranges.cend(), append);
+        if (!ranged)
+            std::for_each(orders.cbegin(), orders.cend(), append);
+
+        // Join keys make their own index: the side driving the join is read through its filters,
+        // the other one is looked up by its key alone
+        Candidate join;
+        join.table = table;
+        for (const ColumnUse &use : std::as_const(joins))
+            appendTo(&join, use);
+        join.equalities = join.columns.size();
+
+        for (Candidate candidate : { filter, join }) {
+            candidate.columns = candidate.columns.mid(0, MAX_INDEX_COLUMNS);
+            candidate.equalities = qMin(candidate.equalities, candidate.columns.size());
+            if (!candidate.columns.isEmpty() && (candidates.isEmpty() || candidates.last().table != table || candidates.last().columns != candidate.columns))
+                candidates.append(candidate);
+        }
+    }
+
+    return candidates;
+}
+
+QStringList lowerCase(const QStringList &list)
+{
+    QStringList lower;
+    lower.reserve(list.size());
+    for (const QString &item : list)
+        lower.append(item.toLower());
+    return lower;
+}
+
+// An index serves the candidate if it starts with its equality columns, in any order, followed by the others.
+// Equality on every column of a unique index already selects a single row, nothing is left to index.
+bool isCovered(const Candidate &candidate, const QList<TableIndex> &indexes)
+{
+    const QStringList columns = lowerCase(candidate.columns);
+    const qsizetype equalities = candidate.equalities;
+    const QStringList equalityColumns = columns.mid(0, equalities);
+
+    return std::any_of(indexes.cbegin(), indexes.cend(), [&](const TableIndex &index) {
+        const QStringList indexColumns = lowerCase(index.columns);
+        if (index.unique && !indexColumns.isEmpty()
+            && std::all_of(indexColumns.cbegin(), indexColumns.cend(), [&](const QString &column) { return equalityColumns.contains(column); }))
+            return true;
+
+        if (indexColumns.size() < columns.size())
+            return false;
+
+        return std::is_permutation(columns.cbegin(), columns.cbegin() + equalities, indexColumns.cbegin(), indexColumns.cbegin() + equalities)
+               && std::equal(columns.cbegin() + equalities, columns.cend(), indexColumns.cbegin() + equalities);
+    });
+}
+
+} // namespace
+
+/*!
+ * @class QEloquent::IndexAdvisor
+ * @brief Suggests missing indexes from the statements recorded by QueryStatistics.
+ *
+ * Each statement is parsed for the columns it filters on (WHERE, HAVING), joins on (ON) and sorts by (ORDER BY).
+ * Equality columns make the leading columns of a candidate index, followed by a range or sort column.
+ * Join keys make candidates of their own, never merged with filter columns.
+ * Candidates already served by an existing index, primary key included, or filtering every column of a unique index
+ * for equality are dropped, the others are ranked by the time spent in the statements they would serve.
+ * @code
+ * QueryStatistics::enable();
+ * // ...
+ * for (const IndexSuggestion &suggestion : IndexAdvisor::suggestions(Connection::defaultConnection()))
+ *     qDebug() << suggestion.statement << suggestion.calls << suggestion.totalNs / 1000000 << "ms";
+ * @endcode
+ */
+
+/*!
+ * @brief Returns index suggestions for the tables of \a connection, from the current query statistics.
+ */
+QList<IndexSuggestion> IndexAdvisor::suggestions(const Connection &connection)
+{
+    return suggestions(connection, QueryStatistics::entries());
+}
+
+/*!
+ * @brief Returns index suggestions for the tables of \a connection from \a entries, most impactful first.
+ *
+ * Statements on tables unknown to \a connection are ignored.
+ */
+QList<IndexSuggestion> IndexAdvisor::suggestions(const Connection &connection, const QList<QueryStatisticsEntry> &entries)
+{
+    QHash<QString, QList<TableIndex>> indexes;
+    QHash<QString, qsizetype> positions;
+    QList<IndexSuggestion> suggestions;
+
+    for (const QueryStatisticsEntry &entry : entries) {
+        if (entry.calls == 0)
+            continue;
+
+        const QList<Candidate> candidates = StatementAnalyzer(entry.fingerprint).candidates();
+        for (Candidate candidate : candidates) {
+            const QSqlRecord record = connection.record(candidate.table);
+            if (record.isEmpty())
+                continue;
+
+            // Aliases and expressions aren't columns, the index stops before them
+            for (qsizetype i(0); i < candidate.columns.size(); ++i) {
+                if (!record.contains(candidate.columns.at(i))) {
+                    candidate.columns = candidate.columns.mid(0, i);
+                    candidate.equalities = qMin(candidate.equalities, i);
+                    break;
+                }
+            }
+
+            if (candidate.columns.isEmpty())
+                continue;
+
+            auto existing = indexes.find(candidate.table);
+            if (existing == indexes.end())
+                existing = indexes.insert(candidate.table, existingIndexes(connection, candidate.table));
+            if (isCovered(candidate, existing.value()))
+                continue;
+
+            const QString key = (candidate.table + '\n' + candidate.columns.join('\n')).toLower();
+            auto position = positions.constFind(key);
+            if (position == positions.constEnd()) {
+                IndexSuggestion suggestion;
+                suggestion.tableName = candidate.table;
+                suggestion.columns = candidate.columns;
+                suggestion.statement = QueryBuilder::createIndexStatement(candidate.table, candidate.columns, false, connection);
+                position = positions.insert(key, suggestions.size());
+                suggestions.append(suggestion);
+            }
+
+            IndexSuggestion &suggestion = suggestions[position.value()];
+            suggestion.calls += entry.calls;
+            suggestion.totalNs += entry.totalNs;
+            if (suggestion.fingerprints.size() < MAX_FINGERPRINTS)
+                suggestion.fingerprints.append(entry.fingerprint);
+        }
+    }
+
+    // A suggestion is dropped in favour of a longer one starting with its columns
+    for (qsizetype i(0); i < suggestions.size(); ++i) {
+        const QStringList columns = lowerCase(suggestions.at(i).columns);
+        for (qsizetype j(0); j < suggestions.size(); ++j) {
+            const IndexSuggestion &other = suggestions.at(j);
+            if (j == i || other.columns.size() <= columns.size() || other.tableName.compare(suggestions.at(i).tableName, Qt::CaseInsensitive) != 0)
+                continue;
+
+            if (lowerCase(other.columns.mid(0, columns.size())) == columns) {
+                suggestions[j].calls += suggestions.at(i).calls;
+                suggestions[j].totalNs += suggestions.at(i).totalNs;
+                for (const QString &fingerprint : suggestions.at(i).fingerprints)
+                    if (suggestions.at(j).fingerprints.size() < MAX_FINGERPRINTS)
+                        suggestions[j].fingerprints.append(fingerprint);
+
+                suggestions.removeAt(i--);
+                break;
+            }
+        }
+    }
+
+    std::stable_sort(suggestions.begin(), suggestions.end(), [](const IndexSuggestion &a, const IndexSuggestion &b) {
+        return a.totalNs > b.totalNs;
+    });
+    return suggestions;
+}
+
+/*!
+ * @brief Returns the candidate indexes of \a statement, per table, without checking the schema.
+ */
+QList<IndexSuggestion> IndexAdvisor::candidates(const QString &statement)
+{
+    const QList<Candidate> candidates = StatementAnalyzer(statement).candidates();
+
+    QList<IndexSuggestion> suggestions;
+    suggestions.reserve(candidates.size());
+    for (const Candidate &candidate : candidates) {
+        IndexSuggestion suggestion;
+        suggestion.tableName = candidate.table;
+        suggestion.columns = candidate.columns;
+        suggestions.append(suggestion);
+    }
+    return suggestions;
+}
+
+/*!
+ * @brief Returns the indexes of \a tableName, the primary key first.
+ *
+ * Secondary indexes are listed using Driver::indexColumnsStatement(), only the primary key is known when unsupported.
+ */
+QList<TableIndex> IndexAdvisor::existingIndexes(const Connection &connection, const QString &tableName)
+{
+    QList<TableIndex> indexes;
+
+    const QSqlIndex primary = connection.database().primaryIndex(tableName);
+    if (!primary.isEmpty()) {
+        TableIndex index;
+        for (int i(0); i < primary.count(); ++i)
+            index.columns.append(primary.fieldName(i));
+        index.unique = true;
+        indexes.append(index);
+    }
+
+    const QString statement = (connection.driver() ? connection.driver()->indexColumnsStatement(tableName) : QString());
+    if (statement.isEmpty())
+        return indexes;
+
+    // Catalog reads aren't application statements, listeners and statistics don't see them
+    QSqlQuery query(connection.database());
+    query.setForwardOnly(true);
+    if (!query.exec(statement))
+        return indexes;
+
+    QString current;
+    bool first = true;
+    while (query.next()) {
+        const QString name = query.value(0).toString();
+        if (first || name != current) {
+            indexes.append(TableIndex());
+            indexes.last().unique = query.value(2).toBool();
+            current = name;
+            first = false;
+        }
+        indexes.last().columns.append(query.value(1).toString());
+    }
+
+    return indexes;
+}
+
+} // namespace QEloquent
@@ -0,0 +1,50 @@
+#ifndef QELOQUENT_INDEXADVISOR_H
+#define QELOQUENT_INDEXADVISOR_H
+
+#include <QEloquent/global.h>
+#include <QEloquent/querystatistics.h>
+
+#include <QStringList>
+
+namespace QEloquent {
+
+class Connection;
+
+/*!
+ * @brief Index that would serve some recorded statements.
+ *
+ * Durations are in nanoseconds, totalNs being the time spent in the statements the index would serve,
+ * an upper bound of what it can save.
+ */
+struct IndexSuggestion
+{
+    QString tableName;
+    QStringList columns;
+    QString statement;
+    qint64 calls = 0;
+    qint64 totalNs = 0;
+    QStringList fingerprints;
+};
+
+/*!
+ * @brief Index defined on a table, the primary key being unique.
+ */
+struct TableIndex
+{
+    QStringList columns;
+    bool unique = false;
+};
+
+class QELOQUENT_EXPORT IndexAdvisor
+{
+public:
+    static QList<IndexSuggestion> suggestions(const Connection &connection);
+    static QList<IndexSuggestion> suggestions(const Connection &connection, const QList<QueryStatisticsEntry> &entries);
+
+    static QList<IndexSuggestion> candidates(const QString &statement);
+    static QList<TableIndex> existingIndexes(const Connection &connection, const QString &tableName);
+};
+
+} // namespace QEloquent
+
+#endif // QELOQUENT_INDEXADVISOR_H
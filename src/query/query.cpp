@@ -18,6 +18,7 @@ public:
         QString op;
         QVariant value;
         QString expression;
+        QList<Query> group; // Filters of a nested query, rendered in parentheses
     };
 
     struct Sort {
@@ -170,6 +171,20 @@ Query &Query::andWhere(const QString &expression)
     return *this;
 }
 
+/*!
+ * \brief Adds the WHERE clauses of \a group, in parentheses, so its OR clauses stay inside.
+ *
+ * Only the filters of \a group are used, its table, joins and sorts are ignored.
+ */
+Query &Query::andWhere(const Query &group)
+{
+    ModelQueryData::Filter f;
+    f.inclusive = true;
+    f.group.append(group);
+    data->filters.append(f);
+    return *this;
+}
+
 /*!
  * \brief Adds an OR WHERE clause with a custom operator.
  */
@@ -196,6 +211,18 @@ Query &Query::orWhere(const QString &expression)
     return *this;
 }
 
+/*!
+ * \brief Adds the WHERE clauses of \a group, in parentheses, as an OR WHERE clause.
+ */
+Query &Query::orWhere(const Query &group)
+{
+    ModelQueryData::Filter f;
+    f.inclusive = false;
+    f.group.append(group);
+    data->filters.append(f);
+    return *this;
+}
+
 /*!
  * \brief Adds a GROUP BY clause.
  */
@@ -327,19 +354,27 @@ QString Query::whereClause() const
  * \brief Returns the generated WHERE clause string for a specific connection.
  */
 QString Query::whereClause(const Connection connection) const
+{
+    const QString expressions = filterExpressions(connection);
+    return (expressions.isEmpty() ? QString() : "WHERE " + expressions);
+}
+
+// Filters joined by their logical operators, without the WHERE keyword
+QString Query::filterExpressions(const Connection &connection) const
 {
     QStringList expressions;
 
-    bool first = true;
     for (const ModelQueryData::Filter &filter : data->filters) {
         QString logicalOperator;
-        if (first)
-            first = false;
-        else
+        if (!expressions.isEmpty())
             logicalOperator = (filter.inclusive ? "AND " : "OR ");
 
         QString expression;
-        if (!filter.expression.isEmpty())
+        if (!filter.group.isEmpty()) {
+            const QString group = filter.group.first().filterExpressions(connection);
+            if (!group.isEmpty())
+                expression = logicalOperator + '(' + group + ')';
+        } else if (!filter.expression.isEmpty())
             expression = logicalOperator + filter.expression;
         else if (!filter.field.isEmpty()) {
             expression = logicalOperator + QueryBuilder::escapeFieldName(filter.field, connection);
@@ -351,7 +386,7 @@ QString Query::whereClause(const Connection connection) const
             expressions.append(expression);
     }
 
-    return (expressions.isEmpty() ? QString() : "WHERE " + expressions.join(' '));
+    return expressions.join(' ');
 }
 
 /*!
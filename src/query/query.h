@@ -30,14 +30,17 @@ public:
     Query &where(const QString &field, const QVariant &value) { return andWhere(field, "=", value); }
     Query &where(const QString &field, const QString &op, const QVariant &value) { return andWhere(field, op, value); }
     Query &where(const QString &expression) { return andWhere(expression); }
+    Query &where(const Query &group) { return andWhere(group); }
 
     Query &andWhere(const QString &field, const QVariant &value) { return andWhere(field, "=", value); }
     Query &andWhere(const QString &field, const QString &op, const QVariant &value);
     Query &andWhere(const QString &expression);
+    Query &andWhere(const Query &group);
 
     Query &orWhere(const QString &field, const QVariant &value) { return orWhere(field, "=", value); }
     Query &orWhere(const QString &field, const QString &op, const QVariant &value);
     Query &orWhere(const QString &expression);
+    Query &orWhere(const Query &group);
 
     Query &join(const QString &table, const QString &first, const QString &op, const QString &second, const QString &type = "INNER");
 
@@ -77,6 +80,8 @@ public:
     QStringList relations() const;
 
 private:
+    QString filterExpressions(const Connection &connection) const;
+
     QSharedDataPointer<ModelQueryData> data;
 };
 
@@ -4,6 +4,8 @@
 #include <QEloquent/connection.h>
 #include <QEloquent/datamap.h>
 #include <QEloquent/driver.h>
+#include <QEloquent/tracer.h>
+#include <QEloquent/scriptreader.h>
 #ifdef QELOQUENT_MIGRATIONS_SUPPORT
 #   include <QEloquent/tableblueprint.h>
 #   include <QEloquent/private/tableblueprint_p.h>
@@ -13,6 +15,7 @@
 #include <QSqlDriver>
 #include <QSqlField>
 #include <QFile>
+#include <QDebug>
 
 namespace QEloquent {
 
@@ -47,6 +50,7 @@ QString QueryBuilder::selectStatement(const QStringList fields, const Query &que
 
 QString QueryBuilder::selectStatement(const QString fields, const Query &query)
 {
+    TraceSpan span("QueryBuilder::selectStatement", "query");
     const Connection connection = query.connection();
 
     QString statement = "SELECT " + fields + " FROM " + escapeTableName(query.tableName(), connection);
@@ -58,6 +62,7 @@ QString QueryBuilder::selectStatement(const QString fields, const Query &query)
 
 QString QueryBuilder::insertStatement(const DataMap &data, const Query &query)
 {
+    TraceSpan span("QueryBuilder::insertStatement", "query");
     const Connection connection = query.connection();
 
     QStringList fields = data.keys();
@@ -72,8 +77,46 @@ QString QueryBuilder::insertStatement(const DataMap &data, const Query &query)
     return statement;
 }
 
+/*!
+ * @brief Generates a multi-row INSERT, fields are those of the first row. Fields missing from other rows are NULL.
+ */
+QString QueryBuilder::insertStatement(const QList<DataMap> &rows, const Query &query)
+{
+    TraceSpan span("QueryBuilder::insertStatement", "query");
+    if (rows.isEmpty())
+        return QString();
+
+    const Connection connection = query.connection();
+
+    const QStringList fields = rows.first().keys();
+    QStringList escapedFields;
+    escapedFields.reserve(fields.size());
+    for (const QString &field : fields)
+        escapedFields.append(escapeFieldName(field, connection));
+
+    QString statement = "INSERT INTO " + escapeTableName(query.tableName(), connection);
+    statement.append(" (" + escapedFields.join(", ") + ") VALUES ");
+
+    for (qsizetype i(0); i < rows.size(); ++i) {
+        const DataMap &row = rows.at(i);
+
+        if (i > 0)
+            statement.append(", ");
+        statement.append('(');
+        for (qsizetype j(0); j < fields.size(); ++j) {
+            if (j > 0)
+                statement.append(", ");
+            statement.append(formatValue(row.value(fields.at(j)), connection));
+        }
+        statement.append(')');
+    }
+
+    return statement;
+}
+
 QString QueryBuilder::updateStatement(const DataMap &data, const Query &query)
 {
+    TraceSpan span("QueryBuilder::updateStatement", "query");
     const Connection connection = query.connection();
 
     const QStringList fields = data.keys();
@@ -93,6 +136,7 @@ QString QueryBuilder::updateStatement(const DataMap &data, const Query &query)
 
 QString QueryBuilder::deleteStatement(const Query &query)
 {
+    TraceSpan span("QueryBuilder::deleteStatement", "query");
     const Connection connection = query.connection();
 
     QString statement = "DELETE FROM " + escapeTableName(query.tableName(), connection);
@@ -148,6 +192,31 @@ QString QueryBuilder::alterTableStatement(const QString &tableName, const TableB
 
 #endif
 
+/*!
+ * @brief Returns a CREATE INDEX statement on \a columns of \a tableName, named by indexName() if \a indexName is empty.
+ */
+QString QueryBuilder::createIndexStatement(const QString &tableName, const QStringList &columns, bool unique, const Connection &connection, const QString &indexName)
+{
+    QStringList fields;
+    fields.reserve(columns.size());
+    for (const QString &column : columns)
+        fields.append(escapeFieldName(column, connection));
+
+    return QStringLiteral("CREATE %1INDEX %2 ON %3 (%4)")
+        .arg(unique ? "UNIQUE " : "",
+             escapeTableName(indexName.isEmpty() ? QueryBuilder::indexName(tableName, columns, unique) : indexName, connection),
+             escapeTableName(tableName, connection),
+             fields.join(", "));
+}
+
+/*!
+ * @brief Returns the conventional name of an index, e.g. products_category_id_name_index.
+ */
+QString QueryBuilder::indexName(const QString &tableName, const QStringList &columns, bool unique)
+{
+    return (tableName + '_' + columns.join('_') + (unique ? "_unique" : "_index")).toLower();
+}
+
 QString QueryBuilder::escapeFieldName(const QString &name, const Connection &connection)
 {
     QSqlDriver *driver = connection.database().driver();
@@ -186,62 +255,44 @@ QString QueryBuilder::formatValue(const QVariant &value, const QMetaType &type,
 QStringList QueryBuilder::statementsFromScriptFile(const QString &fileName)
 {
     QFile file(fileName);
-    if (file.open(QIODevice::ReadOnly | QIODevice::Text))
-        return statementsFromScriptContent(file.readAll());
+    if (file.open(QIODevice::ReadOnly))
+        return statementsFromScriptDevice(&file);
     else
         return QStringList();
 }
 
 QStringList QueryBuilder::statementsFromScriptDevice(QIODevice *device)
 {
-    if (device->isReadable())
-        return statementsFromScriptContent(device->readAll());
-    else
+    if (!device->isReadable())
         return QStringList();
+
+    ScriptReader reader(device);
+    return statementsFromScript(&reader);
 }
 
+/*!
+ * @brief Splits \a content into statements, the whole script being kept in memory.
+ *
+ * Prefer QueryRunner::execScript() for large scripts, statements are then executed as they are read.
+ *
+ * @sa ScriptReader
+ */
 QStringList QueryBuilder::statementsFromScriptContent(const QByteArray &content)
 {
-    QStringList statements;
-    QStringList input = QString::fromUtf8(content.trimmed()).split('\n');
+    ScriptReader reader(content);
+    return statementsFromScript(&reader);
+}
 
+QStringList QueryBuilder::statementsFromScript(ScriptReader *reader)
+{
+    QStringList statements;
     QString statement;
-    QString delimiter = ";";
-    for (QString &line : input) {
-        line = line.trimmed();
-
-        // We skip empty lines
-        if (line.isEmpty())
-            continue;
-
-        // We skip comments
-        if (line.startsWith("--"))
-            continue;
-
-        // We change delimiter
-        if (line.contains("DELIMITER", Qt::CaseInsensitive)) {
-            line.remove("DELIMITER", Qt::CaseInsensitive);
-            delimiter = line.trimmed();
-        }
-
-        // We append reading to the current statement
-        statement.append(line);
-
-        // If delimiter found, we complete the current statement and move to the next
-        if (line.endsWith(delimiter)) {
-            statement.remove(statement.size() - 1, 1); // We remove delimiter
-            statements.append(statement);
-            statement.clear();
-        }
-    }
-
-    // If there is only one statement without delimiter
-    if (statements.isEmpty() && !statement.isEmpty())
+    while (reader->readStatement(&statement))
         statements.append(statement);
 
+    if (reader->hasError())
+        qWarning().noquote() << "QEloquent: " + reader->errorString();
     return statements;
 }
 
-
-
 } // namespace QEloquent
@@ -10,6 +10,7 @@ namespace QEloquent {
 class Query;
 class DataMap;
 class Connection;
+class ScriptReader;
 
 class QELOQUENT_EXPORT QueryBuilder
 {
@@ -20,6 +21,7 @@ public:
     static QString selectStatement(const QString fields, const Query &query);
 
     static QString insertStatement(const DataMap &data, const Query &query);
+    static QString insertStatement(const QList<DataMap> &rows, const Query &query);
 
     static QString updateStatement(const DataMap &data, const Query &query);
 
@@ -30,6 +32,9 @@ public:
     static QString alterTableStatement(const QString &tableName, const TableBlueprint &blueprint, const Connection &connection);
 #endif
 
+    static QString createIndexStatement(const QString &tableName, const QStringList &columns, bool unique, const Connection &connection, const QString &indexName = QString());
+    static QString indexName(const QString &tableName, const QStringList &columns, bool unique = false);
+
     static QString escapeFieldName(const QString &name, const Connection &connection);
     static QString escapeTableName(const QString &name, const Connection &connection);
 
@@ -41,6 +46,9 @@ public:
     static QStringList statementsFromScriptContent(const QByteArray &content);
 
     static QString singularise(const QString &word);
+
+private:
+    static QStringList statementsFromScript(ScriptReader *reader);
 };
 
 } // namespace QEloquent
@@ -4,12 +4,35 @@
 #include <QEloquent/querybuilder.h>
 #include <QEloquent/connection.h>
 #include <QEloquent/datamap.h>
+#include <QEloquent/tracer.h>
+#include <QEloquent/scriptreader.h>
 
 #include <QSqlQuery>
 #include <QSqlError>
+#include <QSqlDriver>
+#include <QElapsedTimer>
+#include <QFile>
+
+// Scripts run with transactions disabled report progress every this many statements
+#define SCRIPT_PROGRESS_INTERVAL 1000
 
 namespace QEloquent {
 
+// Statements handling transactions, scripts using them are not batched
+static bool isTransactionStatement(const QString &statement)
+{
+    static const QStringList keywords = { "BEGIN", "START", "COMMIT", "END", "ROLLBACK", "SAVEPOINT", "RELEASE" };
+
+    const qsizetype length = std::find_if(statement.begin(), statement.end(), [](QChar c) {
+        return !c.isLetter();
+    }) - statement.begin();
+
+    const QStringView keyword = QStringView(statement).left(length);
+    return std::any_of(keywords.begin(), keywords.end(), [keyword](const QString &candidate) {
+        return keyword.compare(candidate, Qt::CaseInsensitive) == 0;
+    });
+}
+
 Result<QSqlQuery, QSqlError> QueryRunner::select(const Query &query)
 {
     const QString statement = QueryBuilder::selectStatement(query);
@@ -94,12 +117,207 @@ Result<QSqlQuery, QSqlError> QueryRunner::exec(const QString &statement, const Q
 
 Result<QSqlQuery, QSqlError> QueryRunner::exec(const QString &statement, const Connection &connection)
 {
+    if (!hasListeners())
+        return execute(statement, connection, true, nullptr);
+
+    QueryRecord record;
+    auto result = execute(statement, connection, true, &record);
+    notify(record);
+    return result;
+}
+
+/*!
+ * @brief Executes \a statement, filling \a record (if not null) with timings and row counts.
+ *
+ * Listeners are not notified, the caller is expected to complete the record (fetch time, model class, ...)
+ * and pass it to notify() afterwards.
+ */
+Result<QSqlQuery, QSqlError> QueryRunner::exec(const QString &statement, const Connection &connection, QueryRecord *record)
+{
+    return execute(statement, connection, true, record);
+}
+
+/*!
+ * @brief Executes the statements of an SQL script read from \a device, returns the number of executed statements.
+ *
+ * Statements are read one at a time by a ScriptReader and executed in transactions of options.transactionSize
+ * statements, the progress handler being called after each of them. Batching stops as soon as the script
+ * handles transactions itself. Backslash escapes of string literals are understood on MySQL.
+ *
+ * Execution stops at the first error, the current transaction is then rolled back, previous ones are kept.
+ */
+Result<qint64, QSqlError> QueryRunner::execScript(QIODevice *device, const Connection &connection, const ScriptOptions &options)
+{
+    TraceSpan span("QueryRunner::execScript", "query");
+
+    ScriptProgress progress;
+    if (!device->isSequential())
+        progress.totalBytes = device->size() - device->pos();
+
+    Connection db(connection);
+    bool batching = options.transactionSize > 0 && db.database().driver()->hasFeature(QSqlDriver::Transactions);
+    bool inTransaction = false;
+    qint64 pending = 0;
+    const int interval = (options.transactionSize > 0 ? options.transactionSize : SCRIPT_PROGRESS_INTERVAL);
+
+    const auto commit = [&]() -> bool {
+        if (inTransaction) {
+            inTransaction = false;
+            if (!db.commitTransaction())
+                return false;
+        }
+
+        pending = 0;
+        if (options.progress)
+            options.progress(progress);
+        return true;
+    };
+
+    ScriptReader reader(device);
+    reader.setBackslashEscapes(db.database().driver()->dbmsType() == QSqlDriver::MySqlServer);
+    QString statement;
+    while (reader.readStatement(&statement)) {
+        if (isTransactionStatement(statement)) {
+            if (!commit())
+                return failWith(db.lastError());
+            batching = false;
+        } else if (batching && !inTransaction) {
+            inTransaction = db.beginTransaction();
+        }
+
+        auto result = exec(statement, db);
+        if (!result) {
+            if (inTransaction)
+                db.rollbackTransaction();
+            return failWith(result.error());
+        }
+
+        progress.bytesRead = reader.bytesRead();
+        ++progress.statements;
+        if (++pending >= interval && !commit())
+            return failWith(db.lastError());
+    }
+
+    if (reader.hasError()) {
+        if (inTransaction)
+            db.rollbackTransaction();
+        return failWith(QSqlError(reader.errorString(), QString(), QSqlError::UnknownError));
+    }
+
+    if (!commit())
+        return failWith(db.lastError());
+
+    if (span.isActive())
+        span.setDetail(QString::number(progress.statements) + " statements");
+    return progress.statements;
+}
+
+/*!
+ * @brief Executes the SQL script \a fileName, the file being memory mapped when possible.
+ *
+ * @sa execScript()
+ */
+Result<qint64, QSqlError> QueryRunner::execScriptFile(const QString &fileName, const Connection &connection, const ScriptOptions &options)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly))
+        return failWith(QSqlError("Can't open " + fileName + ": " + file.errorString(), QString(), QSqlError::UnknownError));
+    return execScript(&file, connection, options);
+}
+
+Result<QSqlQuery, QSqlError> QueryRunner::execute(const QString &statement, const Connection &connection, bool forwardOnly, QueryRecord *record)
+{
+    TraceSpan span("QueryRunner::exec", "query");
+    if (span.isActive())
+        span.setDetail(statement);
+
     QSqlQuery query(connection.database());
-    query.setForwardOnly(true);
-    if (query.exec(statement))
-        return query;
-    else
+    query.setForwardOnly(forwardOnly);
+
+    if (!record) {
+        if (query.exec(statement))
+            return query;
+        else
+            return failWith(query.lastError());
+    }
+
+    record->statement = statement;
+    record->connectionName = connection.name();
+
+    // Same execution path as without a record, only exec() is timed
+    QElapsedTimer timer;
+    timer.start();
+    const bool ok = query.exec(statement);
+    record->execNs = timer.nsecsElapsed();
+
+    record->success = ok;
+
+    if (!ok) {
+        record->errorText = query.lastError().text();
         return failWith(query.lastError());
+    }
+
+    if (query.isSelect()) {
+        // Only counted when the driver knows, fetching rows here would change how the statement runs
+        if (query.driver()->hasFeature(QSqlDriver::QuerySize))
+            record->rowsReturned = query.size();
+    } else {
+        record->rowsAffected = query.numRowsAffected();
+    }
+
+    return query;
+}
+
+/*!
+ * @brief Registers a listener receiving a record for every executed statement, returns its id.
+ *
+ * Listeners are called from the thread executing the statement.
+ */
+int QueryRunner::addListener(const QueryListener &listener)
+{
+    QWriteLocker locker(&s_listenersLock);
+    const int id = ++s_lastListenerId;
+    s_listeners.append({ id, listener });
+    s_listenerCount.store(s_listeners.size(), std::memory_order_release);
+    return id;
+}
+
+void QueryRunner::removeListener(int id)
+{
+    QWriteLocker locker(&s_listenersLock);
+    s_listeners.removeIf([id](const QPair<int, QueryListener> &listener) {
+        return listener.first == id;
+    });
+    s_listenerCount.store(s_listeners.size(), std::memory_order_release);
+}
+
+/*!
+ * @brief Returns true if at least one listener is registered, this check is cheap.
+ */
+bool QueryRunner::hasListeners()
+{
+    return s_listenerCount.load(std::memory_order_acquire) > 0;
 }
 
+void QueryRunner::notify(const QueryRecord &record)
+{
+    if (!hasListeners())
+        return;
+
+    // Listeners may (un)register others, we call them outside of the lock
+    QList<QPair<int, QueryListener>> listeners;
+    {
+        QReadLocker locker(&s_listenersLock);
+        listeners = s_listeners;
+    }
+
+    for (const QPair<int, QueryListener> &listener : std::as_const(listeners))
+        listener.second(record);
+}
+
+QList<QPair<int, QueryListener>> QueryRunner::s_listeners;
+QReadWriteLock QueryRunner::s_listenersLock;
+std::atomic<int> QueryRunner::s_listenerCount = 0;
+int QueryRunner::s_lastListenerId = 0;
+
 } // namespace QEloquent
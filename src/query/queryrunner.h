@@ -4,6 +4,13 @@
 #include <QEloquent/global.h>
 #include <QEloquent/result.h>
 
+#include <QVariant>
+#include <QReadWriteLock>
+
+#include <atomic>
+#include <functional>
+
+class QIODevice;
 class QSqlQuery;
 class QSqlError;
 
@@ -13,6 +20,49 @@ class Query;
 class Connection;
 class DataMap;
 
+/*!
+ * @brief Execution record of a single statement, as received by query listeners.
+ *
+ * Durations are in nanoseconds, row counts are -1 when unknown. Rows of results fetched by the caller are
+ * only counted when the driver reports the query size, they are otherwise reported by ORM fetches only.
+ */
+struct QueryRecord
+{
+    QString statement;
+    QString connectionName;
+    QString modelClass;
+
+    qint64 execNs = 0;
+    qint64 fetchNs = 0;
+
+    int rowsAffected = -1;
+    int rowsReturned = -1;
+
+    bool success = true;
+    QString errorText;
+
+    qint64 totalNs() const
+    { return execNs + fetchNs; }
+};
+
+typedef std::function<void (const QueryRecord &record)> QueryListener;
+
+/*!
+ * @brief Progress of a script execution, total is -1 when the device size is unknown.
+ */
+struct ScriptProgress
+{
+    qint64 statements = 0;
+    qint64 bytesRead = 0;
+    qint64 totalBytes = -1;
+};
+
+struct ScriptOptions
+{
+    int transactionSize = 1000; // Statements per transaction, 0 disables transactions
+    std::function<void (const ScriptProgress &progress)> progress; // Called after each batch of statements
+};
+
 class QELOQUENT_EXPORT QueryRunner
 {
 public:
@@ -38,6 +88,25 @@ public:
     static Result<QSqlQuery, QSqlError> exec(const QString &statement);
     static Result<QSqlQuery, QSqlError> exec(const QString &statement, const QString &connectionName);
     static Result<QSqlQuery, QSqlError> exec(const QString &statement, const Connection &connection);
+    static Result<QSqlQuery, QSqlError> exec(const QString &statement, const Connection &connection, QueryRecord *record);
+
+    static Result<qint64, QSqlError> execScript(QIODevice *device, const Connection &connection, const ScriptOptions &options = ScriptOptions());
+    static Result<qint64, QSqlError> execScriptFile(const QString &fileName, const Connection &connection, const ScriptOptions &options = ScriptOptions());
+
+    static int addListener(const QueryListener &listener);
+    static void removeListener(int id);
+    static bool hasListeners();
+    static void notify(const QueryRecord &record);
+
+private:
+    static Result<QSqlQuery, QSqlError> execute(const QString &statement, const Connection &connection, bool forwardOnly, QueryRecord *record);
+
+    static QList<QPair<int, QueryListener>> s_listeners;
+    static QReadWriteLock s_listenersLock;
+    static std::atomic<int> s_listenerCount;
+    static int s_lastListenerId;
+
+    friend class Connection;
 };
 
 } // namespace QEloquent
@@ -0,0 +1,319 @@
+#include "querystatistics.h"
+
+#include <QEloquent/queryrunner.h>
+
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QRegularExpression>
+#include <QMutex>
+#include <QHash>
+
+#include <array>
+#include <cmath>
+#include <limits>
+#include <memory>
+
+#define HISTOGRAM_BUCKETS 64
+
+namespace QEloquent {
+
+struct StatementCounters
+{
+    qint64 calls = 0;
+    qint64 errors = 0;
+    qint64 totalNs = 0;
+    qint64 minNs = std::numeric_limits<qint64>::max();
+    qint64 maxNs = 0;
+    qint64 rows = 0;
+    std::array<qint64, HISTOGRAM_BUCKETS> histogram = {};
+
+    void add(qint64 durationNs, qint64 rowCount, bool success)
+    {
+        ++calls;
+        if (!success)
+            ++errors;
+        totalNs += durationNs;
+        minNs = qMin(minNs, durationNs);
+        maxNs = qMax(maxNs, durationNs);
+        rows += rowCount;
+        ++histogram[bucket(durationNs)];
+    }
+
+    void merge(const StatementCounters &other)
+    {
+        calls += other.calls;
+        errors += other.errors;
+        totalNs += other.totalNs;
+        minNs = qMin(minNs, other.minNs);
+        maxNs = qMax(maxNs, other.maxNs);
+        rows += other.rows;
+        for (int i(0); i < HISTOGRAM_BUCKETS; ++i)
+            histogram[i] += other.histogram[i];
+    }
+
+    qint64 percentile(double ratio) const
+    {
+        const qint64 rank = qint64(std::ceil(ratio * calls));
+        qint64 count = 0;
+        for (int i(0); i < HISTOGRAM_BUCKETS; ++i) {
+            count += histogram[i];
+            if (count >= rank)
+                return qBound(minNs, (i == 0 ? qint64(1) : (qint64(1) << i)), maxNs);
+        }
+        return maxNs;
+    }
+
+    // Bucket i holds durations in [2^(i-1), 2^i)
+    static int bucket(qint64 durationNs)
+    {
+        int index = 0;
+        while (durationNs > 0 && index < HISTOGRAM_BUCKETS - 1) {
+            durationNs >>= 1;
+            ++index;
+        }
+        return index;
+    }
+};
+
+// Each thread updates its own shard, the mutex is only contended while merging
+struct StatisticsShard
+{
+    QMutex mutex;
+    QHash<QString, StatementCounters> counters;
+};
+
+struct StatisticsRegistry
+{
+    QMutex mutex;
+    QList<std::shared_ptr<StatisticsShard>> shards;
+    QHash<QString, StatementCounters> retired; // Counters of finished threads
+    int listenerId = -1;
+};
+
+static StatisticsRegistry &registry()
+{
+    static StatisticsRegistry registry;
+    return registry;
+}
+
+// Merges the shard into the retired counters when its thread exits, short lived threads don't pile up shards
+struct LocalShard
+{
+    std::shared_ptr<StatisticsShard> shard;
+
+    ~LocalShard()
+    {
+        if (!shard)
+            return;
+
+        StatisticsRegistry &r = registry();
+        QMutexLocker registryLocker(&r.mutex);
+        {
+            QMutexLocker locker(&shard->mutex);
+            for (auto it = shard->counters.constBegin(); it != shard->counters.constEnd(); ++it)
+                r.retired[it.key()].merge(it.value());
+        }
+        r.shards.removeOne(shard);
+    }
+};
+
+static StatisticsShard *localShard()
+{
+    thread_local LocalShard local;
+    if (!local.shard) {
+        local.shard = std::make_shared<StatisticsShard>();
+
+        StatisticsRegistry &r = registry();
+        QMutexLocker locker(&r.mutex);
+        r.shards.append(local.shard);
+    }
+    return local.shard.get();
+}
+
+/*!
+ * @brief Starts collecting statistics, by listening to QueryRunner.
+ */
+void QueryStatistics::enable()
+{
+    StatisticsRegistry &r = registry();
+    QMutexLocker locker(&r.mutex);
+    if (r.listenerId < 0)
+        r.listenerId = QueryRunner::addListener(&QueryStatistics::record);
+}
+
+void QueryStatistics::disable()
+{
+    StatisticsRegistry &r = registry();
+    QMutexLocker locker(&r.mutex);
+    if (r.listenerId >= 0) {
+        QueryRunner::removeListener(r.listenerId);
+        r.listenerId = -1;
+    }
+}
+
+bool QueryStatistics::isEnabled()
+{
+    StatisticsRegistry &r = registry();
+    QMutexLocker locker(&r.mutex);
+    return r.listenerId >= 0;
+}
+
+void QueryStatistics::record(const QueryRecord &record)
+{
+    const QString key = fingerprint(record.statement);
+    const qint64 rows = (record.rowsReturned >= 0 ? record.rowsReturned : qMax(0, record.rowsAffected));
+
+    StatisticsShard *shard = localShard();
+    QMutexLocker locker(&shard->mutex);
+    shard->counters[key].add(record.totalNs(), rows, record.success);
+}
+
+/*!
+ * @brief Merges per-thread counters and returns entries, most time consuming first.
+ */
+QList<QueryStatisticsEntry> QueryStatistics::entries()
+{
+    QHash<QString, StatementCounters> merged;
+
+    {
+        StatisticsRegistry &r = registry();
+        QMutexLocker registryLocker(&r.mutex);
+        merged = r.retired;
+
+        for (const std::shared_ptr<StatisticsShard> &shard : std::as_const(r.shards)) {
+            QMutexLocker locker(&shard->mutex);
+            for (auto it = shard->counters.constBegin(); it != shard->counters.constEnd(); ++it)
+                merged[it.key()].merge(it.value());
+        }
+    }
+
+    QList<QueryStatisticsEntry> entries;
+    entries.reserve(merged.size());
+
+    for (auto it = merged.constBegin(); it != merged.constEnd(); ++it) {
+        const StatementCounters &counters = it.value();
+
+        QueryStatisticsEntry entry;
+        entry.fingerprint = it.key();
+        entry.calls = counters.calls;
+        entry.errors = counters.errors;
+        entry.totalNs = counters.totalNs;
+        entry.minNs = counters.minNs;
+        entry.maxNs = counters.maxNs;
+        entry.p95Ns = counters.percentile(0.95);
+        entry.rows = counters.rows;
+        entries.append(entry);
+    }
+
+    std::sort(entries.begin(), entries.end(), [](const QueryStatisticsEntry &a, const QueryStatisticsEntry &b) {
+        return a.totalNs > b.totalNs;
+    });
+
+    return entries;
+}
+
+QJsonArray QueryStatistics::toJson()
+{
+    QJsonArray array;
+
+    const QList<QueryStatisticsEntry> entries = QueryStatistics::entries();
+    for (const QueryStatisticsEntry &entry : entries) {
+        QJsonObject object;
+        object.insert("fingerprint", entry.fingerprint);
+        object.insert("calls", entry.calls);
+        object.insert("errors", entry.errors);
+        object.insert("total_ns", entry.totalNs);
+        object.insert("mean_ns", entry.meanNs());
+        object.insert("min_ns", entry.minNs);
+        object.insert("max_ns", entry.maxNs);
+        object.insert("p95_ns", entry.p95Ns);
+        object.insert("rows", entry.rows);
+        array.append(object);
+    }
+
+    return array;
+}
+
+void QueryStatistics::reset()
+{
+    StatisticsRegistry &r = registry();
+    QMutexLocker registryLocker(&r.mutex);
+    r.retired.clear();
+
+    for (const std::shared_ptr<StatisticsShard> &shard : std::as_const(r.shards)) {
+        QMutexLocker locker(&shard->mutex);
+        shard->counters.clear();
+    }
+}
+
+/*!
+ * @brief Normalizes a statement, replacing literals with '?' and value lists with '(...)'.
+ */
+QString QueryStatistics::fingerprint(const QString &statement)
+{
+    QString result;
+    result.reserve(statement.size());
+
+    const qsizetype size = statement.size();
+    bool pendingSpace = false;
+
+    for (qsizetype i(0); i < size; ++i) {
+        const QChar c = statement.at(i);
+
+        // Whitespaces are collapsed
+        if (c.isSpace()) {
+            pendingSpace = !result.isEmpty();
+            continue;
+        }
+
+        if (pendingSpace) {
+            result.append(' ');
+            pendingSpace = false;
+        }
+
+        // String literal, '' being an escaped quote
+        if (c == '\'') {
+            ++i;
+            while (i < size) {
+                if (statement.at(i) == '\'') {
+                    if (i + 1 < size && statement.at(i + 1) == '\'')
+                        ++i;
+                    else
+                        break;
+                }
+                ++i;
+            }
+            result.append('?');
+            continue;
+        }
+
+        // Quoted identifiers are kept as is
+        if (c == '"' || c == '`') {
+            const qsizetype end = statement.indexOf(c, i + 1);
+            const qsizetype last = (end < 0 ? size - 1 : end);
+            result.append(QStringView(statement).mid(i, last - i + 1));
+            i = last;
+            continue;
+        }
+
+        // Numbers, unless part of an identifier
+        if (c.isDigit() && (result.isEmpty() || !(result.back().isLetterOrNumber() || result.back() == '_'))) {
+            while (i + 1 < size && (statement.at(i + 1).isLetterOrNumber() || statement.at(i + 1) == '.'))
+                ++i;
+            result.append('?');
+            continue;
+        }
+
+        result.append(c);
+    }
+
+    // Value lists of any length share the same fingerprint
+    static const QRegularExpression lists(QStringLiteral("\\(\\s*\\?(\\s*,\\s*\\?)*\\s*\\)"));
+    static const QRegularExpression rows(QStringLiteral("\\(\\.\\.\\.\\)(\\s*,\\s*\\(\\.\\.\\.\\))+"));
+    result.replace(lists, QStringLiteral("(...)"));
+    result.replace(rows, QStringLiteral("(...)"));
+
+    return result;
+}
+
+} // namespace QEloquent
@@ -0,0 +1,50 @@
+#ifndef QELOQUENT_QUERYSTATISTICS_H
+#define QELOQUENT_QUERYSTATISTICS_H
+
+#include <QEloquent/global.h>
+
+class QJsonArray;
+
+namespace QEloquent {
+
+struct QueryRecord;
+
+/*!
+ * @brief Aggregated execution statistics of a statement fingerprint.
+ *
+ * Durations are in nanoseconds, p95 is estimated from a log2 histogram.
+ */
+struct QueryStatisticsEntry
+{
+    QString fingerprint;
+    qint64 calls = 0;
+    qint64 errors = 0;
+    qint64 totalNs = 0;
+    qint64 minNs = 0;
+    qint64 maxNs = 0;
+    qint64 p95Ns = 0;
+    qint64 rows = 0;
+
+    qint64 meanNs() const
+    { return (calls > 0 ? totalNs / calls : 0); }
+};
+
+class QELOQUENT_EXPORT QueryStatistics
+{
+public:
+    static void enable();
+    static void disable();
+    static bool isEnabled();
+
+    static void record(const QueryRecord &record);
+
+    static QList<QueryStatisticsEntry> entries();
+    static QJsonArray toJson();
+    static void reset();
+
+    static QString fingerprint(const QString &statement);
+};
+
+} // namespace QEloquent
+
+#endif // QELOQUENT_QUERYSTATISTICS_H
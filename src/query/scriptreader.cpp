@@ -0,0 +1,569 @@
+#include "scriptreader.h"
+
+#include <QFileDevice>
+
+#include <cstring>
+#include <string_view>
+
+// Devices that can't be mapped are read by chunks of this size
+#define CHUNK_SIZE (256 * 1024)
+
+namespace QEloquent {
+
+class ScriptReaderPrivate
+{
+public:
+    enum ParseResult {
+        StatementStarted,
+        StatementRead,
+        NeedMoreData,
+        EndOfData,
+        ParseError
+    };
+
+    enum State {
+        Code,
+        SingleQuote,
+        DoubleQuote,
+        Backtick,
+        LineComment,
+        BlockComment,
+        DollarQuote
+    };
+
+    ParseResult startStatement();
+    ParseResult parseStatement(qsizetype *begin, qsizetype *length);
+    void processWord(const char *begin, const char *end);
+    ParseResult fail(const QString &what);
+    bool fill();
+
+    static bool isSpace(char c)
+    { return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v'; }
+
+    static bool isWord(char c)
+    { return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_' || uchar(c) >= 0x80; }
+
+    static bool isKeyword(const char *begin, qsizetype length, const char *keyword)
+    { return length == qsizetype(qstrlen(keyword)) && qstrnicmp(begin, keyword, length) == 0; }
+
+    QIODevice *device = nullptr;
+    QFileDevice *mappedFile = nullptr;
+    uchar *map = nullptr;
+    qint64 mapOffset = 0;
+
+    // Current data, either the mapped file, the input content or the chunk buffer
+    QByteArray buffer;
+    const char *data = nullptr;
+    qsizetype size = 0;
+    qsizetype position = 0; // Start of the current statement
+    qsizetype scan = 0;     // Where scanning of the current statement resumes
+    qint64 dropped = 0;     // Bytes consumed and removed from the buffer
+    bool eof = false;
+
+    bool inStatement = false;
+    State state = Code;
+    QByteArray dollarTag;
+    bool compound = false;  // CREATE statement, that may hold BEGIN ... END blocks
+    int depth = 0;
+    bool closing = false;   // Last word was an END closing a block
+    int words = 0;
+
+    QByteArray delimiter = ";";
+    bool backslashEscapes = false;
+    qint64 statements = 0;
+    QString errorString;
+};
+
+// Skips blanks, comments and DELIMITER lines up to the next statement
+ScriptReaderPrivate::ParseResult ScriptReaderPrivate::startStatement()
+{
+    const char *end = data + size;
+
+    // UTF-8 byte order mark
+    if (dropped + position == 0) {
+        if (size < 3 && !eof)
+            return NeedMoreData;
+        if (size >= 3 && std::memcmp(data, "\xEF\xBB\xBF", 3) == 0)
+            position = 3;
+    }
+
+    while (true) {
+        const char *p = data + position;
+        while (p < end && isSpace(*p))
+            ++p;
+        position = p - data;
+
+        const qsizetype remaining = end - p;
+        if (remaining == 0)
+            return (eof ? EndOfData : NeedMoreData);
+
+        // Comments need two bytes to be told apart from code
+        if (remaining < 2 && !eof)
+            return NeedMoreData;
+
+        if (remaining >= 2 && p[0] == '-' && p[1] == '-') {
+            const char *lineEnd = static_cast<const char *>(std::memchr(p, '\n', remaining));
+            if (!lineEnd && !eof)
+                return NeedMoreData;
+            position = (lineEnd ? lineEnd + 1 : end) - data;
+            continue;
+        }
+
+        if (remaining >= 2 && p[0] == '/' && p[1] == '*') {
+            const size_t close = std::string_view(p + 2, remaining - 2).find("*/");
+            if (close == std::string_view::npos)
+                return (eof ? fail("comment") : NeedMoreData);
+            position += 2 + close + 2;
+            continue;
+        }
+
+        // DELIMITER lines change the statement terminator, as understood by the MySQL client
+        const qsizetype keywordSize = 9;
+        if (qstrnicmp(p, "DELIMITER", qMin(remaining, keywordSize)) == 0) {
+            if (remaining <= keywordSize && !eof)
+                return NeedMoreData;
+
+            if (remaining > keywordSize && (p[keywordSize] == ' ' || p[keywordSize] == '\t')) {
+                const char *lineEnd = static_cast<const char *>(std::memchr(p, '\n', remaining));
+                if (!lineEnd && !eof)
+                    return NeedMoreData;
+                if (!lineEnd)
+                    lineEnd = end;
+
+                const QByteArray delimiter = QByteArray(p + keywordSize, lineEnd - p - keywordSize).trimmed();
+                if (delimiter.isEmpty()) {
+                    errorString = QStringLiteral("Missing delimiter after statement %1").arg(statements);
+                    return ParseError;
+                }
+
+                this->delimiter = delimiter;
+                position = lineEnd - data;
+                continue;
+            }
+        }
+
+        inStatement = true;
+        scan = position;
+        state = Code;
+        compound = false;
+        depth = 0;
+        closing = false;
+        words = 0;
+        return StatementStarted;
+    }
+}
+
+// Finds the end of the current statement, scanning state is kept across refills so data is only scanned once
+ScriptReaderPrivate::ParseResult ScriptReaderPrivate::parseStatement(qsizetype *begin, qsizetype *length)
+{
+    if (!inStatement) {
+        const ParseResult result = startStatement();
+        if (result != StatementStarted)
+            return result;
+    }
+
+    const char *end = data + size;
+    const char *p = data + scan;
+
+    while (p < end) {
+        switch (state) {
+        case Code: {
+            const char c = *p;
+
+            if (c == delimiter.at(0)) {
+                closing = false;
+
+                if (end - p < delimiter.size() && !eof) {
+                    scan = p - data;
+                    return NeedMoreData;
+                }
+
+                // Semicolons inside BEGIN ... END blocks belong to the block, custom delimiters always end statements
+                const std::string_view expected(delimiter.constData(), delimiter.size());
+                if (std::string_view(p, end - p).substr(0, expected.size()) == expected && (depth == 0 || delimiter != ";")) {
+                    *begin = position;
+                    *length = p - data - position;
+                    position = scan = p - data + delimiter.size();
+                    inStatement = false;
+                    return StatementRead;
+                }
+            }
+
+            if (c == '\'') {
+                state = SingleQuote;
+                ++p;
+            } else if (c == '"') {
+                state = DoubleQuote;
+                ++p;
+            } else if (c == '`') {
+                state = Backtick;
+                ++p;
+            } else if (c == '-' || c == '/') {
+                if (p + 1 == end && !eof) {
+                    scan = p - data;
+                    return NeedMoreData;
+                }
+
+                if (p + 1 < end && c == '-' && p[1] == '-') {
+                    state = LineComment;
+                    p += 2;
+                } else if (p + 1 < end && c == '/' && p[1] == '*') {
+                    state = BlockComment;
+                    p += 2;
+                } else {
+                    ++p;
+                }
+            } else if (c == '$') {
+                // PostgreSQL dollar quoting, $1 style parameters aside
+                const char *q = p + 1;
+                while (q < end && isWord(*q))
+                    ++q;
+                if (q == end && !eof) {
+                    scan = p - data;
+                    return NeedMoreData;
+                }
+
+                if (q < end && *q == '$' && !(q > p + 1 && p[1] >= '0' && p[1] <= '9')) {
+                    dollarTag = QByteArray(p, q - p + 1);
+                    state = DollarQuote;
+                    p = q + 1;
+                } else {
+                    ++p;
+                }
+            } else if (isWord(c)) {
+                const char *q = p + 1;
+                while (q < end && isWord(*q))
+                    ++q;
+                if (q == end && !eof) {
+                    scan = p - data;
+                    return NeedMoreData;
+                }
+
+                processWord(p, q);
+                p = q;
+            } else {
+                ++p;
+            }
+            break;
+        }
+
+        case SingleQuote:
+        case DoubleQuote:
+        case Backtick: {
+            // Doubled quotes just close and reopen the literal
+            const char quote = (state == SingleQuote ? '\'' : (state == DoubleQuote ? '"' : '`'));
+            const char *close = static_cast<const char *>(std::memchr(p, quote, end - p));
+
+            // MySQL string escapes, the byte after a backslash never closes the literal
+            if (backslashEscapes && state != Backtick) {
+                const char *escape = static_cast<const char *>(std::memchr(p, '\\', (close ? close : end) - p));
+                if (escape) {
+                    if (escape + 1 == end && !eof) {
+                        scan = escape - data;
+                        return NeedMoreData;
+                    }
+
+                    p = qMin(escape + 2, end);
+                    break;
+                }
+            }
+
+            if (close) {
+                state = Code;
+                p = close + 1;
+            } else {
+                p = end;
+            }
+            break;
+        }
+
+        case LineComment: {
+            const char *lineEnd = static_cast<const char *>(std::memchr(p, '\n', end - p));
+            if (lineEnd) {
+                state = Code;
+                p = lineEnd + 1;
+            } else {
+                p = end;
+            }
+            break;
+        }
+
+        case BlockComment:
+        case DollarQuote: {
+            const std::string_view closing = (state == BlockComment ? std::string_view("*/") : std::string_view(dollarTag.constData(), dollarTag.size()));
+            const size_t close = std::string_view(p, end - p).find(closing);
+            if (close != std::string_view::npos) {
+                state = Code;
+                p += close + closing.size();
+                break;
+            }
+
+            if (eof) {
+                p = end;
+                break;
+            }
+
+            // The closing sequence may be split across chunks
+            scan = qMax<qsizetype>(p - data, size - qsizetype(closing.size()) + 1);
+            return NeedMoreData;
+        }
+        }
+    }
+
+    scan = size;
+    if (!eof)
+        return NeedMoreData;
+
+    switch (state) {
+    case SingleQuote:
+    case DoubleQuote:
+    case Backtick:
+    case DollarQuote:
+        return fail("literal");
+
+    case BlockComment:
+        return fail("comment");
+
+    default:
+        break;
+    }
+
+    // Last statement, without delimiter
+    *begin = position;
+    *length = size - position;
+    position = size;
+    inStatement = false;
+    return StatementRead;
+}
+
+void ScriptReaderPrivate::processWord(const char *begin, const char *end)
+{
+    const qsizetype length = end - begin;
+
+    if (words++ == 0) {
+        compound = (length == 6 && qstrnicmp(begin, "CREATE", 6) == 0);
+        return;
+    }
+
+    // Only CREATE statements (triggers, procedures) hold blocks, a leading BEGIN starts a transaction
+    if (!compound || delimiter != ";")
+        return;
+
+    // END IF, END LOOP, END WHILE and END REPEAT close constructs which opened no block, END CASE closes the CASE one
+    if (closing) {
+        closing = false;
+
+        if (isKeyword(begin, length, "IF") || isKeyword(begin, length, "LOOP")
+            || isKeyword(begin, length, "WHILE") || isKeyword(begin, length, "REPEAT")) {
+            ++depth;
+            return;
+        }
+
+        if (isKeyword(begin, length, "CASE"))
+            return;
+    }
+
+    if (isKeyword(begin, length, "BEGIN")) {
+        ++depth;
+    } else if (depth > 0) {
+        if (isKeyword(begin, length, "CASE")) {
+            ++depth;
+        } else if (isKeyword(begin, length, "END")) {
+            --depth;
+            closing = true;
+        }
+    }
+}
+
+ScriptReaderPrivate::ParseResult ScriptReaderPrivate::fail(const QString &what)
+{
+    errorString = QStringLiteral("Unterminated %1 in statement %2").arg(what).arg(statements + 1);
+    return ParseError;
+}
+
+bool ScriptReaderPrivate::fill()
+{
+    if (!device || map) {
+        eof = true;
+        return true;
+    }
+
+    // Consumed data is dropped before reading more, the current statement is kept
+    if (position > 0) {
+        buffer.remove(0, position);
+        dropped += position;
+        scan -= position;
+        position = 0;
+    }
+
+    const qsizetype current = buffer.size();
+    buffer.resize(current + CHUNK_SIZE);
+    const qint64 read = device->read(buffer.data() + current, CHUNK_SIZE);
+    if (read < 0) {
+        buffer.resize(current);
+        errorString = device->errorString();
+        return false;
+    }
+
+    buffer.resize(current + read);
+    data = buffer.constData();
+    size = buffer.size();
+
+    // Sequential devices may just have nothing available yet
+    if (read == 0 && (!device->isSequential() || device->atEnd() || !device->waitForReadyRead(30000)))
+        eof = true;
+    return true;
+}
+
+/*!
+ * @class QEloquent::ScriptReader
+ * @brief Streaming SQL script splitter.
+ *
+ * Statements are split on their delimiter, ignoring the ones in string literals, quoted identifiers, comments,
+ * PostgreSQL dollar quoted bodies and BEGIN ... END blocks of CREATE statements (triggers, procedures).
+ * MySQL client style DELIMITER lines are honored, statements then only end with the new delimiter.
+ * Backslash escapes in string literals are only understood once enabled by setBackslashEscapes().
+ *
+ * Files are memory mapped when possible, other devices are read by chunks,
+ * memory use being bounded by the chunk and the longest statement.
+ *
+ * @sa QueryRunner::execScript()
+ */
+
+ScriptReader::ScriptReader(QIODevice *device)
+    : d(new ScriptReaderPrivate())
+{
+    d->device = device;
+
+    // Files are mapped from their current position, falling back to chunked reads
+    QFileDevice *file = qobject_cast<QFileDevice *>(device);
+    if (file && file->isReadable() && !file->isSequential()) {
+        const qint64 offset = file->pos();
+        const qint64 size = file->size() - offset;
+        if (size > 0)
+            d->map = file->map(offset, size);
+
+        if (d->map) {
+            d->mappedFile = file;
+            d->mapOffset = offset;
+            d->data = reinterpret_cast<const char *>(d->map);
+            d->size = size;
+            d->eof = true;
+        }
+    }
+}
+
+ScriptReader::ScriptReader(const QByteArray &content)
+    : d(new ScriptReaderPrivate())
+{
+    d->buffer = content;
+    d->data = d->buffer.constData();
+    d->size = d->buffer.size();
+    d->eof = true;
+}
+
+ScriptReader::~ScriptReader()
+{
+    if (d->map) {
+        // The device is left after the consumed data, as if it had been read
+        d->mappedFile->unmap(d->map);
+        d->mappedFile->seek(d->mapOffset + d->position);
+    }
+}
+
+/*!
+ * @brief Reads the next statement, without its delimiter, returns false at the end of data or on error.
+ */
+bool ScriptReader::readStatement(QString *statement)
+{
+    if (!d->errorString.isEmpty())
+        return false;
+
+    while (true) {
+        qsizetype begin;
+        qsizetype length;
+
+        switch (d->parseStatement(&begin, &length)) {
+        case ScriptReaderPrivate::StatementRead:
+            *statement = QString::fromUtf8(d->data + begin, length).trimmed();
+            if (statement->isEmpty())
+                continue; // Lone delimiter
+            ++d->statements;
+            return true;
+
+        case ScriptReaderPrivate::NeedMoreData:
+            if (!d->fill())
+                return false;
+            break;
+
+        case ScriptReaderPrivate::StatementStarted:
+            break;
+
+        case ScriptReaderPrivate::EndOfData:
+        case ScriptReaderPrivate::ParseError:
+            return false;
+        }
+    }
+}
+
+/*!
+ * @brief Returns the number of statements read so far.
+ */
+qint64 ScriptReader::statementNumber() const
+{
+    return d->statements;
+}
+
+/*!
+ * @brief Returns the number of bytes consumed, up to the end of the last statement read.
+ */
+qint64 ScriptReader::bytesRead() const
+{
+    return d->dropped + d->position;
+}
+
+/*!
+ * @brief Returns the current statement delimiter, ";" unless changed by a DELIMITER line.
+ */
+QByteArray ScriptReader::delimiter() const
+{
+    return d->delimiter;
+}
+
+/*!
+ * @brief Returns true if backslashes escape the next character of string literals, as on MySQL.
+ */
+bool ScriptReader::backslashEscapes() const
+{
+    return d->backslashEscapes;
+}
+
+/*!
+ * @brief Makes backslashes escape the next character of string literals when \a enabled, off by default.
+ *
+ * Quoted identifiers aren't affected. Standard SQL, SQLite and PostgreSQL treat backslashes as plain characters.
+ */
+void ScriptReader::setBackslashEscapes(bool enabled)
+{
+    d->backslashEscapes = enabled;
+}
+
+/*!
+ * @brief Returns true if data is read from a memory mapped file.
+ */
+bool ScriptReader::isMapped() const
+{
+    return d->map != nullptr;
+}
+
+bool ScriptReader::hasError() const
+{
+    return !d->errorString.isEmpty();
+}
+
+QString ScriptReader::errorString() const
+{
+    return d->errorString;
+}
+
+} // namespace QEloquent
@@ -0,0 +1,41 @@
+#ifndef QELOQUENT_SCRIPTREADER_H
+#define QELOQUENT_SCRIPTREADER_H
+
+#include <QEloquent/global.h>
+
+#include <QScopedPointer>
+
+class QIODevice;
+
+namespace QEloquent {
+
+class ScriptReaderPrivate;
+class QELOQUENT_EXPORT ScriptReader
+{
+public:
+    explicit ScriptReader(QIODevice *device);
+    explicit ScriptReader(const QByteArray &content);
+    ~ScriptReader();
+
+    bool readStatement(QString *statement);
+    qint64 statementNumber() const;
+    qint64 bytesRead() const;
+
+    QByteArray delimiter() const;
+    bool isMapped() const;
+
+    bool backslashEscapes() const;
+    void setBackslashEscapes(bool enabled);
+
+    bool hasError() const;
+    QString errorString() const;
+
+private:
+    Q_DISABLE_COPY(ScriptReader)
+
+    QScopedPointer<ScriptReaderPrivate> d;
+};
+
+} // namespace QEloquent
+
+#endif // QELOQUENT_SCRIPTREADER_H
@@ -0,0 +1,245 @@
+#include "slowquerylog.h"
+
+#include <QEloquent/connection.h>
+#include <QEloquent/driver.h>
+#include <QEloquent/querybuilder.h>
+
+#include <QSqlQuery>
+#include <QSqlRecord>
+#include <QHash>
+#include <QMutex>
+#include <QDebug>
+
+#define MAX_RECORDS 128
+
+namespace QEloquent {
+
+struct SlowQueryLogData
+{
+    QMutex mutex;
+    int listenerId = -1;
+    qint64 thresholdNs = 0;
+    int largeTableRows = 1000;
+    SlowQueryHandler handler;
+    QList<SlowQueryRecord> records;
+
+    // Table row counts by connection then table, estimated once
+    QHash<QString, QHash<QString, qint64>> tableRows;
+};
+
+static SlowQueryLogData &logData()
+{
+    static SlowQueryLogData data;
+    return data;
+}
+
+// Reads the server statistics estimate, falling back to counting the table once per log lifetime
+static qint64 tableRows(const QString &table, const Connection &connection)
+{
+    {
+        SlowQueryLogData &d = logData();
+        QMutexLocker locker(&d.mutex);
+        const QHash<QString, qint64> &rows = d.tableRows.value(connection.name());
+        if (rows.contains(table))
+            return rows.value(table);
+    }
+
+    qint64 count = -1;
+
+    const QString estimateStatement = connection.driver()->tableRowsEstimateStatement(table);
+    if (!estimateStatement.isEmpty()) {
+        QSqlQuery query(connection.database());
+        query.setForwardOnly(true);
+        if (query.exec(estimateStatement) && query.next() && !query.isNull(0))
+            count = query.value(0).toLongLong();
+    }
+
+    if (count < 0) {
+        QSqlQuery query(connection.database());
+        query.setForwardOnly(true);
+        if (query.exec("SELECT COUNT(1) FROM " + QueryBuilder::escapeTableName(table, connection)) && query.next())
+            count = query.value(0).toLongLong();
+    }
+
+    SlowQueryLogData &d = logData();
+    QMutexLocker locker(&d.mutex);
+    d.tableRows[connection.name()].insert(table, count);
+    return count;
+}
+
+static void handleRecord(const QueryRecord &record)
+{
+    SlowQueryHandler handler;
+    {
+        SlowQueryLogData &d = logData();
+        QMutexLocker locker(&d.mutex);
+        if (record.totalNs() < d.thresholdNs || !record.success)
+            return;
+        handler = d.handler;
+    }
+
+    const SlowQueryRecord slow = SlowQueryLog::explain(record);
+
+    {
+        SlowQueryLogData &d = logData();
+        QMutexLocker locker(&d.mutex);
+        d.records.append(slow);
+        if (d.records.size() > MAX_RECORDS)
+            d.records.removeFirst();
+    }
+
+    if (handler) {
+        handler(slow);
+        return;
+    }
+
+    qWarning().noquote().nospace()
+        << "Slow query (" << record.totalNs() / 1000000.0 << " ms): " << record.statement
+        << (slow.plan.isEmpty() ? QString() : "\n  plan: " + slow.plan.join("\n        "))
+        << (slow.hasFullScan() ? "\n  full scan of " + slow.fullScans.join(", ") : QString());
+}
+
+/*!
+ * @class QEloquent::SlowQueryLog
+ * @brief Captures the execution plan of statements running longer than a threshold.
+ *
+ * Plans are obtained by running the driver's explain statement on the connection which ran the statement,
+ * unless that connection is in a transaction: nothing is run then, so a failing explain can't abort the caller's work.
+ * Full scans of tables having at least largeTableRows() rows are flagged, row counts coming from the server
+ * statistics (see Driver::tableRowsEstimateStatement()) or, when it has none, from counting the table once.
+ * Without a handler, slow queries are reported using qWarning().
+ */
+
+/*!
+ * @brief Starts watching statements taking \a thresholdNs nanoseconds or more, by listening to QueryRunner.
+ */
+void SlowQueryLog::enable(qint64 thresholdNs, const SlowQueryHandler &handler)
+{
+    SlowQueryLogData &d = logData();
+    QMutexLocker locker(&d.mutex);
+    d.thresholdNs = thresholdNs;
+    d.handler = handler;
+    if (d.listenerId < 0)
+        d.listenerId = QueryRunner::addListener(&handleRecord);
+}
+
+void SlowQueryLog::disable()
+{
+    SlowQueryLogData &d = logData();
+    QMutexLocker locker(&d.mutex);
+    if (d.listenerId >= 0) {
+        QueryRunner::removeListener(d.listenerId);
+        d.listenerId = -1;
+    }
+}
+
+bool SlowQueryLog::isEnabled()
+{
+    SlowQueryLogData &d = logData();
+    QMutexLocker locker(&d.mutex);
+    return d.listenerId >= 0;
+}
+
+qint64 SlowQueryLog::threshold()
+{
+    SlowQueryLogData &d = logData();
+    QMutexLocker locker(&d.mutex);
+    return d.thresholdNs;
+}
+
+int SlowQueryLog::largeTableRows()
+{
+    SlowQueryLogData &d = logData();
+    QMutexLocker locker(&d.mutex);
+    return d.largeTableRows;
+}
+
+/*!
+ * @brief Sets the row count from which a fully scanned table is flagged, 0 flags every full scan.
+ */
+void SlowQueryLog::setLargeTableRows(int rows)
+{
+    SlowQueryLogData &d = logData();
+    QMutexLocker locker(&d.mutex);
+    d.largeTableRows = rows;
+}
+
+/*!
+ * @brief Returns the most recent slow queries, oldest first.
+ */
+QList<SlowQueryRecord> SlowQueryLog::records()
+{
+    SlowQueryLogData &d = logData();
+    QMutexLocker locker(&d.mutex);
+    return d.records;
+}
+
+/*!
+ * @brief Forgets the recorded slow queries and the known table row counts.
+ */
+void SlowQueryLog::clear()
+{
+    SlowQueryLogData &d = logData();
+    QMutexLocker locker(&d.mutex);
+    d.records.clear();
+    d.tableRows.clear();
+}
+
+/*!
+ * @brief Runs the explain statement for \a record on its connection and returns the annotated record.
+ *
+ * Only data manipulation statements are explained, queries are run directly to not notify listeners again.
+ * Statements run inside a transaction begun with Connection::beginTransaction() are returned without plan.
+ */
+SlowQueryRecord SlowQueryLog::explain(const QueryRecord &record)
+{
+    SlowQueryRecord slow;
+    slow.query = record;
+
+    const QString statement = record.statement.trimmed();
+    static const QStringList explainable = { "SELECT", "UPDATE", "DELETE", "INSERT", "WITH" };
+    const QString keyword = statement.section(' ', 0, 0).toUpper();
+    if (!explainable.contains(keyword))
+        return slow;
+
+    Connection connection = Connection::connection(record.connectionName);
+    const Driver *driver = connection.driver();
+    if (!driver || connection.isInTransaction())
+        return slow;
+
+    const QString explainStatement = driver->explainStatement(statement);
+    if (explainStatement.isEmpty())
+        return slow;
+
+    QSqlQuery query(connection.database());
+    query.setForwardOnly(true);
+    if (!query.exec(explainStatement))
+        return slow;
+
+    QStringList scannedTables;
+    while (query.next()) {
+        const QSqlRecord row = query.record();
+
+        if (row.contains("detail")) {
+            slow.plan.append(row.value("detail").toString());
+        } else {
+            QStringList values;
+            for (int i(0); i < row.count(); ++i)
+                values.append(row.value(i).toString());
+            slow.plan.append(values.join(" | "));
+        }
+
+        const QString table = driver->fullScanTable(row);
+        if (!table.isEmpty() && !scannedTables.contains(table))
+            scannedTables.append(table);
+    }
+
+    const int largeTableRows = SlowQueryLog::largeTableRows();
+    for (const QString &table : std::as_const(scannedTables))
+        if (largeTableRows <= 0 || tableRows(table, connection) >= largeTableRows)
+            slow.fullScans.append(table);
+
+    return slow;
+}
+
+} // namespace QEloquent
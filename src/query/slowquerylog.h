@@ -0,0 +1,46 @@
+#ifndef QELOQUENT_SLOWQUERYLOG_H
+#define QELOQUENT_SLOWQUERYLOG_H
+
+#include <QEloquent/global.h>
+#include <QEloquent/queryrunner.h>
+
+#include <functional>
+
+namespace QEloquent {
+
+/*!
+ * @brief Statement that crossed the slow query threshold, with its execution plan.
+ */
+struct SlowQueryRecord
+{
+    QueryRecord query;
+    QStringList plan;
+    QStringList fullScans;
+
+    bool hasFullScan() const
+    { return !fullScans.isEmpty(); }
+};
+
+typedef std::function<void (const SlowQueryRecord &record)> SlowQueryHandler;
+
+class QELOQUENT_EXPORT SlowQueryLog
+{
+public:
+    static void enable(qint64 thresholdNs, const SlowQueryHandler &handler = nullptr);
+    static void disable();
+    static bool isEnabled();
+
+    static qint64 threshold();
+
+    static int largeTableRows();
+    static void setLargeTableRows(int rows);
+
+    static QList<SlowQueryRecord> records();
+    static void clear();
+
+    static SlowQueryRecord explain(const QueryRecord &record);
+};
+
+} // namespace QEloquent
+
+#endif // QELOQUENT_SLOWQUERYLOG_H
@@ -0,0 +1,50 @@
+#ifndef QELOQUENT_BINARYFORMAT_P_H
+#define QELOQUENT_BINARYFORMAT_P_H
+
+#include <QEloquent/global.h>
+
+#include <QVariant>
+#include <QDateTime>
+#include <QDataStream>
+
+// Layout: magic, version (u16), column count (u16), schema tag (u64), table name (u16 + UTF-8),
+// then per column its type (u8) and name (u16 + UTF-8). Rows follow, each starting with a row marker
+// and a null bitmap, the list ending with an end marker. Integers are little endian.
+#define QELOQUENT_BINARY_MAGIC "QELB"
+#define QELOQUENT_BINARY_VERSION 1
+#define QELOQUENT_BINARY_STREAM_VERSION QDataStream::Qt_6_2
+
+namespace QEloquent::Private {
+
+class BinaryFormat
+{
+public:
+    enum Marker : quint8 {
+        EndMarker = 0,
+        RowMarker = 1
+    };
+
+    static qsizetype bitmapSize(qsizetype columns)
+    { return (columns + 7) / 8; }
+
+    static bool isNull(const QVariant &value)
+    {
+        if (value.isNull())
+            return true;
+
+        switch (value.metaType().id()) {
+        case QMetaType::QDateTime:
+            return !static_cast<const QDateTime *>(value.constData())->isValid();
+        case QMetaType::QDate:
+            return !static_cast<const QDate *>(value.constData())->isValid();
+        case QMetaType::QTime:
+            return !static_cast<const QTime *>(value.constData())->isValid();
+        default:
+            return false;
+        }
+    }
+};
+
+} // namespace QEloquent::Private
+
+#endif // QELOQUENT_BINARYFORMAT_P_H
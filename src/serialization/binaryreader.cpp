@@ -0,0 +1,407 @@
+#include "binaryreader.h"
+
+#include <QEloquent/private/binaryformat_p.h>
+
+#include <QFileDevice>
+#include <QVarLengthArray>
+#include <QTimeZone>
+#include <QtEndian>
+
+#include <cstring>
+
+// Devices that can't be mapped are read by chunks of this size
+#define CHUNK_SIZE (256 * 1024)
+
+namespace QEloquent {
+
+class BinaryReaderPrivate
+{
+public:
+    bool require(qint64 bytes);
+    template<typename T> bool read(T *value);
+    bool readData(const char **data, quint32 *size);
+    bool readText(quint16 size, QString *text);
+    bool readValue(const BinaryColumn &column, QVariant *value);
+
+    QIODevice *device = nullptr;
+    QFileDevice *mappedFile = nullptr;
+    uchar *map = nullptr;
+    qint64 mapOffset = 0;
+
+    // Current data, either the mapped file, the input byte array or the chunk buffer
+    QByteArray buffer;
+    const char *data = nullptr;
+    qint64 size = 0;
+    qint64 position = 0;
+
+    bool headerRead = false;
+    bool atEnd = false;
+    QString tableName;
+    QList<BinaryColumn> columns;
+    quint64 schemaTag = 0;
+    qint64 rows = 0;
+    QString errorString;
+};
+
+// Makes sure \a bytes are available from the current position, refilling the buffer from the device if needed
+bool BinaryReaderPrivate::require(qint64 bytes)
+{
+    if (size - position >= bytes)
+        return true;
+
+    if (device && !map) {
+        // Consumed data is dropped before reading more
+        if (position > 0) {
+            buffer.remove(0, position);
+            position = 0;
+        }
+
+        while (buffer.size() < bytes) {
+            const qsizetype current = buffer.size();
+            const qint64 chunk = qMax<qint64>(CHUNK_SIZE, bytes - current);
+            buffer.resize(current + chunk);
+
+            const qint64 read = device->read(buffer.data() + current, chunk);
+            if (read < 0) {
+                buffer.resize(current);
+                errorString = device->errorString();
+                return false;
+            }
+
+            buffer.resize(current + read);
+
+            // Sequential devices may just have nothing available yet
+            if (read == 0 && (!device->isSequential() || device->atEnd() || !device->waitForReadyRead(30000)))
+                break;
+        }
+
+        data = buffer.constData();
+        size = buffer.size();
+
+        if (size >= bytes)
+            return true;
+    }
+
+    errorString = QStringLiteral("Truncated binary data at row %1").arg(rows + 1);
+    return false;
+}
+
+template<typename T>
+bool BinaryReaderPrivate::read(T *value)
+{
+    if (!require(sizeof(T)))
+        return false;
+
+    *value = qFromLittleEndian<T>(data + position);
+    position += sizeof(T);
+    return true;
+}
+
+// Points \a data to a length prefixed block, valid until the next read
+bool BinaryReaderPrivate::readData(const char **data, quint32 *size)
+{
+    if (!read(size) || !require(*size))
+        return false;
+
+    *data = this->data + position;
+    position += *size;
+    return true;
+}
+
+bool BinaryReaderPrivate::readText(quint16 size, QString *text)
+{
+    if (!require(size))
+        return false;
+
+    *text = QString::fromUtf8(data + position, size);
+    position += size;
+    return true;
+}
+
+bool BinaryReaderPrivate::readValue(const BinaryColumn &column, QVariant *value)
+{
+    switch (column.type) {
+    case BinaryColumn::Bool: {
+        quint8 flag;
+        if (!read(&flag))
+            return false;
+        *value = bool(flag);
+        return true;
+    }
+
+    case BinaryColumn::Integer: {
+        qint64 number;
+        if (!read(&number))
+            return false;
+        *value = number;
+        return true;
+    }
+
+    case BinaryColumn::Unsigned: {
+        quint64 number;
+        if (!read(&number))
+            return false;
+        *value = number;
+        return true;
+    }
+
+    case BinaryColumn::Double: {
+        quint64 bits;
+        if (!read(&bits))
+            return false;
+        double number;
+        std::memcpy(&number, &bits, sizeof(number));
+        *value = number;
+        return true;
+    }
+
+    case BinaryColumn::String: {
+        const char *bytes;
+        quint32 length;
+        if (!readData(&bytes, &length))
+            return false;
+        *value = QString::fromUtf8(bytes, length);
+        return true;
+    }
+
+    case BinaryColumn::Bytes: {
+        const char *bytes;
+        quint32 length;
+        if (!readData(&bytes, &length))
+            return false;
+        *value = QByteArray(bytes, length);
+        return true;
+    }
+
+    case BinaryColumn::DateTime: {
+        qint64 msecs;
+        if (!read(&msecs))
+            return false;
+        *value = QDateTime::fromMSecsSinceEpoch(msecs, QTimeZone::utc());
+        return true;
+    }
+
+    case BinaryColumn::Date: {
+        qint64 julianDay;
+        if (!read(&julianDay))
+            return false;
+        *value = QDate::fromJulianDay(julianDay);
+        return true;
+    }
+
+    case BinaryColumn::Time: {
+        qint32 msecs;
+        if (!read(&msecs))
+            return false;
+        *value = QTime::fromMSecsSinceStartOfDay(msecs);
+        return true;
+    }
+
+    case BinaryColumn::Variant: {
+        const char *bytes;
+        quint32 length;
+        if (!readData(&bytes, &length))
+            return false;
+
+        QDataStream stream(QByteArray::fromRawData(bytes, length));
+        stream.setVersion(QELOQUENT_BINARY_STREAM_VERSION);
+        stream >> *value;
+        if (stream.status() != QDataStream::Ok) {
+            errorString = QStringLiteral("Invalid value for column %1 at row %2").arg(column.name).arg(rows + 1);
+            return false;
+        }
+        return true;
+    }
+    }
+
+    errorString = QStringLiteral("Unknown type for column %1").arg(column.name);
+    return false;
+}
+
+/*!
+ * @class QEloquent::BinaryReader
+ * @brief Reads rows written by BinaryWriter.
+ *
+ * Files are memory mapped when possible, values being decoded straight from the mapping.
+ * Other devices are read by chunks, memory use being bounded by the chunk and the largest row.
+ *
+ * @sa BinaryWriter
+ */
+
+BinaryReader::BinaryReader(QIODevice *device)
+    : d(new BinaryReaderPrivate())
+{
+    d->device = device;
+
+    // Files are mapped from their current position, falling back to chunked reads
+    QFileDevice *file = qobject_cast<QFileDevice *>(device);
+    if (file && file->isReadable() && !file->isSequential()) {
+        const qint64 offset = file->pos();
+        const qint64 size = file->size() - offset;
+        if (size > 0)
+            d->map = file->map(offset, size);
+
+        if (d->map) {
+            d->mappedFile = file;
+            d->mapOffset = offset;
+            d->data = reinterpret_cast<const char *>(d->map);
+            d->size = size;
+        }
+    }
+}
+
+BinaryReader::BinaryReader(const QByteArray &data)
+    : d(new BinaryReaderPrivate())
+{
+    d->buffer = data;
+    d->data = d->buffer.constData();
+    d->size = d->buffer.size();
+}
+
+BinaryReader::~BinaryReader()
+{
+    if (d->map) {
+        // The device is left after the consumed data, as if it had been read
+        d->mappedFile->unmap(d->map);
+        d->mappedFile->seek(d->mapOffset + d->position);
+    }
+}
+
+/*!
+ * @brief Reads and checks the layout, called by readRow() when needed.
+ */
+bool BinaryReader::readHeader()
+{
+    if (d->headerRead)
+        return true;
+
+    if (!d->errorString.isEmpty())
+        return false;
+
+    if (!d->require(4) || std::memcmp(d->data + d->position, QELOQUENT_BINARY_MAGIC, 4) != 0) {
+        d->errorString = QStringLiteral("Not QEloquent binary data");
+        return false;
+    }
+    d->position += 4;
+
+    quint16 version;
+    quint16 columnCount;
+    quint16 length;
+    if (!d->read(&version) || !d->read(&columnCount) || !d->read(&d->schemaTag) || !d->read(&length) || !d->readText(length, &d->tableName))
+        return false;
+
+    if (version != QELOQUENT_BINARY_VERSION) {
+        d->errorString = QStringLiteral("Unsupported binary format version %1").arg(version);
+        return false;
+    }
+
+    d->columns.reserve(columnCount);
+    for (quint16 i(0); i < columnCount; ++i) {
+        quint8 type;
+        BinaryColumn column;
+        if (!d->read(&type) || !d->read(&length) || !d->readText(length, &column.name))
+            return false;
+
+        if (type < BinaryColumn::Bool || type > BinaryColumn::Variant) {
+            d->errorString = QStringLiteral("Unknown type for column %1").arg(column.name);
+            return false;
+        }
+
+        column.type = BinaryColumn::Type(type);
+        d->columns.append(column);
+    }
+
+    if (BinaryWriter::schemaTag(d->tableName, d->columns) != d->schemaTag) {
+        d->errorString = QStringLiteral("Corrupted binary header");
+        return false;
+    }
+
+    d->headerRead = true;
+    return true;
+}
+
+QString BinaryReader::tableName() const
+{
+    return d->tableName;
+}
+
+QList<BinaryColumn> BinaryReader::columns() const
+{
+    return d->columns;
+}
+
+quint64 BinaryReader::schemaTag() const
+{
+    return d->schemaTag;
+}
+
+/*!
+ * @brief Reads the next row into \a values, in column order, returns false at the end of data or on error.
+ */
+bool BinaryReader::readRow(QVariantList *values)
+{
+    if (d->atEnd || !d->errorString.isEmpty() || !readHeader())
+        return false;
+
+    quint8 marker;
+    if (!d->read(&marker))
+        return false;
+
+    if (marker == Private::BinaryFormat::EndMarker) {
+        d->atEnd = true;
+        return false;
+    }
+
+    if (marker != Private::BinaryFormat::RowMarker) {
+        d->errorString = QStringLiteral("Invalid row marker at row %1").arg(d->rows + 1);
+        return false;
+    }
+
+    // Copied, refills invalidate the buffer
+    const qsizetype count = d->columns.size();
+    const qsizetype bitmapSize = Private::BinaryFormat::bitmapSize(count);
+    if (!d->require(bitmapSize))
+        return false;
+    const QVarLengthArray<char, 16> bitmap(d->data + d->position, d->data + d->position + bitmapSize);
+    d->position += bitmapSize;
+
+    values->resize(count);
+    for (qsizetype i(0); i < count; ++i) {
+        QVariant &value = (*values)[i];
+        if (bitmap.at(i / 8) & (1 << (i % 8)))
+            value = QVariant();
+        else if (!d->readValue(d->columns.at(i), &value))
+            return false;
+    }
+
+    ++d->rows;
+    return true;
+}
+
+/*!
+ * @brief Returns the number of rows read so far.
+ */
+qint64 BinaryReader::rowNumber() const
+{
+    return d->rows;
+}
+
+/*!
+ * @brief Returns true if data is read from a memory mapped file.
+ */
+bool BinaryReader::isMapped() const
+{
+    return d->map != nullptr;
+}
+
+bool BinaryReader::hasError() const
+{
+    return !d->errorString.isEmpty();
+}
+
+QString BinaryReader::errorString() const
+{
+    return d->errorString;
+}
+
+} // namespace QEloquent
@@ -0,0 +1,42 @@
+#ifndef QELOQUENT_BINARYREADER_H
+#define QELOQUENT_BINARYREADER_H
+
+#include <QEloquent/global.h>
+#include <QEloquent/binarywriter.h>
+
+#include <QScopedPointer>
+
+class QIODevice;
+
+namespace QEloquent {
+
+class BinaryReaderPrivate;
+class QELOQUENT_EXPORT BinaryReader
+{
+public:
+    explicit BinaryReader(QIODevice *device);
+    explicit BinaryReader(const QByteArray &data);
+    ~BinaryReader();
+
+    bool readHeader();
+    QString tableName() const;
+    QList<BinaryColumn> columns() const;
+    quint64 schemaTag() const;
+
+    bool readRow(QVariantList *values);
+    qint64 rowNumber() const;
+
+    bool isMapped() const;
+
+    bool hasError() const;
+    QString errorString() const;
+
+private:
+    Q_DISABLE_COPY(BinaryReader)
+
+    QScopedPointer<BinaryReaderPrivate> d;
+};
+
+} // namespace QEloquent
+
+#endif // QELOQUENT_BINARYREADER_H
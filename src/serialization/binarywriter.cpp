@@ -0,0 +1,402 @@
+#include "binarywriter.h"
+
+#include <QEloquent/metaobject.h>
+#include <QEloquent/metaproperty.h>
+#include <QEloquent/private/binaryformat_p.h>
+
+#include <QIODevice>
+#include <QDataStream>
+#include <QDateTime>
+#include <QtEndian>
+
+#include <cstring>
+
+// Output to devices is written in chunks of this size
+#define FLUSH_THRESHOLD (64 * 1024)
+
+namespace QEloquent {
+
+class BinaryWriterPrivate
+{
+public:
+    template<typename T> void append(T value);
+    void appendData(const char *data, qsizetype size);
+    bool appendValue(const BinaryColumn &column, const QVariant &value);
+    bool flush();
+
+    QIODevice *device = nullptr;
+    QByteArray buffer;
+    QByteArray *output = nullptr;
+    QList<BinaryColumn> columns;
+    bool headerWritten = false;
+    bool finished = false;
+    qint64 rows = 0;
+    QString errorString;
+};
+
+template<typename T>
+void BinaryWriterPrivate::append(T value)
+{
+    const T le = qToLittleEndian(value);
+    output->append(reinterpret_cast<const char *>(&le), sizeof(T));
+}
+
+void BinaryWriterPrivate::appendData(const char *data, qsizetype size)
+{
+    append(quint32(size));
+    output->append(data, size);
+}
+
+bool BinaryWriterPrivate::appendValue(const BinaryColumn &column, const QVariant &value)
+{
+    switch (column.type) {
+    case BinaryColumn::Bool:
+        output->append(char(value.toBool() ? 1 : 0));
+        return true;
+
+    case BinaryColumn::Integer:
+        append(qint64(value.toLongLong()));
+        return true;
+
+    case BinaryColumn::Unsigned:
+        append(quint64(value.toULongLong()));
+        return true;
+
+    case BinaryColumn::Double: {
+        const double number = value.toDouble();
+        quint64 bits;
+        std::memcpy(&bits, &number, sizeof(bits));
+        append(bits);
+        return true;
+    }
+
+    case BinaryColumn::String: {
+        const QByteArray utf8 = value.toString().toUtf8();
+        appendData(utf8.constData(), utf8.size());
+        return true;
+    }
+
+    case BinaryColumn::Bytes: {
+        const QByteArray data = value.toByteArray();
+        appendData(data.constData(), data.size());
+        return true;
+    }
+
+    case BinaryColumn::DateTime:
+        append(qint64(value.toDateTime().toMSecsSinceEpoch()));
+        return true;
+
+    case BinaryColumn::Date:
+        append(qint64(value.toDate().toJulianDay()));
+        return true;
+
+    case BinaryColumn::Time:
+        append(qint32(value.toTime().msecsSinceStartOfDay()));
+        return true;
+
+    case BinaryColumn::Variant: {
+        QByteArray data;
+        QDataStream stream(&data, QIODevice::WriteOnly);
+        stream.setVersion(QELOQUENT_BINARY_STREAM_VERSION);
+        stream << value;
+        if (stream.status() != QDataStream::Ok) {
+            errorString = "Unable to encode value of column " + column.name;
+            return false;
+        }
+        appendData(data.constData(), data.size());
+        return true;
+    }
+    }
+
+    errorString = "Unknown type for column " + column.name;
+    return false;
+}
+
+bool BinaryWriterPrivate::flush()
+{
+    if (!device || buffer.isEmpty())
+        return errorString.isEmpty();
+
+    if (device->write(buffer) != buffer.size())
+        errorString = device->errorString();
+    buffer.clear();
+    return errorString.isEmpty();
+}
+
+/*!
+ * @class QEloquent::BinaryWriter
+ * @brief Writes rows in a compact binary format, suitable for caches and inter-process transfers.
+ *
+ * The table name and column layout are written once, along with a schema tag identifying them.
+ * Each row then holds a null bitmap followed by the typed values of its non null columns, no key is repeated.
+ * Output goes either to a device, written by chunks, or appended to a byte array.
+ *
+ * @sa BinaryReader
+ */
+
+BinaryWriter::BinaryWriter(QIODevice *device)
+    : d(new BinaryWriterPrivate())
+{
+    d->device = device;
+    d->output = &d->buffer;
+    d->buffer.reserve(FLUSH_THRESHOLD + 1024);
+}
+
+BinaryWriter::BinaryWriter(QByteArray *output)
+    : d(new BinaryWriterPrivate())
+{
+    d->output = output;
+}
+
+BinaryWriter::~BinaryWriter()
+{
+    if (d->headerWritten && !d->finished)
+        finish();
+}
+
+/*!
+ * @brief Writes the layout of the following rows, must be called once before writeRow().
+ */
+bool BinaryWriter::writeHeader(const QString &tableName, const QList<BinaryColumn> &columns)
+{
+    if (d->headerWritten) {
+        d->errorString = QStringLiteral("Binary header already written");
+        return false;
+    }
+
+    if (columns.size() > std::numeric_limits<quint16>::max()) {
+        d->errorString = QStringLiteral("Too many columns");
+        return false;
+    }
+
+    d->output->append(QELOQUENT_BINARY_MAGIC, 4);
+    d->append(quint16(QELOQUENT_BINARY_VERSION));
+    d->append(quint16(columns.size()));
+    d->append(schemaTag(tableName, columns));
+
+    const QByteArray table = tableName.toUtf8();
+    d->append(quint16(table.size()));
+    d->output->append(table);
+
+    for (const BinaryColumn &column : columns) {
+        const QByteArray name = column.name.toUtf8();
+        d->output->append(char(column.type));
+        d->append(quint16(name.size()));
+        d->output->append(name);
+    }
+
+    d->columns = columns;
+    d->headerWritten = true;
+    return true;
+}
+
+/*!
+ * @brief Writes a row, \a values being in column order.
+ *
+ * Values are converted to the column types, null and invalid values are only recorded in the null bitmap.
+ * Nothing of the row is written when a value can't be encoded.
+ */
+bool BinaryWriter::writeRow(const QVariantList &values)
+{
+    if (!d->errorString.isEmpty())
+        return false;
+
+    if (!d->headerWritten || d->finished) {
+        d->errorString = QStringLiteral("Rows must be written between writeHeader() and finish()");
+        return false;
+    }
+
+    const qsizetype count = d->columns.size();
+    if (values.size() != count) {
+        d->errorString = QStringLiteral("Expected %1 values, got %2").arg(count).arg(values.size());
+        return false;
+    }
+
+    // A row failing midway is removed, finish() must not end the data on a partial row
+    const qsizetype rowOffset = d->output->size();
+    const auto discardRow = [this, rowOffset]() {
+        d->output->truncate(rowOffset);
+        return false;
+    };
+
+    d->output->append(char(Private::BinaryFormat::RowMarker));
+
+    // Null bitmap is filled in place once values are known
+    const qsizetype bitmapOffset = d->output->size();
+    d->output->append(Private::BinaryFormat::bitmapSize(count), '\0');
+
+    for (qsizetype i(0); i < count; ++i) {
+        const BinaryColumn &column = d->columns.at(i);
+        QVariant value = values.at(i);
+
+        // Values of the same family, like int for an Integer column, are encoded without conversion
+        if (column.type != BinaryColumn::Variant && !value.isNull() && BinaryColumn::typeFor(value.metaType()) != column.type) {
+            if (!value.convert(BinaryColumn::metaTypeFor(column.type))) {
+                d->errorString = "Unable to convert value of column " + column.name;
+                return discardRow();
+            }
+        }
+
+        if (Private::BinaryFormat::isNull(value)) {
+            (*d->output)[bitmapOffset + i / 8] |= char(1 << (i % 8));
+            continue;
+        }
+
+        if (!d->appendValue(column, value))
+            return discardRow();
+    }
+
+    ++d->rows;
+
+    if (d->device && d->buffer.size() >= FLUSH_THRESHOLD)
+        return d->flush();
+    return true;
+}
+
+/*!
+ * @brief Ends the row list and flushes pending data, readers treat data without an end marker as truncated.
+ */
+bool BinaryWriter::finish()
+{
+    if (d->headerWritten && !d->finished) {
+        d->output->append(char(Private::BinaryFormat::EndMarker));
+        d->finished = true;
+    }
+    return d->flush();
+}
+
+qint64 BinaryWriter::rowCount() const
+{
+    return d->rows;
+}
+
+bool BinaryWriter::hasError() const
+{
+    return !d->errorString.isEmpty();
+}
+
+QString BinaryWriter::errorString() const
+{
+    return d->errorString;
+}
+
+/*!
+ * @brief Returns a tag identifying \a tableName and \a columns, stable across processes and runs.
+ *
+ * Readers compare it to the layout they expect, a model change invalidates cached data.
+ */
+quint64 BinaryWriter::schemaTag(const QString &tableName, const QList<BinaryColumn> &columns)
+{
+    // FNV-1a, qHash() being seeded per process
+    quint64 hash = 14695981039346656037ULL;
+    const auto feed = [&hash](const QByteArray &data) {
+        for (const char c : data) {
+            hash ^= quint8(c);
+            hash *= 1099511628211ULL;
+        }
+        hash ^= 0xFF; // Separator
+        hash *= 1099511628211ULL;
+    };
+
+    feed(tableName.toUtf8());
+    for (const BinaryColumn &column : columns)
+        feed(char(column.type) + column.name.toUtf8());
+    return hash;
+}
+
+/*!
+ * @brief Returns binary columns matching \a properties, by field name.
+ */
+QList<BinaryColumn> BinaryWriter::columns(const QList<MetaProperty> &properties)
+{
+    QList<BinaryColumn> columns;
+    columns.reserve(properties.size());
+    for (const MetaProperty &property : properties)
+        columns.append({ property.fieldName(), BinaryColumn::typeFor(property.metaType()) });
+    return columns;
+}
+
+/*!
+ * @brief Returns the stored properties of \a metaObject, hidden ones included.
+ */
+QList<MetaProperty> BinaryWriter::defaultProperties(const MetaObject &metaObject)
+{
+    return metaObject.properties(
+        MetaProperty::PrimaryProperty | MetaProperty::LabelProperty | MetaProperty::FillableProperty | MetaProperty::HiddenProperty |
+        MetaProperty::CreationTimestamp | MetaProperty::UpdateTimestamp | MetaProperty::DeletionTimestamp,
+        MetaObject::StandardProperties);
+}
+
+BinaryColumn::Type BinaryColumn::typeFor(QMetaType metaType)
+{
+    switch (metaType.id()) {
+    case QMetaType::Bool:
+        return Bool;
+
+    case QMetaType::Char:
+    case QMetaType::SChar:
+    case QMetaType::Short:
+    case QMetaType::Int:
+    case QMetaType::Long:
+    case QMetaType::LongLong:
+        return Integer;
+
+    case QMetaType::UChar:
+    case QMetaType::UShort:
+    case QMetaType::UInt:
+    case QMetaType::ULong:
+    case QMetaType::ULongLong:
+        return Unsigned;
+
+    case QMetaType::Float:
+    case QMetaType::Double:
+        return Double;
+
+    case QMetaType::QString:
+        return String;
+
+    case QMetaType::QByteArray:
+        return Bytes;
+
+    case QMetaType::QDateTime:
+        return DateTime;
+
+    case QMetaType::QDate:
+        return Date;
+
+    case QMetaType::QTime:
+        return Time;
+
+    default:
+        return Variant;
+    }
+}
+
+QMetaType BinaryColumn::metaTypeFor(Type type)
+{
+    switch (type) {
+    case Bool:
+        return QMetaType::fromType<bool>();
+    case Integer:
+        return QMetaType::fromType<qint64>();
+    case Unsigned:
+        return QMetaType::fromType<quint64>();
+    case Double:
+        return QMetaType::fromType<double>();
+    case String:
+        return QMetaType::fromType<QString>();
+    case Bytes:
+        return QMetaType::fromType<QByteArray>();
+    case DateTime:
+        return QMetaType::fromType<QDateTime>();
+    case Date:
+        return QMetaType::fromType<QDate>();
+    case Time:
+        return QMetaType::fromType<QTime>();
+    case Variant:
+        break;
+    }
+    return QMetaType();
+}
+
+} // namespace QEloquent
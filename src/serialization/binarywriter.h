@@ -0,0 +1,73 @@
+#ifndef QELOQUENT_BINARYWRITER_H
+#define QELOQUENT_BINARYWRITER_H
+
+#include <QEloquent/global.h>
+
+#include <QScopedPointer>
+#include <QMetaType>
+
+class QIODevice;
+
+namespace QEloquent {
+
+class MetaObject;
+class MetaProperty;
+
+/*!
+ * @brief Column of the binary row format, values are stored according to their type.
+ */
+struct BinaryColumn
+{
+    enum Type : quint8 {
+        Bool = 1,
+        Integer,    // 64 bits signed
+        Unsigned,   // 64 bits unsigned
+        Double,
+        String,     // UTF-8
+        Bytes,
+        DateTime,   // Milliseconds since epoch, UTC
+        Date,       // Julian day
+        Time,       // Milliseconds since midnight
+        Variant     // QDataStream encoded QVariant
+    };
+
+    QString name;
+    Type type = Variant;
+
+    bool operator==(const BinaryColumn &other) const
+    { return type == other.type && name == other.name; }
+
+    static Type typeFor(QMetaType metaType);
+    static QMetaType metaTypeFor(Type type);
+};
+
+class BinaryWriterPrivate;
+class QELOQUENT_EXPORT BinaryWriter
+{
+public:
+    explicit BinaryWriter(QIODevice *device);
+    explicit BinaryWriter(QByteArray *output);
+    ~BinaryWriter();
+
+    bool writeHeader(const QString &tableName, const QList<BinaryColumn> &columns);
+    bool writeRow(const QVariantList &values);
+    bool finish();
+
+    qint64 rowCount() const;
+
+    bool hasError() const;
+    QString errorString() const;
+
+    static quint64 schemaTag(const QString &tableName, const QList<BinaryColumn> &columns);
+    static QList<BinaryColumn> columns(const QList<MetaProperty> &properties);
+    static QList<MetaProperty> defaultProperties(const MetaObject &metaObject);
+
+private:
+    Q_DISABLE_COPY(BinaryWriter)
+
+    QScopedPointer<BinaryWriterPrivate> d;
+};
+
+} // namespace QEloquent
+
+#endif // QELOQUENT_BINARYWRITER_H
@@ -0,0 +1,246 @@
+#include "csvreader.h"
+
+#include <QIODevice>
+
+#include <cstring>
+
+#ifdef __SSE2__
+#   include <emmintrin.h>
+#endif
+
+// Device is read by chunks of this size
+#define CHUNK_SIZE (256 * 1024)
+
+namespace QEloquent {
+
+class CsvReaderPrivate
+{
+public:
+    enum ParseResult {
+        RowParsed,
+        NeedMoreData,
+        ParseError
+    };
+
+    ParseResult parseRow(QByteArrayList *fields);
+    bool fill();
+
+    const char *scan(const char *begin, const char *end) const;
+
+    QIODevice *device = nullptr;
+    CsvOptions options;
+    QByteArray buffer;
+    qsizetype position = 0;
+    bool eof = false;
+    qint64 records = 0;
+    QString errorString;
+};
+
+// Finds the first separator or line break, 16 bytes at a time where SSE2 is available
+const char *CsvReaderPrivate::scan(const char *begin, const char *end) const
+{
+    const char separator = options.separator;
+    const char *p = begin;
+
+#ifdef __SSE2__
+    const __m128i separators = _mm_set1_epi8(separator);
+    const __m128i lineFeeds = _mm_set1_epi8('\n');
+    const __m128i carriageReturns = _mm_set1_epi8('\r');
+
+    while (end - p >= 16) {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+        const __m128i matches = _mm_or_si128(_mm_cmpeq_epi8(chunk, separators),
+                                             _mm_or_si128(_mm_cmpeq_epi8(chunk, lineFeeds),
+                                                          _mm_cmpeq_epi8(chunk, carriageReturns)));
+        const int mask = _mm_movemask_epi8(matches);
+        if (mask)
+            return p + qCountTrailingZeroBits(uint(mask));
+        p += 16;
+    }
+#endif
+
+    for (; p < end; ++p)
+        if (*p == separator || *p == '\n' || *p == '\r')
+            return p;
+    return end;
+}
+
+// Parses a row from the current position, nothing is consumed unless the row is complete
+CsvReaderPrivate::ParseResult CsvReaderPrivate::parseRow(QByteArrayList *fields)
+{
+    const char *data = buffer.constData();
+    const char *end = data + buffer.size();
+    const char *p = data + position;
+
+    fields->clear();
+
+    while (true) {
+        QByteArray field;
+
+        if (p < end && *p == '"') {
+            // Quoted field, quotes are doubled inside
+            ++p;
+            while (true) {
+                const char *quote = static_cast<const char *>(std::memchr(p, '"', end - p));
+                if (!quote) {
+                    if (!eof)
+                        return NeedMoreData;
+                    errorString = QStringLiteral("Unterminated quoted field at record %1").arg(records + 1);
+                    return ParseError;
+                }
+
+                field.append(p, quote - p);
+                p = quote + 1;
+
+                if (p == end && !eof)
+                    return NeedMoreData;
+
+                if (p < end && *p == '"') {
+                    field.append('"');
+                    ++p;
+                    continue;
+                }
+                break;
+            }
+
+            // Lenient about characters between the closing quote and the delimiter
+            const char *delimiter = scan(p, end);
+            field.append(p, delimiter - p);
+            p = delimiter;
+        } else {
+            const char *delimiter = scan(p, end);
+            field = QByteArray(p, delimiter - p);
+            p = delimiter;
+        }
+
+        if (p == end && !eof)
+            return NeedMoreData;
+
+        fields->append(field);
+
+        if (p == end)
+            break;
+
+        if (*p == options.separator) {
+            ++p;
+            continue;
+        }
+
+        if (*p == '\r') {
+            ++p;
+            if (p == end && !eof)
+                return NeedMoreData;
+            if (p < end && *p == '\n')
+                ++p;
+        } else {
+            ++p; // '\n'
+        }
+        break;
+    }
+
+    position = p - data;
+    return RowParsed;
+}
+
+bool CsvReaderPrivate::fill()
+{
+    // Consumed data is dropped before reading more
+    if (position > 0) {
+        buffer.remove(0, position);
+        position = 0;
+    }
+
+    const qsizetype size = buffer.size();
+    buffer.resize(size + CHUNK_SIZE);
+    const qint64 read = device->read(buffer.data() + size, CHUNK_SIZE);
+    if (read < 0) {
+        buffer.resize(size);
+        errorString = device->errorString();
+        return false;
+    }
+
+    buffer.resize(size + read);
+
+    // Sequential devices may just have nothing available yet
+    if (read == 0 && (!device->isSequential() || device->atEnd() || !device->waitForReadyRead(30000)))
+        eof = true;
+    return true;
+}
+
+/*!
+ * @class QEloquent::CsvReader
+ * @brief Streaming CSV reader, understanding RFC 4180 quoting.
+ *
+ * The device is read by chunks, memory use is bounded by the chunk and the longest row.
+ * Fields are returned as UTF-8 data, blank lines are skipped.
+ */
+
+CsvReader::CsvReader(QIODevice *device, const CsvOptions &options)
+    : d(new CsvReaderPrivate())
+{
+    d->device = device;
+    d->options = options;
+}
+
+CsvReader::~CsvReader()
+{}
+
+CsvOptions CsvReader::options() const
+{
+    return d->options;
+}
+
+/*!
+ * @brief Reads the next row into \a fields, returns false at the end of data or on error.
+ */
+bool CsvReader::readRow(QByteArrayList *fields)
+{
+    if (!d->errorString.isEmpty())
+        return false;
+
+    while (true) {
+        if (d->position == d->buffer.size()) {
+            if (d->eof)
+                return false;
+            if (!d->fill())
+                return false;
+            continue;
+        }
+
+        switch (d->parseRow(fields)) {
+        case CsvReaderPrivate::RowParsed:
+            if (fields->size() == 1 && fields->first().isEmpty())
+                continue; // Blank line
+            ++d->records;
+            return true;
+
+        case CsvReaderPrivate::NeedMoreData:
+            if (!d->fill())
+                return false;
+            break;
+
+        case CsvReaderPrivate::ParseError:
+            return false;
+        }
+    }
+}
+
+/*!
+ * @brief Returns the number of records read so far, header included.
+ */
+qint64 CsvReader::recordNumber() const
+{
+    return d->records;
+}
+
+bool CsvReader::hasError() const
+{
+    return !d->errorString.isEmpty();
+}
+
+QString CsvReader::errorString() const
+{
+    return d->errorString;
+}
+
+} // namespace QEloquent
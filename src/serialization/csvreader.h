@@ -0,0 +1,36 @@
+#ifndef QELOQUENT_CSVREADER_H
+#define QELOQUENT_CSVREADER_H
+
+#include <QEloquent/global.h>
+#include <QEloquent/serialization.h>
+
+#include <QScopedPointer>
+
+class QIODevice;
+
+namespace QEloquent {
+
+class CsvReaderPrivate;
+class QELOQUENT_EXPORT CsvReader
+{
+public:
+    explicit CsvReader(QIODevice *device, const CsvOptions &options = CsvOptions());
+    ~CsvReader();
+
+    CsvOptions options() const;
+
+    bool readRow(QByteArrayList *fields);
+    qint64 recordNumber() const;
+
+    bool hasError() const;
+    QString errorString() const;
+
+private:
+    Q_DISABLE_COPY(CsvReader)
+
+    QScopedPointer<CsvReaderPrivate> d;
+};
+
+} // namespace QEloquent
+
+#endif // QELOQUENT_CSVREADER_H
@@ -0,0 +1,218 @@
+#include "csvwriter.h"
+
+#include <QEloquent/datamap.h>
+#include <QEloquent/jsonwriter.h>
+
+#include <QIODevice>
+#include <QDateTime>
+#include <QLocale>
+
+#include <cstring>
+
+// Output to devices is written in chunks of this size
+#define FLUSH_THRESHOLD (64 * 1024)
+
+namespace QEloquent {
+
+class CsvWriterPrivate
+{
+public:
+    void appendField(const char *data, qsizetype size);
+    bool flush();
+
+    QIODevice *device = nullptr;
+    QByteArray buffer;
+    QByteArray *output = nullptr;
+    CsvOptions options;
+    bool rowStarted = false;
+    bool error = false;
+};
+
+// RFC 4180: fields holding a separator, a quote or a line break are quoted, quotes being doubled
+void CsvWriterPrivate::appendField(const char *data, qsizetype size)
+{
+    if (rowStarted)
+        output->append(options.separator);
+    rowStarted = true;
+
+    bool quoted = false;
+    for (qsizetype i(0); i < size; ++i) {
+        const char c = data[i];
+        if (c == options.separator || c == '"' || c == '\n' || c == '\r') {
+            quoted = true;
+            break;
+        }
+    }
+
+    if (!quoted) {
+        output->append(data, size);
+        return;
+    }
+
+    output->append('"');
+    const char *start = data;
+    const char *end = data + size;
+    while (start < end) {
+        const char *quote = static_cast<const char *>(std::memchr(start, '"', end - start));
+        if (!quote) {
+            output->append(start, end - start);
+            break;
+        }
+
+        output->append(start, quote - start + 1);
+        output->append('"');
+        start = quote + 1;
+    }
+    output->append('"');
+}
+
+bool CsvWriterPrivate::flush()
+{
+    if (!device || buffer.isEmpty())
+        return !error;
+
+    if (device->write(buffer) != buffer.size())
+        error = true;
+    buffer.clear();
+    return !error;
+}
+
+/*!
+ * @class QEloquent::CsvWriter
+ * @brief Streaming CSV writer, quoting fields as described by RFC 4180.
+ *
+ * Output goes either to a device, written by chunks, or appended to a byte array.
+ */
+
+CsvWriter::CsvWriter(QIODevice *device, const CsvOptions &options)
+    : d(new CsvWriterPrivate())
+{
+    d->device = device;
+    d->output = &d->buffer;
+    d->buffer.reserve(FLUSH_THRESHOLD + 1024);
+    d->options = options;
+}
+
+CsvWriter::CsvWriter(QByteArray *output, const CsvOptions &options)
+    : d(new CsvWriterPrivate())
+{
+    d->output = output;
+    d->options = options;
+}
+
+CsvWriter::~CsvWriter()
+{
+    d->flush();
+}
+
+CsvOptions CsvWriter::options() const
+{
+    return d->options;
+}
+
+/*!
+ * @brief Writes \a value as a field, nested maps and lists are written as JSON.
+ */
+void CsvWriter::writeField(const QVariant &value)
+{
+    if (value.isNull()) {
+        d->appendField(nullptr, 0);
+        return;
+    }
+
+    switch (value.metaType().id()) {
+    case QMetaType::QString:
+        writeField(*static_cast<const QString *>(value.constData()));
+        return;
+
+    case QMetaType::QByteArray:
+        writeUtf8Field(*static_cast<const QByteArray *>(value.constData()));
+        return;
+
+    case QMetaType::Int:
+    case QMetaType::LongLong:
+        writeUtf8Field(QByteArray::number(value.toLongLong()));
+        return;
+
+    case QMetaType::Double:
+    case QMetaType::Float:
+        writeUtf8Field(QByteArray::number(value.toDouble(), 'g', QLocale::FloatingPointShortest));
+        return;
+
+    case QMetaType::QDateTime:
+        writeField(value.toDateTime().toString(Qt::ISODateWithMs));
+        return;
+
+    case QMetaType::QTime:
+        writeField(value.toTime().toString(Qt::ISODateWithMs));
+        return;
+
+    case QMetaType::QVariantList:
+    case QMetaType::QVariantMap:
+    case QMetaType::QStringList:
+        break;
+
+    default:
+        if (value.metaType() != QMetaType::fromType<DataMap>() && value.metaType() != QMetaType::fromType<QList<DataMap>>()) {
+            writeField(value.toString());
+            return;
+        }
+        break;
+    }
+
+    QByteArray json;
+    {
+        JsonWriter writer(&json);
+        writer.writeValue(value);
+    }
+    writeUtf8Field(json);
+}
+
+void CsvWriter::writeField(const QString &value)
+{
+    const QByteArray utf8 = value.toUtf8();
+    d->appendField(utf8.constData(), utf8.size());
+}
+
+void CsvWriter::writeUtf8Field(QByteArrayView value)
+{
+    d->appendField(value.data(), value.size());
+}
+
+void CsvWriter::endRow()
+{
+    d->output->append(d->options.lineEnding);
+    d->rowStarted = false;
+
+    if (d->device && d->buffer.size() >= FLUSH_THRESHOLD)
+        d->flush();
+}
+
+void CsvWriter::writeRow(const QStringList &fields)
+{
+    for (const QString &field : fields)
+        writeField(field);
+    endRow();
+}
+
+void CsvWriter::writeRow(const QVariantList &fields)
+{
+    for (const QVariant &field : fields)
+        writeField(field);
+    endRow();
+}
+
+/*!
+ * @brief Writes buffered data to the device, returns false if any write failed.
+ */
+bool CsvWriter::flush()
+{
+    return d->flush();
+}
+
+bool CsvWriter::hasError() const
+{
+    return d->error;
+}
+
+} // namespace QEloquent
@@ -0,0 +1,42 @@
+#ifndef QELOQUENT_CSVWRITER_H
+#define QELOQUENT_CSVWRITER_H
+
+#include <QEloquent/global.h>
+#include <QEloquent/serialization.h>
+
+#include <QScopedPointer>
+
+class QIODevice;
+
+namespace QEloquent {
+
+class CsvWriterPrivate;
+class QELOQUENT_EXPORT CsvWriter
+{
+public:
+    explicit CsvWriter(QIODevice *device, const CsvOptions &options = CsvOptions());
+    explicit CsvWriter(QByteArray *output, const CsvOptions &options = CsvOptions());
+    ~CsvWriter();
+
+    CsvOptions options() const;
+
+    void writeField(const QVariant &value);
+    void writeField(const QString &value);
+    void writeUtf8Field(QByteArrayView value);
+    void endRow();
+
+    void writeRow(const QStringList &fields);
+    void writeRow(const QVariantList &fields);
+
+    bool flush();
+    bool hasError() const;
+
+private:
+    Q_DISABLE_COPY(CsvWriter)
+
+    QScopedPointer<CsvWriterPrivate> d;
+};
+
+} // namespace QEloquent
+
+#endif // QELOQUENT_CSVWRITER_H
@@ -1,6 +1,7 @@
 #include "deserializable.h"
 
 #include <QEloquent/datamap.h>
+#include <QEloquent/csvreader.h>
 
 #include <QJsonObject>
 #include <QJsonArray>
@@ -8,6 +9,7 @@
 #include <QJsonDocument>
 #include <QJsonParseError>
 #include <QSqlRecord>
+#include <QBuffer>
 
 namespace QEloquent {
 
@@ -31,13 +33,14 @@ void Deserializable::fill(const QJsonArray &array)
 {
     QList<DataMap> maps;
 
+    maps.reserve(array.size());
+
     for (const QJsonValue &value : array) {
         const QJsonObject object = value.toObject();
-        const QStringList keys = object.keys();
 
         DataMap map;
-        for (const QString &key : keys)
-            map.insert(key, object.value(key).toVariant());
+        for (auto it = object.constBegin(); it != object.constEnd(); ++it)
+            map.insert(it.key(), it.value().toVariant());
         maps.append(map);
     }
 
@@ -102,36 +105,37 @@ void Deserializable::fillJson(const QByteArray &data)
 
 void Deserializable::fillCsv(const QByteArray &data, SerializationFormat format, char separator)
 {
+    QByteArray content = data;
+    QBuffer buffer(&content);
+    if (!buffer.open(QIODevice::ReadOnly)) return;
+
+    CsvOptions options;
+    options.separator = separator;
+    options.header = (format != SerializationFormat::Compact);
+
+    CsvReader reader(&buffer, options);
+    QByteArrayList fields;
     QStringList headers;
-    const int startLine = (format == SerializationFormat::Compact ? 0 : 1);
-    const QByteArrayList lines = data.trimmed().split('\n');
-    if (lines.empty()) return;
 
-    if (startLine == 1) {
+    if (options.header) {
         // We consider line 0 as header
-        const QByteArrayList line = lines.first().split(separator);
-        std::transform(line.begin(), line.end(), std::back_inserter(headers), [](const QByteArray &item) {
+        if (!reader.readRow(&fields)) return;
+        std::transform(fields.begin(), fields.end(), std::back_inserter(headers), [](const QByteArray &item) {
             return QString::fromUtf8(item.trimmed());
         });
     }
 
-    auto extractLine = [&lines, &separator, &headers](int index) -> DataMap {
-        const QByteArray &raw = lines.at(index);
-        const QByteArrayList line = raw.split(separator);
-
+    QList<DataMap> maps;
+    while (reader.readRow(&fields)) {
         DataMap map;
-        for (int i(0); i < line.size(); ++i) {
+        for (int i(0); i < fields.size(); ++i) {
             if (i >= headers.size())
                 headers.append("Column " + QString::number(i + 1));
 
-            map.insert(headers.at(i), line.at(i));
+            map.insert(headers.at(i), fields.at(i));
         }
-        return map;
-    };
-
-    QList<DataMap> maps;
-    for (int i(startLine); i < lines.size(); ++i)
-        maps.append(extractLine(i));
+        maps.append(map);
+    }
     deserialize(maps, false);
 }
 
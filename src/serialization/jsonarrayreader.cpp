@@ -0,0 +1,267 @@
+#include "jsonarrayreader.h"
+
+#include <QIODevice>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonParseError>
+
+#include <cstring>
+
+// Device is read by chunks of this size
+#define CHUNK_SIZE (256 * 1024)
+
+namespace QEloquent {
+
+class JsonArrayReaderPrivate
+{
+public:
+    enum State {
+        BeforeArray,
+        BeforeElement,
+        InElement,
+        AfterArray
+    };
+
+    bool fill();
+    bool fail(const QString &message);
+    bool failElement(const QString &message);
+    bool skipWhitespace();
+
+    QIODevice *device = nullptr;
+    QByteArray buffer;
+    qsizetype position = 0;
+    bool eof = false;
+
+    State state = BeforeArray;
+    bool comma = false; // Separator read since the last element
+    qsizetype elementStart = 0;
+    int depth = 0;
+    bool inString = false;
+    bool escaped = false;
+
+    qint64 elements = 0;
+    QString errorString;
+};
+
+bool JsonArrayReaderPrivate::fill()
+{
+    // Data before the current element is dropped before reading more
+    const qsizetype consumed = (state == InElement ? elementStart : position);
+    if (consumed > 0) {
+        buffer.remove(0, consumed);
+        position -= consumed;
+        elementStart -= consumed;
+    }
+
+    const qsizetype size = buffer.size();
+    buffer.resize(size + CHUNK_SIZE);
+    const qint64 read = device->read(buffer.data() + size, CHUNK_SIZE);
+    if (read < 0) {
+        buffer.resize(size);
+        return fail(device->errorString());
+    }
+
+    buffer.resize(size + read);
+
+    // Sequential devices may just have nothing available yet
+    if (read == 0 && (!device->isSequential() || device->atEnd() || !device->waitForReadyRead(30000)))
+        eof = true;
+    return true;
+}
+
+bool JsonArrayReaderPrivate::fail(const QString &message)
+{
+    if (errorString.isEmpty())
+        errorString = message;
+    return false;
+}
+
+// Errors in an element count it, so elementNumber() is the element that failed
+bool JsonArrayReaderPrivate::failElement(const QString &message)
+{
+    return fail(QStringLiteral("Element %1: %2").arg(++elements).arg(message));
+}
+
+// Returns false if more data is needed
+bool JsonArrayReaderPrivate::skipWhitespace()
+{
+    while (position < buffer.size()) {
+        const char c = buffer.at(position);
+        if (c != ' ' && c != '\n' && c != '\r' && c != '\t')
+            return true;
+        ++position;
+    }
+    return false;
+}
+
+/*!
+ * @class QEloquent::JsonArrayReader
+ * @brief Reads the objects of a top level JSON array one at a time.
+ *
+ * Element boundaries are found by scanning the device by chunks, only the current element is parsed.
+ * Memory use therefore depends on the largest element, not on the whole payload.
+ */
+
+JsonArrayReader::JsonArrayReader(QIODevice *device)
+    : d(new JsonArrayReaderPrivate())
+{
+    d->device = device;
+}
+
+JsonArrayReader::~JsonArrayReader()
+{}
+
+/*!
+ * @brief Reads the next array element into \a object, returns false at the end of the array or on error.
+ */
+bool JsonArrayReader::readObject(QJsonObject *object)
+{
+    if (!d->errorString.isEmpty() || d->state == JsonArrayReaderPrivate::AfterArray)
+        return false;
+
+    while (true) {
+        if (d->position >= d->buffer.size()) {
+            if (d->eof) {
+                if (d->state != JsonArrayReaderPrivate::BeforeArray)
+                    return d->failElement(QStringLiteral("unexpected end of JSON data"));
+                return d->fail(d->buffer.isEmpty() ? QStringLiteral("Empty JSON document") : QStringLiteral("JSON data is not an array"));
+            }
+            if (!d->fill())
+                return false;
+            continue;
+        }
+
+        switch (d->state) {
+        case JsonArrayReaderPrivate::BeforeArray:
+            // UTF-8 byte order mark is tolerated
+            if (d->position == 0 && d->buffer.startsWith("\xEF\xBB\xBF"))
+                d->position = 3;
+            if (!d->skipWhitespace())
+                continue;
+            if (d->buffer.at(d->position) != '[')
+                return d->fail(QStringLiteral("JSON data is not an array"));
+            ++d->position;
+            d->state = JsonArrayReaderPrivate::BeforeElement;
+            break;
+
+        case JsonArrayReaderPrivate::BeforeElement: {
+            if (!d->skipWhitespace())
+                continue;
+
+            // Elements are separated by exactly one comma, with none before the first or after the last
+            const char c = d->buffer.at(d->position);
+            if (c == ']') {
+                if (d->comma)
+                    return d->failElement(QStringLiteral("expected after ','"));
+                ++d->position;
+                d->state = JsonArrayReaderPrivate::AfterArray;
+                return false;
+            }
+
+            if (c == ',') {
+                if (d->elements == 0 || d->comma)
+                    return d->failElement(QStringLiteral("unexpected ','"));
+                d->comma = true;
+                ++d->position;
+                continue;
+            }
+
+            if (c != '{')
+                return d->failElement(QStringLiteral("not an object"));
+            if (d->elements > 0 && !d->comma)
+                return d->failElement(QStringLiteral("missing ',' before it"));
+
+            d->comma = false;
+            d->state = JsonArrayReaderPrivate::InElement;
+            d->elementStart = d->position;
+            d->depth = 0;
+            d->inString = false;
+            d->escaped = false;
+            break;
+        }
+
+        case JsonArrayReaderPrivate::InElement: {
+            // Scanning resumes where it stopped, the state being kept across reads
+            const char *data = d->buffer.constData();
+            const qsizetype size = d->buffer.size();
+            qsizetype i = d->position;
+
+            for (; i < size; ++i) {
+                const char c = data[i];
+
+                if (d->inString) {
+                    if (d->escaped) {
+                        d->escaped = false;
+                    } else if (c == '\\') {
+                        d->escaped = true;
+                    } else if (c == '"') {
+                        d->inString = false;
+                    } else {
+                        // Skip to the next quote or backslash
+                        const char *quote = static_cast<const char *>(std::memchr(data + i, '"', size - i));
+                        const char *backslash = static_cast<const char *>(std::memchr(data + i, '\\', (quote ? quote : data + size) - (data + i)));
+                        const char *next = (backslash ? backslash : quote);
+                        if (!next) {
+                            i = size;
+                            break;
+                        }
+                        i = next - data - 1;
+                    }
+                    continue;
+                }
+
+                if (c == '"') {
+                    d->inString = true;
+                } else if (c == '{' || c == '[') {
+                    ++d->depth;
+                } else if (c == '}' || c == ']') {
+                    if (--d->depth == 0)
+                        break;
+                }
+            }
+
+            d->position = i;
+            if (i >= size)
+                continue;
+
+            ++d->position;
+            d->state = JsonArrayReaderPrivate::BeforeElement;
+
+            QJsonParseError error;
+            const QByteArray element = QByteArray::fromRawData(data + d->elementStart, d->position - d->elementStart);
+            const QJsonDocument document = QJsonDocument::fromJson(element, &error);
+            if (error.error != QJsonParseError::NoError)
+                return d->failElement(error.errorString());
+
+            ++d->elements;
+            *object = document.object();
+            return true;
+        }
+
+        case JsonArrayReaderPrivate::AfterArray:
+            return false;
+        }
+    }
+}
+
+/*!
+ * @brief Returns the number of elements read so far, including the one that failed after an element error.
+ *
+ * Errors found before the array starts leave it at 0.
+ */
+qint64 JsonArrayReader::elementNumber() const
+{
+    return d->elements;
+}
+
+bool JsonArrayReader::hasError() const
+{
+    return !d->errorString.isEmpty();
+}
+
+QString JsonArrayReader::errorString() const
+{
+    return d->errorString;
+}
+
+} // namespace QEloquent
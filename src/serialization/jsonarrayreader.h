@@ -0,0 +1,34 @@
+#ifndef QELOQUENT_JSONARRAYREADER_H
+#define QELOQUENT_JSONARRAYREADER_H
+
+#include <QEloquent/global.h>
+
+#include <QScopedPointer>
+
+class QIODevice;
+class QJsonObject;
+
+namespace QEloquent {
+
+class JsonArrayReaderPrivate;
+class QELOQUENT_EXPORT JsonArrayReader
+{
+public:
+    explicit JsonArrayReader(QIODevice *device);
+    ~JsonArrayReader();
+
+    bool readObject(QJsonObject *object);
+    qint64 elementNumber() const;
+
+    bool hasError() const;
+    QString errorString() const;
+
+private:
+    Q_DISABLE_COPY(JsonArrayReader)
+
+    QScopedPointer<JsonArrayReaderPrivate> d;
+};
+
+} // namespace QEloquent
+
+#endif // QELOQUENT_JSONARRAYREADER_H
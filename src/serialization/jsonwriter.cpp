@@ -0,0 +1,449 @@
+#include "jsonwriter.h"
+
+#include <QEloquent/datamap.h>
+
+#include <QIODevice>
+#include <QVarLengthArray>
+#include <QJsonValue>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QDateTime>
+#include <QLocale>
+
+#include <array>
+#include <cmath>
+
+// Output to devices is written in chunks of this size
+#define FLUSH_THRESHOLD (64 * 1024)
+
+namespace QEloquent {
+
+class JsonWriterPrivate
+{
+public:
+    struct Scope
+    {
+        bool object;
+        bool empty;
+    };
+
+    void separate();
+    void newLine();
+
+    void append(char c)
+    { output->append(c); }
+
+    void append(const char *data, qsizetype size)
+    { output->append(data, size); }
+
+    void appendEscaped(const char *data, qsizetype size);
+
+    void flushIfNeeded()
+    {
+        if (device && buffer.size() >= FLUSH_THRESHOLD)
+            flush();
+    }
+
+    bool flush();
+
+    QIODevice *device = nullptr;
+    QByteArray buffer;
+    QByteArray *output = nullptr;
+    bool pretty = false;
+    bool afterKey = false;
+    bool error = false;
+    QVarLengthArray<Scope, 16> scopes;
+};
+
+// Characters requiring an escape sequence, 0 otherwise
+static const std::array<char, 256> s_escapes = []() {
+    std::array<char, 256> escapes = {};
+    for (int i(0); i < 0x20; ++i)
+        escapes[i] = 'u';
+    escapes['"'] = '"';
+    escapes['\\'] = '\\';
+    escapes['\b'] = 'b';
+    escapes['\f'] = 'f';
+    escapes['\n'] = 'n';
+    escapes['\r'] = 'r';
+    escapes['\t'] = 't';
+    return escapes;
+}();
+
+void JsonWriterPrivate::separate()
+{
+    if (afterKey) {
+        afterKey = false;
+        return;
+    }
+
+    if (scopes.isEmpty())
+        return;
+
+    Scope &scope = scopes.last();
+    if (!scope.empty)
+        append(',');
+    scope.empty = false;
+    newLine();
+}
+
+void JsonWriterPrivate::newLine()
+{
+    if (!pretty)
+        return;
+
+    append('\n');
+    output->append(QByteArray(scopes.size() * 4, ' '));
+}
+
+// Runs of plain characters are copied at once
+void JsonWriterPrivate::appendEscaped(const char *data, qsizetype size)
+{
+    static const char hex[] = "0123456789abcdef";
+
+    append('"');
+
+    qsizetype start = 0;
+    for (qsizetype i(0); i < size; ++i) {
+        const char escape = s_escapes[uchar(data[i])];
+        if (!escape)
+            continue;
+
+        if (i > start)
+            append(data + start, i - start);
+        start = i + 1;
+
+        if (escape == 'u') {
+            const char sequence[] = { '\\', 'u', '0', '0', hex[uchar(data[i]) >> 4], hex[uchar(data[i]) & 0xF] };
+            append(sequence, sizeof(sequence));
+        } else {
+            const char sequence[] = { '\\', escape };
+            append(sequence, sizeof(sequence));
+        }
+    }
+
+    if (size > start)
+        append(data + start, size - start);
+
+    append('"');
+}
+
+bool JsonWriterPrivate::flush()
+{
+    if (!device || buffer.isEmpty())
+        return !error;
+
+    if (device->write(buffer) != buffer.size())
+        error = true;
+    buffer.clear();
+    return !error;
+}
+
+/*!
+ * @class QEloquent::JsonWriter
+ * @brief Streaming JSON writer, values are written as they come without building a document first.
+ *
+ * Output goes either to a device, written by chunks, or appended to a byte array.
+ * @code
+ * JsonWriter writer(&file);
+ * writer.beginArray();
+ * for (const Product &product : products)
+ *     product.writeJson(writer);
+ * writer.endArray();
+ * @endcode
+ */
+
+JsonWriter::JsonWriter(QIODevice *device, SerializationFormat format)
+    : d(new JsonWriterPrivate())
+{
+    d->device = device;
+    d->output = &d->buffer;
+    d->buffer.reserve(FLUSH_THRESHOLD + 1024);
+    d->pretty = (format != SerializationFormat::Compact);
+}
+
+JsonWriter::JsonWriter(QByteArray *output, SerializationFormat format)
+    : d(new JsonWriterPrivate())
+{
+    d->output = output;
+    d->pretty = (format != SerializationFormat::Compact);
+}
+
+JsonWriter::~JsonWriter()
+{
+    d->flush();
+}
+
+void JsonWriter::beginObject()
+{
+    d->separate();
+    d->append('{');
+    d->scopes.append({ true, true });
+}
+
+void JsonWriter::endObject()
+{
+    const bool empty = d->scopes.last().empty;
+    d->scopes.removeLast();
+    if (!empty)
+        d->newLine();
+    d->append('}');
+    d->flushIfNeeded();
+}
+
+void JsonWriter::beginArray()
+{
+    d->separate();
+    d->append('[');
+    d->scopes.append({ false, true });
+}
+
+void JsonWriter::endArray()
+{
+    const bool empty = d->scopes.last().empty;
+    d->scopes.removeLast();
+    if (!empty)
+        d->newLine();
+    d->append(']');
+    d->flushIfNeeded();
+}
+
+void JsonWriter::writeKey(const QString &key)
+{
+    d->separate();
+    const QByteArray utf8 = key.toUtf8();
+    d->appendEscaped(utf8.constData(), utf8.size());
+    if (d->pretty)
+        d->append(": ", 2);
+    else
+        d->append(':');
+    d->afterKey = true;
+}
+
+void JsonWriter::writeNull()
+{
+    d->separate();
+    d->append("null", 4);
+}
+
+void JsonWriter::writeBool(bool value)
+{
+    d->separate();
+    if (value)
+        d->append("true", 4);
+    else
+        d->append("false", 5);
+}
+
+void JsonWriter::writeInteger(qint64 value)
+{
+    d->separate();
+    char digits[24];
+    char *end = digits + sizeof(digits);
+    char *begin = end;
+
+    quint64 magnitude = (value < 0 ? 0 - quint64(value) : quint64(value));
+    do {
+        *--begin = char('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude);
+
+    if (value < 0)
+        *--begin = '-';
+    d->append(begin, end - begin);
+}
+
+void JsonWriter::writeUnsigned(quint64 value)
+{
+    d->separate();
+    d->output->append(QByteArray::number(value));
+}
+
+/*!
+ * @brief Writes \a value in its shortest representation, non finite values are written as null like QJsonDocument does.
+ */
+void JsonWriter::writeDouble(double value)
+{
+    if (!std::isfinite(value)) {
+        writeNull();
+        return;
+    }
+
+    d->separate();
+    d->output->append(QByteArray::number(value, 'g', QLocale::FloatingPointShortest));
+}
+
+void JsonWriter::writeString(const QString &value)
+{
+    d->separate();
+    const QByteArray utf8 = value.toUtf8();
+    d->appendEscaped(utf8.constData(), utf8.size());
+}
+
+void JsonWriter::writeUtf8String(QByteArrayView value)
+{
+    d->separate();
+    d->appendEscaped(value.data(), value.size());
+}
+
+/*!
+ * @brief Writes \a value, converted the same way QJsonValue::fromVariant() would.
+ */
+void JsonWriter::writeValue(const QVariant &value)
+{
+    if (value.isNull()) {
+        writeNull();
+        return;
+    }
+
+    switch (value.metaType().id()) {
+    case QMetaType::Bool:
+        writeBool(value.toBool());
+        return;
+
+    case QMetaType::Int:
+    case QMetaType::Short:
+    case QMetaType::Long:
+    case QMetaType::LongLong:
+    case QMetaType::Char:
+    case QMetaType::SChar:
+        writeInteger(value.toLongLong());
+        return;
+
+    case QMetaType::UInt:
+    case QMetaType::UShort:
+    case QMetaType::ULong:
+    case QMetaType::UChar:
+        writeInteger(qint64(value.toULongLong()));
+        return;
+
+    case QMetaType::ULongLong:
+        writeUnsigned(value.toULongLong());
+        return;
+
+    case QMetaType::Double:
+    case QMetaType::Float:
+        writeDouble(value.toDouble());
+        return;
+
+    case QMetaType::QString:
+        writeString(*static_cast<const QString *>(value.constData()));
+        return;
+
+    case QMetaType::QByteArray:
+        writeUtf8String(*static_cast<const QByteArray *>(value.constData()));
+        return;
+
+    case QMetaType::QDateTime:
+        writeString(value.toDateTime().toString(Qt::ISODateWithMs));
+        return;
+
+    case QMetaType::QDate:
+        writeString(value.toDate().toString(Qt::ISODate));
+        return;
+
+    case QMetaType::QTime:
+        writeString(value.toTime().toString(Qt::ISODateWithMs));
+        return;
+
+    case QMetaType::QStringList:
+        beginArray();
+        for (const QString &item : *static_cast<const QStringList *>(value.constData()))
+            writeString(item);
+        endArray();
+        return;
+
+    case QMetaType::QVariantList:
+        beginArray();
+        for (const QVariant &item : *static_cast<const QVariantList *>(value.constData()))
+            writeValue(item);
+        endArray();
+        return;
+
+    case QMetaType::QVariantMap: {
+        const QVariantMap &map = *static_cast<const QVariantMap *>(value.constData());
+        beginObject();
+        for (auto it = map.constBegin(); it != map.constEnd(); ++it) {
+            writeKey(it.key());
+            writeValue(it.value());
+        }
+        endObject();
+        return;
+    }
+
+    default:
+        break;
+    }
+
+    if (value.metaType() == QMetaType::fromType<DataMap>()) {
+        writeValue(*static_cast<const DataMap *>(value.constData()));
+        return;
+    }
+
+    if (value.metaType() == QMetaType::fromType<QList<DataMap>>()) {
+        writeValue(*static_cast<const QList<DataMap> *>(value.constData()));
+        return;
+    }
+
+    // Uncommon types, converted through Qt JSON classes
+    const QJsonValue json = QJsonValue::fromVariant(value);
+    switch (json.type()) {
+    case QJsonValue::Object:
+    case QJsonValue::Array: {
+        const QJsonDocument document = (json.isObject() ? QJsonDocument(json.toObject()) : QJsonDocument(json.toArray()));
+        d->separate();
+        d->output->append(document.toJson(QJsonDocument::Compact));
+        break;
+    }
+
+    case QJsonValue::Bool:
+        writeBool(json.toBool());
+        break;
+
+    case QJsonValue::Double:
+        writeDouble(json.toDouble());
+        break;
+
+    case QJsonValue::String:
+        writeString(json.toString());
+        break;
+
+    default:
+        writeNull();
+        break;
+    }
+}
+
+void JsonWriter::writeValue(const DataMap &map)
+{
+    beginObject();
+    for (const DataMapPair &item : map) {
+        writeKey(item.first);
+        writeValue(item.second);
+    }
+    endObject();
+}
+
+void JsonWriter::writeValue(const QList<DataMap> &maps)
+{
+    beginArray();
+    for (const DataMap &map : maps)
+        writeValue(map);
+    endArray();
+}
+
+/*!
+ * @brief Writes buffered data to the device, returns false if any write failed.
+ */
+bool JsonWriter::flush()
+{
+    return d->flush();
+}
+
+bool JsonWriter::hasError() const
+{
+    return d->error;
+}
+
+} // namespace QEloquent
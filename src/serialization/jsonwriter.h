@@ -0,0 +1,53 @@
+#ifndef QELOQUENT_JSONWRITER_H
+#define QELOQUENT_JSONWRITER_H
+
+#include <QEloquent/global.h>
+#include <QEloquent/serialization.h>
+
+#include <QScopedPointer>
+
+class QIODevice;
+
+namespace QEloquent {
+
+class DataMap;
+
+class JsonWriterPrivate;
+class QELOQUENT_EXPORT JsonWriter
+{
+public:
+    explicit JsonWriter(QIODevice *device, SerializationFormat format = SerializationFormat::Compact);
+    explicit JsonWriter(QByteArray *output, SerializationFormat format = SerializationFormat::Compact);
+    ~JsonWriter();
+
+    void beginObject();
+    void endObject();
+    void beginArray();
+    void endArray();
+
+    void writeKey(const QString &key);
+
+    void writeNull();
+    void writeBool(bool value);
+    void writeInteger(qint64 value);
+    void writeUnsigned(quint64 value);
+    void writeDouble(double value);
+    void writeString(const QString &value);
+    void writeUtf8String(QByteArrayView value);
+
+    void writeValue(const QVariant &value);
+    void writeValue(const DataMap &map);
+    void writeValue(const QList<DataMap> &maps);
+
+    bool flush();
+    bool hasError() const;
+
+private:
+    Q_DISABLE_COPY(JsonWriter)
+
+    QScopedPointer<JsonWriterPrivate> d;
+};
+
+} // namespace QEloquent
+
+#endif // QELOQUENT_JSONWRITER_H
@@ -1,6 +1,8 @@
 #include "serializable.h"
 
 #include <QEloquent/datamap.h>
+#include <QEloquent/tracer.h>
+#include <QEloquent/jsonwriter.h>
 #include <QEloquent/private/jsonserializer_p.h>
 #include <QEloquent/private/yamlserializer_p.h>
 #include <QEloquent/private/csvserializer_p.h>
@@ -8,7 +10,6 @@
 #include <QJsonObject>
 #include <QJsonArray>
 #include <QJsonValue>
-#include <QJsonDocument>
 
 namespace QEloquent {
 
@@ -45,27 +46,46 @@ QJsonValue Serializable::toJsonValue() const
 }
 
 QByteArray Serializable::toJson(SerializationFormat format) const
+{
+    TraceSpan span("Serializable::toJson", "serialization");
+    if (span.isActive())
+        span.setDetail(serializationContext());
+
+    QByteArray data;
+    JsonWriter writer(&data, format);
+    writeJson(writer);
+    return data;
+}
+
+/*!
+ * @brief Streams the JSON representation to \a device, returns false on write errors.
+ */
+bool Serializable::toJson(QIODevice *device, SerializationFormat format) const
+{
+    TraceSpan span("Serializable::toJson", "serialization");
+    if (span.isActive())
+        span.setDetail(serializationContext());
+
+    JsonWriter writer(device, format);
+    writeJson(writer);
+    return writer.flush();
+}
+
+/*!
+ * @brief Writes the JSON representation using \a writer.
+ *
+ * The default implementation goes through serialize(), reimplement it to stream values directly.
+ */
+void Serializable::writeJson(JsonWriter &writer) const
 {
     const QList<DataMap> maps = serialize();
 
-    QJsonDocument doc;
     if (isListSerializable())
-        doc.setArray(JsonSerializer::serializeMaps(maps));
+        writer.writeValue(maps);
     else if (!maps.isEmpty())
-        doc.setObject(JsonSerializer::serializeMap(maps.first()));
+        writer.writeValue(maps.first());
     else
-        doc.setObject(QJsonObject());
-
-    switch (format) {
-    case SerializationFormat::Compact:
-        return doc.toJson(QJsonDocument::Compact);
-
-    case SerializationFormat::Pretty:
-    case SerializationFormat::Beautified:
-        return doc.toJson(QJsonDocument::Indented);
-    }
-
-    return QByteArray();
+        writer.writeValue(DataMap());
 }
 
 QByteArray Serializable::toCsv(SerializationFormat format) const
@@ -8,10 +8,12 @@ class QJsonObject;
 class QJsonArray;
 class QJsonValue;
 class QDataStream;
+class QIODevice;
 
 namespace QEloquent {
 
 class DataMap;
+class JsonWriter;
 
 class QELOQUENT_EXPORT Serializable
 {
@@ -26,6 +28,9 @@ public:
     QJsonArray toJsonArray() const;
     QJsonValue toJsonValue() const;
     QByteArray toJson(SerializationFormat format = SerializationFormat::Compact) const;
+    bool toJson(QIODevice *device, SerializationFormat format = SerializationFormat::Compact) const;
+
+    virtual void writeJson(JsonWriter &writer) const;
 
     QByteArray toYaml() const;
     QByteArray toCsv(SerializationFormat format = SerializationFormat::Compact) const;
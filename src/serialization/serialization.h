@@ -3,6 +3,8 @@
 
 #include <QEloquent/global.h>
 
+#include <QByteArray>
+
 namespace QEloquent {
 
 enum class SerializationFormat {
@@ -11,6 +13,16 @@ enum class SerializationFormat {
     Beautified,
 };
 
+/*!
+ * @brief CSV dialect, RFC 4180 by default. Line ending only applies to writing, both LF and CRLF are read.
+ */
+struct CsvOptions
+{
+    char separator = ',';
+    bool header = true;
+    QByteArray lineEnding = "\r\n";
+};
+
 }
 
 #endif // QELOQUENT_SERIALIZATION_H
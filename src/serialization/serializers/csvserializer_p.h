@@ -3,6 +3,7 @@
 
 #include <QEloquent/serialization.h>
 #include <QEloquent/datamap.h>
+#include <QEloquent/csvwriter.h>
 
 namespace QEloquent::Private {
 
@@ -12,29 +13,31 @@ public:
     static QByteArray serializeMaps(const QList<DataMap> &maps, bool isList, SerializationFormat format) {
         if (maps.isEmpty()) return QByteArray();
 
+        CsvOptions options;
+        options.separator = ';';
+        options.header = (format == SerializationFormat::Pretty);
+        options.lineEnding = "\n";
+
         const QStringList keys = maps.first().keys();
-        QByteArrayList data;
-        const QByteArray separator(";");
+        QByteArray data;
 
-        // Header added for pretty format
-        if (format == SerializationFormat::Pretty) {
-            QByteArrayList line;
-            std::transform(keys.begin(), keys.end(), std::back_inserter(line), [](const QString &key) {
-                return key.toUtf8();
-            });
+        {
+            CsvWriter writer(&data, options);
 
-            data.append(line.join(separator));
-        }
+            // Header added for pretty format
+            if (options.header)
+                writer.writeRow(keys);
 
-        // Data
-        for (const DataMap &map : maps) {
-            QByteArrayList line;
-            for (const QString &key : keys)
-                line.append(map.value(key).toByteArray());
-            data.append(line.join(separator));
+            // Data
+            for (const DataMap &map : maps) {
+                for (const QString &key : keys)
+                    writer.writeField(map.value(key));
+                writer.endRow();
+            }
         }
 
-        return data.join('\n');
+        data.chop(options.lineEnding.size());
+        return data;
     }
 };
 
@@ -4,15 +4,86 @@
 
 #include <QJsonObject>
 
+#include <array>
+#include <thread>
+
 namespace QEloquent {
 
+/*
+ * Key positions shared by maps holding the same keys in the same order, rows of a result set typically.
+ * A map may use a layout holding more keys than itself, as long as its keys are a prefix of the layout ones.
+ */
+class DataMapLayout
+{
+public:
+    bool startsWith(const QVector<DataMapPair> &data) const;
+    void append(const DataMapKey &key);
+
+    static std::shared_ptr<DataMapLayout> intern(const QVector<DataMapPair> &data);
+
+    QList<DataMapKey> keys;
+    QHash<DataMapKey, int> index;
+
+    // Only extended by maps of the creating thread, the one where it's interned
+    std::thread::id owner = std::this_thread::get_id();
+};
+
+bool DataMapLayout::startsWith(const QVector<DataMapPair> &data) const
+{
+    if (keys.size() < data.size())
+        return false;
+
+    // Keys usually share their data, making comparisons a pointer check
+    for (qsizetype i(0); i < data.size(); ++i)
+        if (keys.at(i) != data.at(i).first)
+            return false;
+    return true;
+}
+
+void DataMapLayout::append(const DataMapKey &key)
+{
+    index.insert(key, keys.size());
+    keys.append(key);
+}
+
+std::shared_ptr<DataMapLayout> DataMapLayout::intern(const QVector<DataMapPair> &data)
+{
+    // Recent layouts of the current thread, weak so that unused ones go away with their maps
+    static thread_local std::array<std::weak_ptr<DataMapLayout>, 8> layouts;
+    static thread_local std::size_t next = 0;
+
+    for (const std::weak_ptr<DataMapLayout> &weakLayout : layouts) {
+        std::shared_ptr<DataMapLayout> layout = weakLayout.lock();
+        if (layout && layout->startsWith(data))
+            return layout;
+    }
+
+    auto layout = std::make_shared<DataMapLayout>();
+    layout->keys.reserve(data.size());
+    layout->index.reserve(data.size());
+    for (const DataMapPair &pair : data)
+        layout->append(pair.first);
+
+    layouts[next++ % layouts.size()] = layout;
+    return layout;
+}
+
+/*!
+ * @class QEloquent::DataMap
+ * @brief Ordered key/value map used to move model data around.
+ *
+ * Small maps, the vast majority, are searched linearly. From LinearSearchThreshold keys, lookups go through
+ * a layout of key positions shared between maps holding the same keys, rather than a hash per map.
+ */
+
 DataMap::DataMap()
 {}
 
 DataMap::DataMap(const std::initializer_list<Pair> &data)
     : m_data(data)
-    , m_index(generateIndex(m_data))
-{}
+{
+    computeIndexes();
+}
 
 QList<DataMap::Key> DataMap::keys() const
 {
@@ -34,24 +105,22 @@ QList<DataMap::Value> DataMap::values() const
 
 bool DataMap::contains(const Key &key) const
 {
-    return m_index.contains(key);
+    return indexOf(key) >= 0;
 }
 
 DataMap::Value DataMap::value(const Key &key) const
 {
-    const int index = m_index.value(key);
-    return m_data.value(index).second;
+    const int index = indexOf(key);
+    return (index >= 0 ? m_data.at(index).second : Value());
 }
 
 void DataMap::insert(const Key &key, const Value &value)
 {
-    if (m_index.contains(key)) {
-        m_data[m_index.value(key)].second = value;
-    } else {
-        const int index = m_data.size();
-        m_data.append({ key, value });
-        m_index.insert(key, index);
-    }
+    const int index = indexOf(key);
+    if (index >= 0)
+        m_data[index].second = value;
+    else
+        append(key, value);
 }
 
 void DataMap::insert(const Key &key, const DataMap &map)
@@ -72,23 +141,20 @@ void DataMap::insert(const DataMap &map)
 
 void DataMap::remove(const Key &key)
 {
-    // We avoid wasting CPU time if the key doesn't exists
-    if (!m_index.contains(key)) return;
+    const int index = indexOf(key);
+    if (index < 0) return;
 
-    // Removing index and data for the key
-    const int removedIndex = m_index.take(key);
-    m_data.remove(removedIndex);
+    m_data.remove(index);
 
-    // Updating indexes after the removed one
-    std::for_each(m_index.begin(), m_index.end(), [&removedIndex](int &index) {
-        if (index > removedIndex) --index;
-    });
+    // Removing the last key keeps the layout valid, other removals shift positions
+    if (m_layout && index != m_data.size())
+        computeIndexes();
 }
 
 void DataMap::clear()
 {
     m_data.clear();
-    m_index.clear();
+    m_layout.reset();
 }
 
 void DataMap::forEach(const std::function<void (const Pair &, const DataMap &)> &callback, int depth) const
@@ -123,7 +189,8 @@ void DataMap::forEach(const std::function<void (Pair &)> &callback, int depth)
 
 void DataMap::removeIf(const std::function<bool (const Pair &)> &pred)
 {
-    m_data.removeIf(pred);
+    if (m_data.removeIf(pred) > 0)
+        computeIndexes();
 }
 
 QVariantMap DataMap::toVariantMap() const
@@ -160,16 +227,20 @@ DataMap DataMap::fromVariantMap(const QVariantMap &map)
 {
     DataMap output;
 
-    const QStringList fields = map.keys();
-    for (const QString &field : fields)
-        output.insert(field, map.value(field));
+    for (auto it = map.constBegin(); it != map.constEnd(); ++it)
+        output.insert(it.key(), it.value());
 
     return output;
 }
 
+/*!
+ * @brief Resynchronizes lookups with the data, needed after changing keys through intenalData().
+ */
 void DataMap::computeIndexes()
 {
-    m_index = generateIndex(m_data);
+    m_layout.reset();
+    if (m_data.size() >= LinearSearchThreshold)
+        m_layout = DataMapLayout::intern(m_data);
 }
 
 DataMap DataMap::fromVariant(const QVariant &var)
@@ -197,12 +268,40 @@ QVector<DataMap::Pair> *DataMap::mutableList()
     return &m_data;
 }
 
-QHash<DataMap::Key, int> DataMap::generateIndex(const QVector<Pair> &data)
+int DataMap::indexOf(const Key &key) const
+{
+    if (m_layout) {
+        const int index = m_layout->index.value(key, -1);
+        return (index < m_data.size() ? index : -1);
+    }
+
+    for (int i(0); i < m_data.size(); ++i)
+        if (m_data.at(i).first == key)
+            return i;
+    return -1;
+}
+
+void DataMap::append(const Key &key, const Value &value)
 {
-    QHash<DataMap::Key, int> index;
-    for (int i(0); i < data.size(); ++i)
-        index.insert(data.at(i).first, i);
-    return index;
+    const qsizetype size = m_data.size();
+    m_data.append({ key, value });
+
+    if (m_layout) {
+        // Following the same keys as previous maps
+        if (m_layout->keys.size() > size && m_layout->keys.at(size) == key)
+            return;
+
+        // Extended in place when no other map can see it
+        if (m_layout->keys.size() == size && m_layout.use_count() == 1 && m_layout->owner == std::this_thread::get_id()) {
+            m_layout->append(key);
+            return;
+        }
+
+        m_layout.reset();
+    }
+
+    if (m_data.size() >= LinearSearchThreshold)
+        m_layout = DataMapLayout::intern(m_data);
 }
 
 } // namespace QEloquent
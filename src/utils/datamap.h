@@ -9,12 +9,15 @@
 #include <QHash>
 #include <QVariant>
 
+#include <memory>
+
 namespace QEloquent {
 
 using DataMapKey = QString;
 using DataMapValue = QVariant;
 using DataMapPair = QPair<DataMapKey, DataMapValue>;
 
+class DataMapLayout;
 class QELOQUENT_EXPORT DataMap : public AbstractListProxy<DataMapPair>
 {
 public:
@@ -60,11 +63,14 @@ protected:
     const QVector<Pair> *constList() const override;
     QVector<Pair> *mutableList() override;
 
+    static constexpr int LinearSearchThreshold = 16;
+
 private:
-    static QHash<Key, int> generateIndex(const QVector<Pair> &data);
+    int indexOf(const Key &key) const;
+    void append(const Key &key, const Value &value);
 
     QVector<Pair> m_data;
-    QHash<Key, int> m_index;
+    std::shared_ptr<DataMapLayout> m_layout;
 };
 
 } // namespace QEloquent
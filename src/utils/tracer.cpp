@@ -0,0 +1,260 @@
+#include "tracer.h"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QMutex>
+#include <QFile>
+#include <QDebug>
+
+#include <atomic>
+
+namespace QEloquent {
+
+// Either a ring buffer, or kept up to a limit and written to a file when stopped
+struct TraceBuffer
+{
+    QList<TraceEvent> events;
+    qsizetype capacity = 0;
+    qsizetype next = 0;
+    QString fileName;
+    qsizetype limit = 0;
+    qint64 dropped = 0;
+};
+
+static std::atomic<bool> s_enabled = false;
+static std::atomic<int> s_lastThreadId = 0;
+static QMutex s_mutex;
+
+static TraceBuffer &traceBuffer()
+{
+    static TraceBuffer buffer;
+    return buffer;
+}
+
+static const QElapsedTimer &traceClock()
+{
+    static const QElapsedTimer clock = []() {
+        QElapsedTimer timer;
+        timer.start();
+        return timer;
+    }();
+    return clock;
+}
+
+/*!
+ * @class QEloquent::Tracer
+ * @brief Collects ORM spans and exports them in Chrome Trace Event format.
+ *
+ * Traces can be opened with chrome://tracing or https://ui.perfetto.dev.
+ * @code
+ * Tracer::start("trace.json");
+ * // ...
+ * Tracer::stop(); // Writes the file
+ * @endcode
+ */
+
+/*!
+ * @brief Starts tracing, events are kept in memory until stop() writes them to \a fileName.
+ *
+ * Memory grows with the trace, events past \a maxEvents are dropped and counted by droppedEvents().
+ */
+bool Tracer::start(const QString &fileName, int maxEvents)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        return false;
+    file.close();
+
+    QMutexLocker locker(&s_mutex);
+    TraceBuffer &buffer = traceBuffer();
+    buffer = TraceBuffer();
+    buffer.fileName = fileName;
+    buffer.limit = qMax(1, maxEvents);
+    traceClock();
+    s_enabled.store(true, std::memory_order_release);
+    return true;
+}
+
+/*!
+ * @brief Starts tracing into a ring buffer keeping the last \a capacity events.
+ */
+void Tracer::start(int capacity)
+{
+    QMutexLocker locker(&s_mutex);
+    TraceBuffer &buffer = traceBuffer();
+    buffer = TraceBuffer();
+    buffer.capacity = qMax(1, capacity);
+    buffer.events.reserve(buffer.capacity);
+    traceClock();
+    s_enabled.store(true, std::memory_order_release);
+}
+
+/*!
+ * @brief Stops tracing, writing events to the file given to start() if any.
+ *
+ * Collected events remain available through events() and toJson() until the next start() or clear().
+ */
+void Tracer::stop()
+{
+    s_enabled.store(false, std::memory_order_release);
+
+    QString fileName;
+    qint64 dropped;
+    {
+        QMutexLocker locker(&s_mutex);
+        fileName = traceBuffer().fileName;
+        dropped = traceBuffer().dropped;
+    }
+
+    if (fileName.isEmpty())
+        return;
+
+    if (dropped > 0)
+        qWarning().nospace() << "Tracer: " << dropped << " events dropped, the trace reached its size limit";
+
+    QFile file(fileName);
+    if (file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        write(&file);
+}
+
+bool Tracer::isEnabled()
+{
+    return s_enabled.load(std::memory_order_acquire);
+}
+
+void Tracer::addEvent(const TraceEvent &event)
+{
+    QMutexLocker locker(&s_mutex);
+    TraceBuffer &buffer = traceBuffer();
+
+    if (buffer.capacity == 0) {
+        if (buffer.events.size() < buffer.limit)
+            buffer.events.append(event);
+        else
+            ++buffer.dropped;
+    } else if (buffer.events.size() < buffer.capacity) {
+        buffer.events.append(event);
+    } else {
+        buffer.events[buffer.next] = event;
+        buffer.next = (buffer.next + 1) % buffer.capacity;
+    }
+}
+
+/*!
+ * @brief Returns collected events, oldest first.
+ */
+QList<TraceEvent> Tracer::events()
+{
+    QMutexLocker locker(&s_mutex);
+    const TraceBuffer &buffer = traceBuffer();
+    if (buffer.next == 0)
+        return buffer.events;
+
+    QList<TraceEvent> events;
+    events.reserve(buffer.events.size());
+    events.append(buffer.events.mid(buffer.next));
+    events.append(buffer.events.mid(0, buffer.next));
+    return events;
+}
+
+QJsonObject Tracer::toJson()
+{
+    const QList<TraceEvent> events = Tracer::events();
+    const qint64 pid = QCoreApplication::applicationPid();
+
+    QJsonArray traceEvents;
+    for (const TraceEvent &event : events) {
+        QJsonObject object;
+        object.insert("name", QString::fromLatin1(event.name));
+        object.insert("cat", QString::fromLatin1(event.category));
+        object.insert("ph", "X");
+        object.insert("ts", event.startNs / 1000.0);
+        object.insert("dur", event.durationNs / 1000.0);
+        object.insert("pid", pid);
+        object.insert("tid", event.threadId);
+        if (!event.detail.isEmpty())
+            object.insert("args", QJsonObject({ { "detail", event.detail } }));
+        traceEvents.append(object);
+    }
+
+    QJsonObject trace;
+    trace.insert("traceEvents", traceEvents);
+    trace.insert("displayTimeUnit", "ns");
+    return trace;
+}
+
+bool Tracer::write(QIODevice *device)
+{
+    const QByteArray data = QJsonDocument(toJson()).toJson(QJsonDocument::Compact);
+    return device->write(data) == data.size();
+}
+
+void Tracer::clear()
+{
+    QMutexLocker locker(&s_mutex);
+    TraceBuffer &buffer = traceBuffer();
+    buffer.events.clear();
+    buffer.next = 0;
+    buffer.dropped = 0;
+}
+
+/*!
+ * @brief Returns the number of events dropped since tracing to a file started, once its limit was reached.
+ */
+qint64 Tracer::droppedEvents()
+{
+    QMutexLocker locker(&s_mutex);
+    return traceBuffer().dropped;
+}
+
+/*!
+ * @brief Returns the tracer clock, in nanoseconds.
+ */
+qint64 Tracer::now()
+{
+    return traceClock().nsecsElapsed();
+}
+
+/*!
+ * @brief Returns a small, stable, identifier for the calling thread.
+ */
+int Tracer::currentThreadId()
+{
+    static thread_local const int id = ++s_lastThreadId;
+    return id;
+}
+
+TraceSpan::TraceSpan(const char *name, const char *category)
+    : m_active(Tracer::isEnabled())
+{
+    if (!m_active)
+        return;
+
+    m_event.name = name;
+    m_event.category = category;
+    m_event.threadId = Tracer::currentThreadId();
+    m_event.startNs = Tracer::now();
+}
+
+TraceSpan::~TraceSpan()
+{
+    if (!m_active)
+        return;
+
+    m_event.durationNs = Tracer::now() - m_event.startNs;
+    Tracer::addEvent(m_event);
+}
+
+/*!
+ * @brief Attaches \a detail (statement, model class, ...) to the span, shown as an argument.
+ */
+void TraceSpan::setDetail(const QString &detail)
+{
+    if (m_active)
+        m_event.detail = detail;
+}
+
+} // namespace QEloquent
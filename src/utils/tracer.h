@@ -0,0 +1,71 @@
+#ifndef QELOQUENT_TRACER_H
+#define QELOQUENT_TRACER_H
+
+#include <QEloquent/global.h>
+
+class QIODevice;
+class QJsonObject;
+
+namespace QEloquent {
+
+/*!
+ * @brief Completed span, in Chrome Trace Event "X" (complete event) form.
+ *
+ * Times are in nanoseconds since the tracer clock origin.
+ */
+struct TraceEvent
+{
+    const char *name = nullptr;
+    const char *category = nullptr;
+    qint64 startNs = 0;
+    qint64 durationNs = 0;
+    int threadId = 0;
+    QString detail;
+};
+
+class QELOQUENT_EXPORT Tracer
+{
+public:
+    static bool start(const QString &fileName, int maxEvents = 1000000);
+    static void start(int capacity = 65536);
+    static void stop();
+    static bool isEnabled();
+
+    static void addEvent(const TraceEvent &event);
+
+    static QList<TraceEvent> events();
+    static QJsonObject toJson();
+    static bool write(QIODevice *device);
+    static void clear();
+    static qint64 droppedEvents();
+
+    static qint64 now();
+    static int currentThreadId();
+};
+
+/*!
+ * @brief RAII span, recorded on destruction when tracing is enabled.
+ *
+ * Nesting comes from the timestamps, spans opened within another one on the same thread are its children.
+ */
+class QELOQUENT_EXPORT TraceSpan
+{
+public:
+    explicit TraceSpan(const char *name, const char *category = "orm");
+    ~TraceSpan();
+
+    bool isActive() const
+    { return m_active; }
+
+    void setDetail(const QString &detail);
+
+private:
+    Q_DISABLE_COPY(TraceSpan)
+
+    TraceEvent m_event;
+    bool m_active;
+};
+
+} // namespace QEloquent
+
+#endif // QELOQUENT_TRACER_H
@@ -30,6 +30,12 @@ INSERT INTO Products (name, description, price, barcode, category_id) VALUES
 ('Banana', 'Organic banana', 0.30, '2234567890123', 1),
 ('Milk', '1L whole milk', 1.20, '3234567890123', 2);
 
+-- Insert Promotions
+INSERT INTO Promotions (code, discount, updated_at, deleted_at) VALUES
+('SPRING', 0.10, '2020-01-01 00:00:00', NULL),
+('SUMMER', 0.15, '2020-01-01 00:00:00', NULL),
+('WINTER', 0.20, '2020-01-01 00:00:00', '2020-06-01 00:00:00');
+
 -- Insert Stocks
 INSERT INTO Stocks (quantity, product_id) VALUES
 (100, 1),
@@ -63,6 +63,15 @@ CREATE TABLE Products (
     FOREIGN KEY(category_id) REFERENCES Categories(id) ON DELETE SET NULL
 );
 
+CREATE TABLE Promotions (
+    id          INTEGER PRIMARY KEY AUTOINCREMENT,
+    code        VARCHAR(30) NOT NULL,
+    discount    REAL NOT NULL CHECK (discount >= 0),
+    created_at  TIMESTAMP DEFAULT CURRENT_TIMESTAMP,
+    updated_at  TIMESTAMP DEFAULT CURRENT_TIMESTAMP,
+    deleted_at  TIMESTAMP
+);
+
 CREATE TABLE Stocks (
     id          INTEGER PRIMARY KEY AUTOINCREMENT,
     quantity    INTEGER NOT NULL DEFAULT 0 CHECK (quantity >= 0),
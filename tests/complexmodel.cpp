@@ -2,7 +2,11 @@
 
 #include <models/complexmodels.h>
 
+#include <QEloquent/queryscope.h>
+
 #include <QJsonArray>
+#include <QEventLoop>
+#include <QTimer>
 
 TEST_F(ComplexModel, RetrieveWithHasOneRelation) {
     // Migration and seeding
@@ -183,3 +187,71 @@ TEST_F(ComplexModel, FriendlyApiWorks) {
     }
     ASSERT_EQ(count, 2);
 }
+
+TEST_F(ComplexModel, QueryScopeReportsRepeatedLazyLoads) {
+    // Migration and seeding
+    ASSERT_TRUE(migrateAndSeed()) << lastErrorText;
+
+    QList<QEloquent::QueryScopeReport> reports;
+    int line = 0;
+    {
+        QEloquent::QueryScope scope(2, [&reports](const QEloquent::QueryScopeReport &report) {
+            reports.append(report);
+        });
+        ASSERT_EQ(QEloquent::QueryScope::current(), &scope);
+
+        // Eager loads of the "with" relations aren't counted
+        auto result = Product::all();
+        ASSERT_TRUE(result) << (result ? "" : TEST_STR(result.error().text()));
+        ASSERT_GT(result->count(), 2);
+        EXPECT_TRUE(scope.reports().isEmpty());
+
+        for (const Product &product : result.value()) {
+            line = __LINE__ + 1;
+            product.category().count();
+        }
+
+        ASSERT_EQ(scope.reports().count(), 1);
+    }
+
+    ASSERT_EQ(QEloquent::QueryScope::current(), nullptr);
+    ASSERT_EQ(reports.count(), 1); // Reported once, not on each following load
+    ASSERT_EQ(TEST_STR(reports.first().modelClass), "Product");
+    ASSERT_EQ(TEST_STR(reports.first().relation), "category");
+    ASSERT_EQ(reports.first().count, 3);
+    ASSERT_TRUE(reports.first().fileName.endsWith("complexmodel.cpp")) << TEST_STR(reports.first().fileName); // The loop, not the model
+    ASSERT_EQ(reports.first().line, line);
+}
+
+TEST_F(ComplexModel, EventLoopScopeKeepsReportsBounded) {
+    // Migration and seeding
+    ASSERT_TRUE(migrateAndSeed()) << lastErrorText;
+
+    auto result = Product::all();
+    ASSERT_TRUE(result) << (result ? "" : TEST_STR(result.error().text()));
+    ASSERT_GT(result->count(), 2);
+
+    int reported = 0;
+    QEloquent::QueryScope::installEventLoopScope(2, [&reported](const QEloquent::QueryScopeReport &) {
+        ++reported;
+    });
+    ASSERT_NE(QEloquent::QueryScope::current(), nullptr);
+
+    for (int i(0); i < 5; ++i) {
+        for (const Product &product : result.value())
+            product.category().count();
+        EXPECT_EQ(QEloquent::QueryScope::current()->reports().count(), 1);
+
+        // The loop blocks waiting for the timer, the scope is reset meanwhile
+        QEventLoop loop;
+        QTimer::singleShot(5, &loop, &QEventLoop::quit);
+        loop.exec();
+        EXPECT_TRUE(QEloquent::QueryScope::current()->reports().isEmpty());
+    }
+
+    // Reported on each iteration, nothing kept across them
+    EXPECT_EQ(reported, 5);
+
+    QEloquent::QueryScope::removeEventLoopScope();
+    EXPECT_EQ(QEloquent::QueryScope::current(), nullptr);
+}
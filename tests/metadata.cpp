@@ -5,6 +5,15 @@
 #include <models/complexmodels.h>
 
 #include <QEloquent/metaobject.h>
+#include <QEloquent/connection.h>
+#include <QEloquent/driver.h>
+#include <QEloquent/metaobjectregistry.h>
+
+#include <QSqlRecord>
+#include <QTemporaryDir>
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QUrl>
 
 using namespace QEloquent;
 
@@ -157,3 +166,230 @@ TEST_F(MetaData, ValidComplexModelProducesValidMetaObject) {
 
     ASSERT_FALSE(meta.hasDeletionTimestamp()) << "found an unknown deletion timestamp";
 }
+
+TEST_F(MetaData, SchemaSnapshotRestoresTableRecords) {
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    const QString fileName = dir.filePath("schema.snapshot");
+
+    ASSERT_TRUE(connection.saveSchemaSnapshot(fileName, "1.0.0")) << "can't save schema snapshot";
+
+    connection.invalidateSchema();
+    ASSERT_FALSE(connection.loadSchemaSnapshot(fileName, "2.0.0")) << "snapshot loaded despite version mismatch";
+    ASSERT_TRUE(connection.loadSchemaSnapshot(fileName, "1.0.0")) << "can't load schema snapshot";
+
+    const QSqlRecord record = connection.record("Products");
+    ASSERT_FALSE(record.isEmpty()) << "Products table missing from snapshot";
+    ASSERT_GE(record.indexOf("category_id"), 0);
+    ASSERT_LT(record.indexOf("unknown_field"), 0);
+
+    // Without explicit version, a column change makes the snapshot stale
+    ASSERT_TRUE(connection.saveSchemaSnapshot(fileName)) << "can't save schema snapshot";
+    ASSERT_TRUE(connection.exec("ALTER TABLE Products ADD COLUMN weight REAL"));
+    connection.invalidateSchema();
+    ASSERT_FALSE(connection.loadSchemaSnapshot(fileName)) << "snapshot loaded despite a schema change";
+    ASSERT_GE(connection.record("Products").indexOf("weight"), 0);
+}
+
+TEST_F(MetaData, ConnectionProfilesApplyOnEveryOpen) {
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+
+    QUrl url;
+    url.setScheme("sqlite");
+    url.setPath(dir.filePath("profiled.db"));
+    url.setQuery("profile=throughput&cache_size=-1000");
+
+    const auto pragma = [](const Connection &connection, const QString &name) {
+        auto result = connection.exec("PRAGMA " + name);
+        return (result && result->next() ? result->value(0).toString() : QString());
+    };
+
+    Connection profiled = Connection::addConnection("Profiled", url);
+    EXPECT_EQ(profiled.sessionSettings().value("synchronous"), "NORMAL");
+    EXPECT_EQ(profiled.sessionSettings().value("cache_size"), "-1000");
+    EXPECT_FALSE(profiled.setSessionSetting("unknown_pragma", "1"));
+    EXPECT_FALSE(profiled.setSessionSetting("journal_mode", "WAL; DROP TABLE x"));
+
+    ASSERT_TRUE(profiled.open()) << TEST_STR(profiled.lastError().text());
+    EXPECT_EQ(pragma(profiled, "journal_mode").toLower(), "wal");
+    EXPECT_EQ(pragma(profiled, "synchronous"), "1");
+    EXPECT_EQ(pragma(profiled, "cache_size"), "-1000");
+    EXPECT_EQ(pragma(profiled, "busy_timeout"), "5000");
+
+    // Clones get their own database connection, set up the same way
+    Connection clone = profiled.clone("ProfiledClone");
+    ASSERT_TRUE(clone.isValid());
+    ASSERT_TRUE(clone.open()) << TEST_STR(clone.lastError().text());
+    EXPECT_EQ(pragma(clone, "cache_size"), "-1000");
+    EXPECT_EQ(pragma(clone, "busy_timeout"), "5000");
+
+    profiled.close();
+    clone.close();
+    profiled = Connection();
+    clone = Connection();
+    Connection::removeConnection("ProfiledClone");
+    Connection::removeConnection("Profiled");
+}
+
+TEST_F(MetaData, ConnectionClosedWhenSessionSettingsFail) {
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+
+    QUrl url;
+    url.setScheme("sqlite");
+    url.setPath(dir.filePath("unsettled.db"));
+
+    Connection unsettled = Connection::addConnection("Unsettled", url);
+
+    // Passes validation, but isn't a number SQLite can parse
+    ASSERT_TRUE(unsettled.setSessionSetting("cache_size", "-lots"));
+    EXPECT_FALSE(unsettled.open());
+    EXPECT_FALSE(unsettled.isOpen());
+    EXPECT_FALSE(unsettled.isInTransaction());
+
+    unsettled = Connection();
+    Connection::removeConnection("Unsettled");
+}
+
+TEST_F(MetaData, RemovedConnectionsForgetTableSchemas) {
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+
+    const auto addConnection = [&dir](const QString &fileName, const QString &columnName) {
+        QUrl url;
+        url.setScheme("sqlite");
+        url.setPath(dir.filePath(fileName));
+
+        Connection connection = Connection::addConnection("Recreated", url);
+        EXPECT_TRUE(connection.open()) << TEST_STR(connection.lastError().text());
+        EXPECT_TRUE(connection.exec("CREATE TABLE Items (id INTEGER PRIMARY KEY, " + columnName + " TEXT)"));
+    };
+
+    addConnection("first.db", "name");
+    const MetaObject first = MetaObject::fromTable("Items", "Recreated");
+    ASSERT_TRUE(first.isValid());
+    EXPECT_TRUE(first.property("name", MetaObject::ResolveByFieldName).isValid());
+    Connection::removeConnection("Recreated");
+
+    // Same name, other database: the cached schema must not be reused
+    addConnection("second.db", "title");
+    const MetaObject second = MetaObject::fromTable("Items", "Recreated");
+    ASSERT_TRUE(second.isValid());
+    EXPECT_TRUE(second.property("title", MetaObject::ResolveByFieldName).isValid());
+    EXPECT_FALSE(second.property("name", MetaObject::ResolveByFieldName).isValid());
+    Connection::removeConnection("Recreated");
+}
+
+TEST_F(MetaData, SQLiteDriverCapabilitiesFollowServerVersion) {
+    const Driver *driver = connection.driver();
+    ASSERT_NE(driver, nullptr);
+
+    const QVersionNumber version = driver->serverVersion();
+    ASSERT_FALSE(version.isNull());
+    EXPECT_EQ(version.majorVersion(), 3);
+
+    EXPECT_TRUE(driver->supportsMultiRowValues());
+    EXPECT_TRUE(driver->supportsSavepoints());
+    EXPECT_EQ(driver->maxBoundParameters(), version >= QVersionNumber(3, 32) ? 32766 : 999);
+    EXPECT_EQ(driver->supportsReturning(), version >= QVersionNumber(3, 35));
+    EXPECT_EQ(driver->supportsWindowFunctions(), version >= QVersionNumber(3, 25));
+    EXPECT_EQ(driver->upsertSyntax(), version >= QVersionNumber(3, 24) ? Driver::OnConflictUpsert : Driver::NoUpsert);
+}
+
+TEST_F(MetaData, BuildTimeDescriptorsAreRegistered) {
+    const QEloquent::MetaObjectDescriptor *descriptor = QEloquent::MetaObjectRegistry::descriptor("Product");
+    ASSERT_NE(descriptor, nullptr);
+    EXPECT_STREQ(descriptor->naming, "Laravel");
+
+    // Lists are split at build time
+    bool appendFound = false;
+    for (int i(0); i < descriptor->infoCount; ++i) {
+        const QEloquent::MetaInfoDescriptor &info = descriptor->infos[i];
+        if (qstrcmp(info.name, "append") != 0)
+            continue;
+
+        appendFound = true;
+        EXPECT_STREQ(info.value, "fullDescription, priced");
+        ASSERT_EQ(info.valueCount, 2);
+        EXPECT_STREQ(info.values[0], "fullDescription");
+        EXPECT_STREQ(info.values[1], "priced");
+    }
+    EXPECT_TRUE(appendFound);
+
+    // Lookups use qualified names, another namespace doesn't share the descriptor
+    EXPECT_EQ(QEloquent::MetaObjectRegistry::descriptor("Shop::Product"), nullptr);
+
+    // Inherited infos and field names are merged from the parent descriptor
+    const QEloquent::MetaObject object = QEloquent::MetaObject::from<Product>();
+    EXPECT_EQ(object.tableName(), "Products");
+    EXPECT_EQ(object.property("createdAt").fieldName(), "created_at");
+}
+
+TEST_F(MetaData, FieldAccessorsReadAndWriteMembers) {
+    const QEloquent::MetaObject object = QEloquent::MetaObject::from<SimpleProduct>();
+
+    SimpleProduct product;
+    product.name = "Apple";
+
+    const QEloquent::MetaProperty name = object.property("name");
+    EXPECT_EQ(name.read(&product).toString(), "Apple");
+    EXPECT_TRUE(name.write(&product, QStringLiteral("Banana")));
+    EXPECT_EQ(product.name, "Banana");
+
+    // Values are converted to the member type, invalid ones reset it
+    const QEloquent::MetaProperty id = object.property("id");
+    EXPECT_TRUE(id.write(&product, QVariant::fromValue<qlonglong>(5)));
+    EXPECT_EQ(product.id, 5);
+    EXPECT_TRUE(id.write(&product, QVariant()));
+    EXPECT_EQ(product.id, 0);
+    EXPECT_EQ(product.primary().toInt(), 0);
+}
+
+TEST_F(MetaData, PropertySubsetsAreComputedOnce) {
+    const QEloquent::MetaObject object = QEloquent::MetaObject::from<SimpleProduct>();
+
+    const QList<QEloquent::MetaProperty> first = object.properties(QEloquent::MetaProperty::FillableProperty, QEloquent::MetaObject::StandardProperties);
+    const QList<QEloquent::MetaProperty> second = object.properties(QEloquent::MetaProperty::FillableProperty, QEloquent::MetaObject::StandardProperties);
+    EXPECT_EQ(first.constData(), second.constData());
+
+    // Exclusions are part of the key
+    const QList<QEloquent::MetaProperty> visible = object.properties(QEloquent::MetaProperty::FillableProperty,
+                                                                     QEloquent::MetaObject::AllProperties,
+                                                                     QEloquent::MetaProperty::HiddenProperty);
+    EXPECT_TRUE(std::none_of(visible.begin(), visible.end(), [](const QEloquent::MetaProperty &property) {
+        return property.hasAttribute(QEloquent::MetaProperty::HiddenProperty);
+    }));
+}
+
+TEST_F(MetaData, DynamicFieldsShareSlotsAcrossModels) {
+    const QEloquent::MetaObject object = QEloquent::MetaObject::from<SimpleProduct>();
+
+    // Hashed lookups agree with names
+    EXPECT_EQ(TEST_STR(object.property("created_at", QEloquent::MetaObject::ResolveByFieldName).propertyName()), "createdAt");
+    EXPECT_GE(object.propertyIndex("name"), 0);
+    EXPECT_EQ(object.propertyIndex("unknown"), -1);
+
+    SimpleProduct first;
+    first.setField("shelf_code", "A12");
+
+    // The slot is allocated once, for every model of the class
+    const int slot = object.dynamicFieldSlot("shelf_code");
+    ASSERT_GE(slot, 0);
+    EXPECT_EQ(object.dynamicSlot("shelfCode"), slot);
+    EXPECT_EQ(TEST_STR(object.dynamicSlotName(slot)), "shelfCode");
+
+    SimpleProduct second;
+    EXPECT_FALSE(second.field("shelf_code").isValid());
+    second.setProperty("shelfCode", "B3");
+    EXPECT_GT(object.dynamicSlotCount(), slot);
+
+    EXPECT_EQ(first.field("shelf_code").toString(), "A12");
+    EXPECT_EQ(first.property("shelfCode").toString(), "A12");
+    EXPECT_EQ(second.field("shelf_code").toString(), "B3");
+    EXPECT_EQ(first.fullDataMap().value("shelfCode").toString(), "A12");
+
+    // Clearing a value removes it from the data map
+    second.setProperty("shelfCode", QVariant());
+    EXPECT_FALSE(second.fullDataMap().contains("shelfCode"));
+}
@@ -16,8 +16,8 @@ QEloquent::Relation<Stock> Product::stock() const {
     return hasOne<Stock>();
 }
 
-QEloquent::Relation<Category> Product::category() const {
-    return belongsTo<Category>();
+QEloquent::Relation<Category> Product::category(const std::source_location &callSite) const {
+    return belongsTo<Category>(QString(), QString(), std::source_location::current(), callSite);
 }
 
 Stock::Stock() :
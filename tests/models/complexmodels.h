@@ -23,7 +23,7 @@ public:
     Q_INVOKABLE QString priced() const;
 
     Q_INVOKABLE QEloquent::Relation<Stock> stock() const;
-    Q_INVOKABLE QEloquent::Relation<Category> category() const;
+    Q_INVOKABLE QEloquent::Relation<Category> category(const std::source_location &callSite = std::source_location::current()) const;
 };
 
 class Stock : public SimpleStock, public QEloquent::ModelHelpers<Stock>
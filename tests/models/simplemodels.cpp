@@ -14,3 +14,6 @@ SimpleStock::SimpleStock()
 
 SimpleCategory::SimpleCategory() : QEloquent::Model(this)
 {}
+
+SimplePromotion::SimplePromotion() : QEloquent::Model(this)
+{}
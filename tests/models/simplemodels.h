@@ -23,6 +23,8 @@ class SimpleProduct : public QEloquent::Model, public QEloquent::ModelHelpers<Si
     Q_CLASSINFO("hidden", "categoryId")
     Q_CLASSINFO("append", "since")
 
+    QELOQUENT_FIELDS(SimpleProduct, id, name, description, price, barcode)
+
 public:
     SimpleProduct();
     template<typename T> SimpleProduct(T *m) : QEloquent::Model(m) {}
@@ -82,4 +84,29 @@ public:
     QDateTime updatedAt;
 };
 
+class SimplePromotion : public QEloquent::Model, public QEloquent::ModelHelpers<SimplePromotion>
+{
+    Q_GADGET
+    Q_PROPERTY(int id MEMBER id)
+    Q_PROPERTY(QString code MEMBER code USER true)
+    Q_PROPERTY(double discount MEMBER discount)
+    Q_PROPERTY(QDateTime createdAt MEMBER createdAt)
+    Q_PROPERTY(QDateTime updatedAt MEMBER updatedAt)
+    Q_PROPERTY(QDateTime deletedAt MEMBER deletedAt)
+
+    Q_CLASSINFO("table", "Promotions")
+
+public:
+    SimplePromotion();
+    template<typename T> SimplePromotion(T *m) : QEloquent::Model(m) {}
+    virtual ~SimplePromotion() = default;
+
+    int id = 0;
+    QString code;
+    double discount = 0.0;
+    QDateTime createdAt;
+    QDateTime updatedAt;
+    QDateTime deletedAt;
+};
+
 #endif // SIMPLEMODELS_H
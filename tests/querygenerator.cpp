@@ -3,6 +3,14 @@
 #include <QEloquent/query.h>
 #include <QEloquent/querybuilder.h>
 #include <QEloquent/datamap.h>
+#include <QEloquent/querystatistics.h>
+#include <QEloquent/queryrunner.h>
+#include <QEloquent/scriptreader.h>
+#include <QEloquent/indexadvisor.h>
+
+#include <QBuffer>
+
+#include <thread>
 
 using namespace QEloquent;
 
@@ -26,6 +34,12 @@ TEST_F(QueryGenerator, ValidQueryProducesValidSelectStatement) {
     query.where("name", "LIKE", "A%").orWhere("description", "LIKE", "T%");
     const QString statement5 = QueryBuilder::selectStatement(query);
     ASSERT_EQ(TEST_STR(statement5), "SELECT * FROM \"Products\" WHERE \"name\" LIKE 'A%' OR \"description\" LIKE 'T%'");
+
+    // Grouped filters keep their OR clauses inside parentheses
+    Query grouped;
+    grouped.table("Products").where(query).andWhere("price", ">", 1);
+    const QString statement6 = QueryBuilder::selectStatement(grouped);
+    ASSERT_EQ(TEST_STR(statement6), "SELECT * FROM \"Products\" WHERE (\"name\" LIKE 'A%' OR \"description\" LIKE 'T%') AND \"price\" > 1");
 }
 
 TEST_F(QueryGenerator, ValidQueryAndDataProducesValidInsertStatement) {
@@ -74,3 +88,162 @@ TEST_F(QueryGenerator, ValidQueryProducesValidDeleteStatement) {
     const QString statement2 = QueryBuilder::deleteStatement(query);
     ASSERT_EQ(TEST_STR(statement2), "DELETE FROM \"Products\" WHERE \"id\" = 1");
 }
+
+TEST_F(QueryGenerator, StatementsWithDifferentLiteralsShareFingerprint) {
+    using QEloquent::QueryStatistics;
+
+    const QString first = QueryStatistics::fingerprint("SELECT * FROM \"Products\" WHERE name = 'Apple' AND price > 0.5  LIMIT 10");
+    const QString second = QueryStatistics::fingerprint("SELECT * FROM \"Products\" WHERE name = 'O''Neil' AND price > 12 LIMIT 20");
+    EXPECT_EQ(first, "SELECT * FROM \"Products\" WHERE name = ? AND price > ? LIMIT ?");
+    EXPECT_EQ(first, second);
+
+    // Identifiers with digits are kept, value lists are collapsed
+    EXPECT_EQ(QueryStatistics::fingerprint("SELECT col1 FROM t2 WHERE id IN (1, 2, 3)"),
+              "SELECT col1 FROM t2 WHERE id IN (...)");
+    EXPECT_EQ(QueryStatistics::fingerprint("INSERT INTO t (a, b) VALUES (1, 'x'), (2, 'y')"),
+              QueryStatistics::fingerprint("INSERT INTO t (a, b) VALUES (3, 'z')"));
+}
+
+TEST_F(QueryGenerator, StatisticsOfFinishedThreadsAreKept) {
+    QueryStatistics::reset();
+
+    QueryRecord record;
+    record.statement = "SELECT * FROM Products WHERE id = 1";
+    record.execNs = 1000;
+
+    std::thread first([&record] { QueryStatistics::record(record); });
+    first.join();
+    std::thread second([&record] { QueryStatistics::record(record); });
+    second.join();
+
+    const QList<QueryStatisticsEntry> entries = QueryStatistics::entries();
+    ASSERT_EQ(entries.size(), 1);
+    EXPECT_EQ(entries.first().calls, 2);
+    EXPECT_EQ(entries.first().totalNs, 2000);
+
+    QueryStatistics::reset();
+    EXPECT_TRUE(QueryStatistics::entries().isEmpty());
+}
+
+TEST_F(QueryGenerator, ScriptReaderSplitsStatementsOutsideLiteralsAndBlocks) {
+    const QByteArray script =
+        "-- Header comment; not a statement\n"
+        "CREATE TABLE t (id INTEGER, name TEXT);\n"
+        "INSERT INTO t VALUES (1, 'a;b'), (2, 'O''Neil;');\n"
+        "/* block; comment */ INSERT INTO \"t\" VALUES (3, 'c') -- trailing; comment\n;\n"
+        "CREATE TRIGGER tr AFTER INSERT ON t BEGIN\n"
+        "    UPDATE t SET name = CASE WHEN id > 1 THEN 'x' ELSE 'y' END;\n"
+        "    DELETE FROM t WHERE id < 0;\n"
+        "END;\n"
+        "BEGIN TRANSACTION;;\n"
+        "DELIMITER $$\n"
+        "CREATE PROCEDURE p() BEGIN SELECT 1; END$$\n"
+        "DELIMITER ;\n"
+        "SELECT $body$ a; b $body$\n";
+
+    const QStringList statements = QueryBuilder::statementsFromScriptContent(script);
+    ASSERT_EQ(statements.size(), 7);
+    EXPECT_EQ(TEST_STR(statements.at(1)), "INSERT INTO t VALUES (1, 'a;b'), (2, 'O''Neil;')");
+    EXPECT_EQ(TEST_STR(statements.at(2)), "INSERT INTO \"t\" VALUES (3, 'c') -- trailing; comment");
+    EXPECT_TRUE(statements.at(3).startsWith("CREATE TRIGGER")) << TEST_STR(statements.at(3));
+    EXPECT_TRUE(statements.at(3).endsWith("END")) << TEST_STR(statements.at(3));
+    EXPECT_EQ(TEST_STR(statements.at(4)), "BEGIN TRANSACTION");
+    EXPECT_EQ(TEST_STR(statements.at(5)), "CREATE PROCEDURE p() BEGIN SELECT 1; END");
+    EXPECT_EQ(TEST_STR(statements.at(6)), "SELECT $body$ a; b $body$");
+
+    // Literals spanning several read chunks
+    const QByteArray value(300 * 1024, ';');
+    QByteArray large = "INSERT INTO t VALUES (1, '" + value + "');\nSELECT 1;";
+    QBuffer buffer(&large);
+    ASSERT_TRUE(buffer.open(QIODevice::ReadOnly));
+
+    ScriptReader reader(&buffer);
+    QString statement;
+    ASSERT_TRUE(reader.readStatement(&statement)) << TEST_STR(reader.errorString());
+    EXPECT_EQ(statement.size(), value.size() + 28);
+    ASSERT_TRUE(reader.readStatement(&statement));
+    EXPECT_EQ(TEST_STR(statement), "SELECT 1");
+    EXPECT_FALSE(reader.readStatement(&statement));
+    EXPECT_FALSE(reader.hasError());
+    EXPECT_EQ(reader.bytesRead(), large.size());
+
+    ScriptReader unterminated(QByteArray("SELECT 'abc;"));
+    EXPECT_FALSE(unterminated.readStatement(&statement));
+    EXPECT_TRUE(unterminated.hasError());
+}
+
+TEST_F(QueryGenerator, ScriptReaderHonorsBackslashEscapesWhenEnabled) {
+    const QByteArray script =
+        "INSERT INTO t VALUES ('O\\'Brien;');\n"
+        "INSERT INTO t VALUES ('C:\\\\', \"say \\\"hi\\\";\");\n"
+        "SELECT `a\\`;\n";
+
+    ScriptReader reader(script);
+    EXPECT_FALSE(reader.backslashEscapes());
+    reader.setBackslashEscapes(true);
+
+    QStringList statements;
+    QString statement;
+    while (reader.readStatement(&statement))
+        statements.append(statement);
+
+    EXPECT_FALSE(reader.hasError()) << TEST_STR(reader.errorString());
+    ASSERT_EQ(statements.size(), 3);
+    EXPECT_EQ(TEST_STR(statements.at(0)), "INSERT INTO t VALUES ('O\\'Brien;')");
+    EXPECT_EQ(TEST_STR(statements.at(1)), "INSERT INTO t VALUES ('C:\\\\', \"say \\\"hi\\\";\")");
+    EXPECT_EQ(TEST_STR(statements.at(2)), "SELECT `a\\`"); // Identifiers have no escapes
+
+    // Off by default, a backslash is then an ordinary character
+    const QStringList standard = QueryBuilder::statementsFromScriptContent("SELECT 'C:\\';\nSELECT 1;\n");
+    ASSERT_EQ(standard.size(), 2);
+    EXPECT_EQ(TEST_STR(standard.at(0)), "SELECT 'C:\\'");
+
+    ScriptReader unterminated(QByteArray("SELECT 'abc\\';"));
+    unterminated.setBackslashEscapes(true);
+    EXPECT_FALSE(unterminated.readStatement(&statement));
+    EXPECT_TRUE(unterminated.hasError());
+}
+
+TEST_F(QueryGenerator, ScriptReaderKeepsControlFlowInsideBlocks) {
+    const QByteArray script =
+        "CREATE TRIGGER stock_check BEFORE UPDATE ON Products FOR EACH ROW BEGIN\n"
+        "    IF NEW.price < 0 THEN\n"
+        "        SET NEW.price = 0;\n"
+        "    END IF;\n"
+        "    CASE NEW.category_id WHEN 1 THEN SET NEW.name = UPPER(NEW.name); ELSE SET NEW.name = NEW.name; END CASE;\n"
+        "    WHILE NEW.price > 100 DO SET NEW.price = NEW.price / 2; END WHILE;\n"
+        "END;\n"
+        "SELECT 1;\n";
+
+    const QStringList statements = QueryBuilder::statementsFromScriptContent(script);
+    ASSERT_EQ(statements.size(), 2);
+    EXPECT_TRUE(statements.at(0).startsWith("CREATE TRIGGER")) << TEST_STR(statements.at(0));
+    EXPECT_TRUE(statements.at(0).endsWith("END WHILE;\nEND")) << TEST_STR(statements.at(0));
+    EXPECT_EQ(TEST_STR(statements.at(1)), "SELECT 1");
+}
+
+TEST_F(QueryGenerator, IndexCandidatesFollowFiltersJoinsAndSorts) {
+    const QList<IndexSuggestion> filtered = IndexAdvisor::candidates(
+        "SELECT * FROM \"Products\" WHERE \"category_id\" = ? AND \"price\" > ? ORDER BY \"name\" LIMIT ?");
+    ASSERT_EQ(filtered.size(), 1);
+    EXPECT_EQ(TEST_STR(filtered.first().tableName), "Products");
+    EXPECT_EQ(filtered.first().columns, QStringList({ "category_id", "price" }));
+
+    const QList<IndexSuggestion> sorted = IndexAdvisor::candidates(
+        "SELECT * FROM Products WHERE LOWER(name) = ? AND category_id IN (?) ORDER BY created_at DESC");
+    ASSERT_EQ(sorted.size(), 1);
+    EXPECT_EQ(sorted.first().columns, QStringList({ "category_id", "created_at" }));
+
+    const QList<IndexSuggestion> joined = IndexAdvisor::candidates(
+        "SELECT p.* FROM Products AS p INNER JOIN Categories c ON c.id = p.category_id WHERE c.name = ?");
+    // Join keys aren't merged with filter columns
+    ASSERT_EQ(joined.size(), 3);
+    EXPECT_EQ(TEST_STR(joined.at(0).tableName), "Categories");
+    EXPECT_EQ(joined.at(0).columns, QStringList({ "name" }));
+    EXPECT_EQ(TEST_STR(joined.at(1).tableName), "Categories");
+    EXPECT_EQ(joined.at(1).columns, QStringList({ "id" }));
+    EXPECT_EQ(TEST_STR(joined.at(2).tableName), "Products");
+    EXPECT_EQ(joined.at(2).columns, QStringList({ "category_id" }));
+
+    EXPECT_TRUE(IndexAdvisor::candidates("SELECT * FROM Products").isEmpty());
+}
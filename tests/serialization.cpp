@@ -1,5 +1,19 @@
 #include "serialization.h"
 
+#include <QEloquent/jsonwriter.h>
+#include <QEloquent/csvwriter.h>
+#include <QEloquent/csvreader.h>
+#include <QEloquent/jsonarrayreader.h>
+#include <QEloquent/binarywriter.h>
+#include <QEloquent/binaryreader.h>
+
+#include <QJsonDocument>
+#include <QJsonArray>
+#include <QBuffer>
+#include <QTemporaryFile>
+#include <QDateTime>
+#include <QTimeZone>
+
 TEST_F(Serialization, SimpleModelProducesValidJsonObject) {
     // Migration and seeding
     ASSERT_TRUE(migrateAndSeed()) << lastErrorText;
@@ -74,3 +88,321 @@ TEST_F(Serialization, ValidJsonObjectFillSimpleModelPartially) {
 
     ASSERT_TRUE(checkResult) << (checkResult ? "" : TEST_STR(checkResult.error()));
 }
+
+TEST_F(Serialization, JsonWriterEscapesStrings) {
+    QByteArray output;
+    {
+        QEloquent::JsonWriter writer(&output);
+        writer.beginObject();
+        writer.writeKey("text");
+        writer.writeString(QString::fromUtf8("a\"b\\c\nd\x01 \xc3\xa9"));
+        writer.writeKey("values");
+        writer.writeValue(QVariantList({ 1, 2.5, true, QVariant() }));
+        writer.writeKey("empty");
+        writer.beginArray();
+        writer.endArray();
+        writer.endObject();
+    }
+
+    ASSERT_EQ(output.toStdString(), "{\"text\":\"a\\\"b\\\\c\\nd\\u0001 \xc3\xa9\",\"values\":[1,2.5,true,null],\"empty\":[]}");
+    ASSERT_FALSE(QJsonDocument::fromJson(output).isNull());
+}
+
+TEST_F(Serialization, StreamedJsonMatchesDocumentSerialization) {
+    // Migration and seeding
+    ASSERT_TRUE(migrateAndSeed()) << lastErrorText;
+
+    auto result = SimpleProduct::find(1);
+    ASSERT_TRUE(result) << TEST_STR(result ? "" : result.error().text());
+
+    const QJsonDocument document = QJsonDocument::fromJson(result->toJson());
+    ASSERT_TRUE(document.isObject());
+    ASSERT_EQ(document.object(), result->toJsonObject());
+}
+
+TEST_F(Serialization, ExportJsonStreamsAllModels) {
+    // Migration and seeding
+    ASSERT_TRUE(migrateAndSeed()) << lastErrorText;
+
+    auto models = SimpleProduct::all();
+    ASSERT_TRUE(models) << TEST_STR(models ? "" : models.error().text());
+
+    QBuffer buffer;
+    ASSERT_TRUE(buffer.open(QIODevice::WriteOnly));
+
+    auto result = SimpleProduct::exportJson(&buffer);
+    ASSERT_TRUE(result) << TEST_STR(result ? "" : result.error().text());
+    ASSERT_EQ(result.value(), models->count());
+
+    const QJsonArray array = QJsonDocument::fromJson(buffer.data()).array();
+    ASSERT_EQ(array.size(), models->count());
+    ASSERT_EQ(array.first().toObject(), models->first().toJsonObject());
+}
+
+TEST_F(Serialization, CsvWriterQuotesSpecialFields) {
+    QByteArray output;
+    {
+        QEloquent::CsvWriter writer(&output);
+        writer.writeRow(QStringList({ "plain", "with,comma", "with \"quotes\"", "multi\nline" }));
+        writer.writeRow(QVariantList({ 1, 2.5, QVariant(), QString() }));
+    }
+
+    ASSERT_EQ(output.toStdString(), "plain,\"with,comma\",\"with \"\"quotes\"\"\",\"multi\nline\"\r\n1,2.5,,\r\n");
+}
+
+TEST_F(Serialization, ExportCsvStreamsQuotedRows) {
+    // Migration and seeding
+    ASSERT_TRUE(migrateAndSeed()) << lastErrorText;
+
+    auto apple = SimpleProduct::find(1);
+    ASSERT_TRUE(apple) << TEST_STR(apple ? "" : apple.error().text());
+    apple->description = "Red; sweet \"and\"\njuicy";
+    ASSERT_TRUE(apple->save());
+
+    auto count = SimpleProduct::count();
+    ASSERT_TRUE(count);
+
+    QBuffer buffer;
+    ASSERT_TRUE(buffer.open(QIODevice::WriteOnly));
+
+    QEloquent::CsvOptions options;
+    options.separator = ';';
+    options.lineEnding = "\n";
+
+    auto result = SimpleProduct::exportCsv(&buffer, SimpleProduct::query().orderBy("id"), options);
+    ASSERT_TRUE(result) << TEST_STR(result ? "" : result.error().text());
+    ASSERT_EQ(result.value(), count.value());
+
+    const QByteArray csv = buffer.data();
+    ASSERT_TRUE(csv.startsWith("id;"));
+    ASSERT_FALSE(csv.contains("category_id")); // Hidden
+    ASSERT_TRUE(csv.contains(";\"Red; sweet \"\"and\"\"\njuicy\";"));
+    ASSERT_EQ(csv.count('\n'), 1 + count.value() + 1); // Header, rows and the embedded line break
+}
+
+TEST_F(Serialization, CsvReaderHandlesQuotesAcrossChunks) {
+    // Large enough to span several read chunks
+    QByteArray csv;
+    {
+        QEloquent::CsvWriter writer(&csv);
+        for (int i(0); i < 20000; ++i)
+            writer.writeRow(QStringList({ QString::number(i), "multi\nline \"" + QString::number(i) + '"', "x;y,z" }));
+    }
+    csv.append("\n\nlast,row,");
+
+    QBuffer buffer(&csv);
+    ASSERT_TRUE(buffer.open(QIODevice::ReadOnly));
+
+    QEloquent::CsvReader reader(&buffer);
+    QByteArrayList fields;
+    for (int i(0); i < 20000; ++i) {
+        ASSERT_TRUE(reader.readRow(&fields)) << "row " << i;
+        ASSERT_EQ(fields.size(), 3);
+        ASSERT_EQ(fields.at(0), QByteArray::number(i));
+        ASSERT_EQ(fields.at(1), "multi\nline \"" + QByteArray::number(i) + '"');
+        ASSERT_EQ(fields.at(2), "x;y,z");
+    }
+
+    // Blank lines are skipped, a trailing separator gives an empty field
+    ASSERT_TRUE(reader.readRow(&fields));
+    ASSERT_EQ(fields, QByteArrayList({ "last", "row", "" }));
+    ASSERT_FALSE(reader.readRow(&fields));
+    ASSERT_FALSE(reader.hasError());
+    ASSERT_EQ(reader.recordNumber(), 20001);
+}
+
+TEST_F(Serialization, JsonArrayReaderSplitsElementsAcrossChunks) {
+    // Large enough to span several read chunks, with braces and escapes inside strings
+    QByteArray json = "\xEF\xBB\xBF [\n";
+    for (int i(0); i < 20000; ++i) {
+        if (i > 0)
+            json.append(",\n");
+        json.append("{\"id\": " + QByteArray::number(i) + ", \"text\": \"{[\\\"" + QByteArray::number(i) + "\\\\\"}]\", \"tags\": [{}]}");
+    }
+    json.append("\n]\n");
+
+    QBuffer buffer(&json);
+    ASSERT_TRUE(buffer.open(QIODevice::ReadOnly));
+
+    QEloquent::JsonArrayReader reader(&buffer);
+    QJsonObject object;
+    for (int i(0); i < 20000; ++i) {
+        ASSERT_TRUE(reader.readObject(&object)) << "element " << i << ": " << TEST_STR(reader.errorString());
+        ASSERT_EQ(object.value("id").toInt(), i);
+        ASSERT_EQ(TEST_STR(object.value("text").toString()), TEST_STR("{[\"" + QString::number(i) + "\\\"}]"));
+        ASSERT_EQ(object.value("tags").toArray().size(), 1);
+    }
+
+    ASSERT_FALSE(reader.readObject(&object));
+    ASSERT_FALSE(reader.hasError()) << TEST_STR(reader.errorString());
+    ASSERT_EQ(reader.elementNumber(), 20000);
+
+    QByteArray invalid = "[{\"id\": 1}, 2]";
+    QBuffer invalidBuffer(&invalid);
+    ASSERT_TRUE(invalidBuffer.open(QIODevice::ReadOnly));
+
+    QEloquent::JsonArrayReader invalidReader(&invalidBuffer);
+    ASSERT_TRUE(invalidReader.readObject(&object));
+    ASSERT_FALSE(invalidReader.readObject(&object));
+    ASSERT_TRUE(invalidReader.hasError());
+    EXPECT_EQ(invalidReader.elementNumber(), 2);
+
+    // Elements are separated by exactly one comma, errors count the failing element
+    const QList<QPair<QByteArray, int>> malformed = {
+        { "[{}{}]", 2 }, { "[{},,{}]", 2 }, { "[,{}]", 1 }, { "[{},]", 2 }, { "[{}, {\"id\": }]", 2 }, { "[{}", 2 }
+    };
+    for (const QPair<QByteArray, int> &item : malformed) {
+        QByteArray data = item.first;
+        QBuffer malformedBuffer(&data);
+        ASSERT_TRUE(malformedBuffer.open(QIODevice::ReadOnly));
+
+        QEloquent::JsonArrayReader malformedReader(&malformedBuffer);
+        while (malformedReader.readObject(&object));
+        EXPECT_TRUE(malformedReader.hasError()) << item.first.constData();
+        EXPECT_EQ(malformedReader.elementNumber(), item.second) << item.first.constData();
+    }
+}
+
+TEST_F(Serialization, BinaryWriterDropsRowsFailingMidway) {
+    const QList<QEloquent::BinaryColumn> columns = {
+        { "name", QEloquent::BinaryColumn::String },
+        { "id", QEloquent::BinaryColumn::Integer }
+    };
+
+    QByteArray data;
+    QEloquent::BinaryWriter writer(&data);
+    ASSERT_TRUE(writer.writeHeader("Products", columns));
+    ASSERT_TRUE(writer.writeRow({ "Apple", 1 }));
+
+    // The name is encoded before the id fails to convert
+    EXPECT_FALSE(writer.writeRow({ "Banana", QStringList({ "not", "a", "number" }) }));
+    EXPECT_TRUE(writer.hasError());
+    writer.finish();
+    EXPECT_EQ(writer.rowCount(), 1);
+
+    QBuffer buffer(&data);
+    ASSERT_TRUE(buffer.open(QIODevice::ReadOnly));
+
+    QEloquent::BinaryReader reader(&buffer);
+    ASSERT_TRUE(reader.readHeader()) << TEST_STR(reader.errorString());
+
+    QVariantList values;
+    ASSERT_TRUE(reader.readRow(&values)) << TEST_STR(reader.errorString());
+    EXPECT_EQ(TEST_STR(values.at(0).toString()), "Apple");
+    EXPECT_FALSE(reader.readRow(&values));
+    EXPECT_FALSE(reader.hasError()) << TEST_STR(reader.errorString());
+}
+
+TEST_F(Serialization, BinaryRowsRoundTripThroughFilesAndBuffers) {
+    const QList<QEloquent::BinaryColumn> columns = {
+        { "id", QEloquent::BinaryColumn::Integer },
+        { "name", QEloquent::BinaryColumn::String },
+        { "price", QEloquent::BinaryColumn::Double },
+        { "created_at", QEloquent::BinaryColumn::DateTime },
+        { "tags", QEloquent::BinaryColumn::Variant }
+    };
+
+    const QDateTime now = QDateTime::fromMSecsSinceEpoch(QDateTime::currentMSecsSinceEpoch(), QTimeZone::utc());
+
+    QByteArray data;
+    {
+        QEloquent::BinaryWriter writer(&data);
+        ASSERT_TRUE(writer.writeHeader("Products", columns));
+        for (int i(0); i < 20000; ++i) {
+            const QVariant name = (i % 10 == 0 ? QVariant() : QVariant("Product " + QString::number(i)));
+            ASSERT_TRUE(writer.writeRow({ i, name, i * 0.5, now, QStringList({ "a", "b" }) })) << TEST_STR(writer.errorString());
+        }
+        ASSERT_TRUE(writer.finish());
+        ASSERT_EQ(writer.rowCount(), 20000);
+    }
+
+    const auto checkRows = [&](QEloquent::BinaryReader &reader) {
+        ASSERT_TRUE(reader.readHeader()) << TEST_STR(reader.errorString());
+        ASSERT_EQ(TEST_STR(reader.tableName()), "Products");
+        ASSERT_EQ(reader.columns(), columns);
+        ASSERT_EQ(reader.schemaTag(), QEloquent::BinaryWriter::schemaTag("Products", columns));
+
+        QVariantList values;
+        for (int i(0); i < 20000; ++i) {
+            ASSERT_TRUE(reader.readRow(&values)) << "row " << i << ": " << TEST_STR(reader.errorString());
+            ASSERT_EQ(values.at(0).toInt(), i);
+            ASSERT_EQ(values.at(1).isNull(), i % 10 == 0);
+            if (i % 10 != 0)
+                ASSERT_EQ(TEST_STR(values.at(1).toString()), TEST_STR("Product " + QString::number(i)));
+            ASSERT_DOUBLE_EQ(values.at(2).toDouble(), i * 0.5);
+            ASSERT_EQ(values.at(3).toDateTime(), now);
+            ASSERT_EQ(TEST_STR_LIST(values.at(4).toStringList()), TEST_STR_LIST({ "a", "b" }));
+        }
+
+        ASSERT_FALSE(reader.readRow(&values));
+        ASSERT_FALSE(reader.hasError()) << TEST_STR(reader.errorString());
+    };
+
+    // Chunked reads
+    QBuffer buffer(&data);
+    ASSERT_TRUE(buffer.open(QIODevice::ReadOnly));
+    {
+        QEloquent::BinaryReader reader(&buffer);
+        ASSERT_FALSE(reader.isMapped());
+        checkRows(reader);
+    }
+
+    // Memory mapped reads
+    QTemporaryFile file;
+    ASSERT_TRUE(file.open());
+    ASSERT_EQ(file.write(data), data.size());
+    ASSERT_TRUE(file.seek(0));
+    {
+        QEloquent::BinaryReader reader(&file);
+        ASSERT_TRUE(reader.isMapped());
+        checkRows(reader);
+    }
+
+    // Truncated data is an error, not an early end
+    QEloquent::BinaryReader truncated(data.left(data.size() / 2));
+    QVariantList values;
+    while (truncated.readRow(&values));
+    ASSERT_TRUE(truncated.hasError());
+}
+
+TEST_F(Serialization, DataMapLookupsSurviveRemovals) {
+    QStringList keys;
+    for (int i(0); i < 40; ++i)
+        keys.append("field_" + QString::number(i));
+
+    // Large rows built from the same keys share their layout
+    QList<QEloquent::DataMap> rows;
+    for (int row(0); row < 3; ++row) {
+        QEloquent::DataMap map;
+        for (int i(0); i < keys.size(); ++i)
+            map.insert(keys.at(i), row * 100 + i);
+        rows.append(map);
+    }
+
+    for (int row(0); row < rows.size(); ++row)
+        for (int i(0); i < keys.size(); ++i)
+            ASSERT_EQ(rows.at(row).value(keys.at(i)).toInt(), row * 100 + i);
+
+    // Removals in the middle and at the end, down to linear search
+    QEloquent::DataMap map = rows.first();
+    map.remove("field_5");
+    map.remove("field_39");
+    map.remove("unknown");
+    ASSERT_EQ(map.size(), 38);
+    ASSERT_FALSE(map.contains("field_5"));
+    ASSERT_FALSE(map.contains("field_39"));
+    ASSERT_EQ(map.value("field_6").toInt(), 6);
+    ASSERT_EQ(map.value("field_38").toInt(), 38);
+    ASSERT_EQ(rows.first().value("field_5").toInt(), 5); // Copies are untouched
+
+    map.removeIf([](const QEloquent::DataMap::Pair &pair) { return pair.second.toInt() % 2 == 0; });
+    ASSERT_EQ(map.size(), 18);
+    ASSERT_FALSE(map.contains("field_6"));
+    ASSERT_EQ(map.value("field_7").toInt(), 7);
+
+    map.insert("field_7", 70);
+    map.insert("extra", 1);
+    ASSERT_EQ(map.value("field_7").toInt(), 70);
+    ASSERT_EQ(map.value("extra").toInt(), 1);
+    ASSERT_EQ(TEST_STR(map.keys().last()), "extra");
+}
@@ -1,5 +1,18 @@
 #include "simplemodel.h"
 
+#include <QEloquent/querystatistics.h>
+#include <QEloquent/slowquerylog.h>
+#include <QEloquent/tracer.h>
+#include <QEloquent/genericmodel.h>
+#include <QEloquent/queryrunner.h>
+#include <QEloquent/indexadvisor.h>
+
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QBuffer>
+#include <QTemporaryFile>
+#include <QSqlQuery>
+
 TEST_F(SimpleModel, RetrieveValidInstanceForExistingRecord) {
     // Migration and seeding
     ASSERT_TRUE(migrateAndSeed()) << lastErrorText;
@@ -103,6 +116,66 @@ TEST_F(SimpleModel, DeleteValidInstanceOnDB) {
     ASSERT_FALSE(result->next()) << "Bio Apple still there found";
 }
 
+TEST_F(SimpleModel, UpdateAllChangesMatchingRecordsInOneStatement) {
+    // Migration and seeding
+    ASSERT_TRUE(migrateAndSeed()) << lastErrorText;
+
+    QEloquent::Query query;
+    query.where("category_id", 1); // Fruits
+
+    auto updateResult = SimpleProduct::updateAll(query, { { "price", 2.5 } });
+    ASSERT_TRUE(updateResult) << TEST_STR(updateResult ? "" : updateResult.error().text());
+    ASSERT_EQ(updateResult.value(), 2); // 2 records updated
+
+    // Checking
+    auto result = connection.exec("SELECT COUNT(id) FROM Products WHERE category_id = 1 AND price = 2.5");
+    ASSERT_TRUE(result) << TEST_STR(result ? "" : result.error().text());
+    ASSERT_TRUE(result->next());
+    ASSERT_EQ(result->value(0).toInt(), 2);
+
+    result = connection.exec("SELECT COUNT(id) FROM Products WHERE price = 2.5");
+    ASSERT_TRUE(result) << TEST_STR(result ? "" : result.error().text());
+    ASSERT_TRUE(result->next());
+    ASSERT_EQ(result->value(0).toInt(), 2); // Other categories untouched
+
+    EXPECT_FALSE(SimpleProduct::updateAll(query, QEloquent::DataMap()));
+}
+
+TEST_F(SimpleModel, UpdateAllSetsTimestampAndSkipsDeletedRecords) {
+    // Migration and seeding
+    ASSERT_TRUE(migrateAndSeed()) << lastErrorText;
+
+    ASSERT_TRUE(QEloquent::MetaObject::from<SimplePromotion>().hasDeletionTimestamp());
+
+    // WINTER is soft-deleted, the OR clause must not reach it
+    QEloquent::Query query;
+    query.where("code", "SPRING").orWhere("code", "WINTER");
+
+    auto updateResult = SimplePromotion::updateAll(query, { { "discount", 0.5 } });
+    ASSERT_TRUE(updateResult) << TEST_STR(updateResult ? "" : updateResult.error().text());
+    ASSERT_EQ(updateResult.value(), 1);
+
+    auto result = connection.exec("SELECT code, discount, updated_at FROM Promotions ORDER BY id");
+    ASSERT_TRUE(result) << TEST_STR(result ? "" : result.error().text());
+
+    const QString seeded = "2020-01-01 00:00:00";
+
+    ASSERT_TRUE(result->next());
+    EXPECT_EQ(TEST_STR(result->value(0).toString()), "SPRING");
+    EXPECT_DOUBLE_EQ(result->value(1).toDouble(), 0.5);
+    EXPECT_NE(TEST_STR(result->value(2).toString()), TEST_STR(seeded));
+
+    ASSERT_TRUE(result->next());
+    EXPECT_EQ(TEST_STR(result->value(0).toString()), "SUMMER");
+    EXPECT_DOUBLE_EQ(result->value(1).toDouble(), 0.15);
+    EXPECT_EQ(TEST_STR(result->value(2).toString()), TEST_STR(seeded));
+
+    ASSERT_TRUE(result->next());
+    EXPECT_EQ(TEST_STR(result->value(0).toString()), "WINTER");
+    EXPECT_DOUBLE_EQ(result->value(1).toDouble(), 0.2);
+    EXPECT_EQ(TEST_STR(result->value(2).toString()), TEST_STR(seeded));
+}
+
 TEST_F(SimpleModel, DeleteValidInstancesOnDB) {
     // Migration
     ASSERT_TRUE(migrateAndSeed()) << lastErrorText;
@@ -120,3 +193,526 @@ TEST_F(SimpleModel, DeleteValidInstancesOnDB) {
     ASSERT_TRUE(result->next());
     ASSERT_EQ(result->value(0).toInt(), 0); // No records remain
 }
+
+TEST_F(SimpleModel, HydrateInstanceFromRecordMapping) {
+    // Migration and seeding
+    ASSERT_TRUE(migrateAndSeed()) << lastErrorText;
+
+    auto result = connection.exec("SELECT id, name, 42 AS unknown, description FROM Products WHERE id = 1");
+    ASSERT_TRUE(result) << TEST_STR(result ? "" : result.error().text());
+    ASSERT_TRUE(result->next()) << "Apple record not found";
+
+    // Mapping is done per column, unknown columns are skipped
+    const QEloquent::MetaObject metaObject = QEloquent::MetaObject::from<SimpleProduct>();
+    const QList<QEloquent::MetaProperty> mapping = metaObject.recordMapping(result->record());
+    ASSERT_EQ(mapping.size(), 4);
+    EXPECT_EQ(mapping.at(0).propertyName(), "id");
+    EXPECT_EQ(mapping.at(1).propertyName(), "name");
+    EXPECT_FALSE(mapping.at(2).isValid());
+    EXPECT_EQ(mapping.at(3).propertyName(), "description");
+
+    SimpleProduct product;
+    EXPECT_EQ(metaObject.write(&product, *result, mapping), 3);
+    EXPECT_EQ(product.id, 1);
+    EXPECT_EQ(product.name, "Apple");
+    EXPECT_EQ(product.description, "Fresh red apple");
+}
+
+TEST_F(SimpleModel, QueryListenersReceiveRecords) {
+    // Migration and seeding
+    ASSERT_TRUE(migrateAndSeed()) << lastErrorText;
+
+    QList<QEloquent::QueryRecord> records;
+    const int listener = QEloquent::QueryRunner::addListener([&records](const QEloquent::QueryRecord &record) {
+        records.append(record);
+    });
+    ASSERT_TRUE(QEloquent::QueryRunner::hasListeners());
+
+    auto result = SimpleProduct::all();
+    QEloquent::QueryRunner::removeListener(listener);
+    ASSERT_TRUE(result) << (result ? "" : TEST_STR(result.error().text()));
+
+    ASSERT_EQ(records.size(), 1);
+    const QEloquent::QueryRecord &record = records.first();
+    EXPECT_TRUE(record.success);
+    EXPECT_TRUE(record.statement.startsWith("SELECT"));
+    EXPECT_EQ(record.connectionName, connection.name());
+    EXPECT_EQ(record.modelClass, "SimpleProduct");
+    EXPECT_EQ(record.rowsReturned, 3);
+    EXPECT_GT(record.totalNs(), 0);
+
+    // Nothing is recorded once removed
+    ASSERT_TRUE(SimpleProduct::all());
+    EXPECT_EQ(records.size(), 1);
+}
+
+TEST_F(SimpleModel, QueryListenersDontChangeRawStatements) {
+    // Migration and seeding
+    ASSERT_TRUE(migrateAndSeed()) << lastErrorText;
+
+    QList<QEloquent::QueryRecord> records;
+    const int listener = QEloquent::QueryRunner::addListener([&records](const QEloquent::QueryRecord &record) {
+        records.append(record);
+    });
+
+    // Literals looking like placeholders are left alone
+    auto literal = connection.exec("SELECT name FROM Products WHERE description <> ':none?' ORDER BY id", true);
+    auto count = SimpleProduct::count();
+    QEloquent::QueryRunner::removeListener(listener);
+
+    ASSERT_TRUE(literal) << TEST_STR(literal ? "" : literal.error().text());
+    ASSERT_TRUE(literal->next());
+    EXPECT_EQ(literal->value(0).toString(), "Apple");
+    ASSERT_TRUE(count);
+    EXPECT_EQ(count.value(), 3);
+
+    ASSERT_EQ(records.size(), 2);
+    EXPECT_EQ(records.at(0).rowsReturned, -1); // SQLite doesn't report query sizes, rows aren't fetched to count them
+    EXPECT_EQ(records.at(1).rowsReturned, 1);
+    EXPECT_EQ(records.at(1).modelClass, "SimpleProduct");
+}
+
+TEST_F(SimpleModel, QueryStatisticsAggregateByFingerprint) {
+    // Migration and seeding
+    ASSERT_TRUE(migrateAndSeed()) << lastErrorText;
+
+    QEloquent::QueryStatistics::reset();
+    QEloquent::QueryStatistics::enable();
+
+    ASSERT_TRUE(SimpleProduct::find(1));
+    ASSERT_TRUE(SimpleProduct::find(2));
+    ASSERT_TRUE(SimpleProduct::find(3));
+
+    QEloquent::QueryStatistics::disable();
+
+    const QList<QEloquent::QueryStatisticsEntry> entries = QEloquent::QueryStatistics::entries();
+    ASSERT_EQ(entries.size(), 1);
+    EXPECT_EQ(entries.first().calls, 3);
+    EXPECT_EQ(entries.first().rows, 3);
+    EXPECT_LE(entries.first().minNs, entries.first().p95Ns);
+    EXPECT_LE(entries.first().p95Ns, entries.first().maxNs);
+
+    QEloquent::QueryStatistics::reset();
+    EXPECT_TRUE(QEloquent::QueryStatistics::entries().isEmpty());
+}
+
+TEST_F(SimpleModel, IndexAdvisorSuggestsMissingIndexesOnly) {
+    // Migration and seeding
+    ASSERT_TRUE(migrateAndSeed()) << lastErrorText;
+
+    QEloquent::QueryStatistics::reset();
+    QEloquent::QueryStatistics::enable();
+
+    ASSERT_TRUE(SimpleProduct::find(1));
+    ASSERT_TRUE(SimpleProduct::find(SimpleProduct::query().where("barcode", "M1")));
+    ASSERT_TRUE(SimpleProduct::find(SimpleProduct::query().where("category_id", 1)));
+    ASSERT_TRUE(SimpleProduct::find(SimpleProduct::query().where("category_id", 2)));
+    ASSERT_TRUE(SimpleProduct::find(SimpleProduct::query().where("id", 1).where("name", "Apple")));
+    ASSERT_TRUE(SimpleProduct::find(SimpleProduct::query().where("barcode", "3234567890123").where("price", ">", 1)));
+
+    QEloquent::QueryStatistics::disable();
+
+    const QList<QEloquent::IndexSuggestion> suggestions = QEloquent::IndexAdvisor::suggestions(connection);
+    QEloquent::QueryStatistics::reset();
+
+    auto find = [&suggestions](const QString &column) {
+        return std::find_if(suggestions.begin(), suggestions.end(), [&column](const QEloquent::IndexSuggestion &suggestion) {
+            return suggestion.tableName == "Products" && suggestion.columns == QStringList(column);
+        });
+    };
+
+    auto category = find("category_id");
+    ASSERT_NE(category, suggestions.end());
+    EXPECT_EQ(category->calls, 2);
+    EXPECT_EQ(category->fingerprints.size(), 1);
+    EXPECT_TRUE(category->statement.startsWith("CREATE INDEX")) << TEST_STR(category->statement);
+
+    // Primary key and unique barcode are already indexed, and select a single row when compared for equality
+    EXPECT_EQ(find("id"), suggestions.end());
+    EXPECT_EQ(find("barcode"), suggestions.end());
+    for (const QEloquent::IndexSuggestion &suggestion : suggestions)
+        EXPECT_TRUE(suggestion.columns.first() != "id" && suggestion.columns.first() != "barcode") << TEST_STR(suggestion.statement);
+
+    // Catalog reads aren't reported to listeners
+    int recorded = 0;
+    const int listener = QEloquent::QueryRunner::addListener([&recorded](const QEloquent::QueryRecord &) { ++recorded; });
+    const QList<QEloquent::TableIndex> indexes = QEloquent::IndexAdvisor::existingIndexes(connection, "Products");
+    QEloquent::QueryRunner::removeListener(listener);
+    EXPECT_EQ(recorded, 0);
+    ASSERT_FALSE(indexes.isEmpty());
+    EXPECT_TRUE(std::all_of(indexes.begin(), indexes.end(), [](const QEloquent::TableIndex &index) { return index.unique; }));
+}
+
+TEST_F(SimpleModel, TracerRecordsNestedSpans) {
+    // Migration and seeding
+    ASSERT_TRUE(migrateAndSeed()) << lastErrorText;
+
+    QEloquent::Tracer::start(1024);
+    ASSERT_TRUE(SimpleProduct::all());
+    QEloquent::Tracer::stop();
+
+    const QList<QEloquent::TraceEvent> events = QEloquent::Tracer::events();
+    auto find = [&events](const QString &name) {
+        return std::find_if(events.begin(), events.end(), [&name](const QEloquent::TraceEvent &event) {
+            return name == QLatin1String(event.name);
+        });
+    };
+
+    auto build = find("QueryBuilder::selectStatement");
+    auto exec = find("QueryRunner::exec");
+    auto fill = find("Model::fill");
+    ASSERT_NE(build, events.end());
+    ASSERT_NE(exec, events.end());
+    ASSERT_NE(fill, events.end());
+    EXPECT_TRUE(exec->detail.startsWith("SELECT"));
+    EXPECT_EQ(TEST_STR(fill->detail), "SimpleProduct");
+    EXPECT_LE(exec->startNs + exec->durationNs, fill->startNs);
+
+    const QJsonObject trace = QEloquent::Tracer::toJson();
+    const QJsonArray traceEvents = trace.value("traceEvents").toArray();
+    ASSERT_EQ(traceEvents.size(), events.size());
+    EXPECT_EQ(traceEvents.first().toObject().value("ph").toString(), "X");
+
+    // Hydration is traced per row, exports have their own serialization spans
+    QBuffer output;
+    ASSERT_TRUE(output.open(QIODevice::WriteOnly));
+    QEloquent::Tracer::start(1024);
+    ASSERT_TRUE(SimpleProduct::exportJson(&output));
+    QEloquent::Tracer::stop();
+
+    QList<QEloquent::TraceEvent> fills;
+    QList<QEloquent::TraceEvent> exports;
+    for (const QEloquent::TraceEvent &event : QEloquent::Tracer::events()) {
+        if (QLatin1String(event.name) == QLatin1String("Model::fill"))
+            fills.append(event);
+        else if (QLatin1String(event.name) == QLatin1String("ModelHelpers::exportJson"))
+            exports.append(event);
+    }
+
+    ASSERT_EQ(fills.size(), 3);
+    ASSERT_EQ(exports.size(), 3);
+    for (qsizetype i(0); i < 3; ++i) {
+        EXPECT_EQ(TEST_STR(exports.at(i).category), "serialization");
+        EXPECT_LE(fills.at(i).startNs + fills.at(i).durationNs, exports.at(i).startNs);
+    }
+
+    // Ring buffer only keeps the most recent events
+    QEloquent::Tracer::start(2);
+    ASSERT_TRUE(SimpleProduct::all());
+    QEloquent::Tracer::stop();
+    EXPECT_EQ(QEloquent::Tracer::events().size(), 2);
+    EXPECT_EQ(TEST_STR(QEloquent::Tracer::events().last().name), "Model::fill");
+
+    // File traces keep the oldest events up to their limit
+    QTemporaryFile file;
+    ASSERT_TRUE(file.open());
+    ASSERT_TRUE(QEloquent::Tracer::start(file.fileName(), 2));
+    ASSERT_TRUE(SimpleProduct::all());
+    QEloquent::Tracer::stop();
+    EXPECT_EQ(QEloquent::Tracer::events().size(), 2);
+    EXPECT_GT(QEloquent::Tracer::droppedEvents(), 0);
+    EXPECT_EQ(TEST_STR(QEloquent::Tracer::events().first().name), "QueryBuilder::selectStatement");
+
+    QEloquent::Tracer::clear();
+    EXPECT_EQ(QEloquent::Tracer::droppedEvents(), 0);
+}
+
+TEST_F(SimpleModel, SlowQueryLogCapturesPlans) {
+    // Migration and seeding
+    ASSERT_TRUE(migrateAndSeed()) << lastErrorText;
+
+    QList<QEloquent::SlowQueryRecord> records;
+    QEloquent::SlowQueryLog::clear();
+    QEloquent::SlowQueryLog::setLargeTableRows(0);
+    QEloquent::SlowQueryLog::enable(0, [&records](const QEloquent::SlowQueryRecord &record) {
+        records.append(record);
+    });
+
+    ASSERT_TRUE(SimpleProduct::all());
+    ASSERT_TRUE(SimpleProduct::find(1));
+
+    QEloquent::SlowQueryLog::disable();
+    QEloquent::SlowQueryLog::setLargeTableRows(1000);
+
+    ASSERT_EQ(records.size(), 2);
+    EXPECT_EQ(QEloquent::SlowQueryLog::records().size(), 2);
+
+    // Listing scans the whole table, primary key lookups don't
+    EXPECT_FALSE(records.at(0).plan.isEmpty());
+    EXPECT_EQ(TEST_STR_LIST(records.at(0).fullScans), TEST_STR_LIST({ "Products" }));
+    EXPECT_FALSE(records.at(1).plan.isEmpty());
+    EXPECT_FALSE(records.at(1).hasFullScan());
+
+    QEloquent::SlowQueryLog::clear();
+}
+
+TEST_F(SimpleModel, SlowQueryLogLeavesTransactionsAlone) {
+    // Migration and seeding
+    ASSERT_TRUE(migrateAndSeed()) << lastErrorText;
+
+    QList<QEloquent::SlowQueryRecord> records;
+    QEloquent::SlowQueryLog::clear();
+    QEloquent::SlowQueryLog::enable(0, [&records](const QEloquent::SlowQueryRecord &record) {
+        records.append(record);
+    });
+
+    // Without statistics, the 3 seeded products are counted once
+    QEloquent::SlowQueryLog::setLargeTableRows(3);
+    ASSERT_TRUE(SimpleProduct::all());
+    QEloquent::SlowQueryLog::setLargeTableRows(4);
+    ASSERT_TRUE(SimpleProduct::all());
+
+    QEloquent::Connection connection = QEloquent::Connection::defaultConnection();
+    ASSERT_TRUE(connection.beginTransaction());
+    EXPECT_TRUE(connection.isInTransaction());
+    ASSERT_TRUE(SimpleProduct::all());
+    ASSERT_TRUE(connection.commitTransaction());
+    EXPECT_FALSE(connection.isInTransaction());
+
+    QEloquent::SlowQueryLog::disable();
+    QEloquent::SlowQueryLog::setLargeTableRows(1000);
+
+    ASSERT_EQ(records.size(), 3);
+    EXPECT_EQ(TEST_STR_LIST(records.at(0).fullScans), TEST_STR_LIST({ "Products" }));
+    EXPECT_FALSE(records.at(1).plan.isEmpty());
+    EXPECT_FALSE(records.at(1).hasFullScan());
+
+    // Nothing runs on a connection in a transaction
+    EXPECT_TRUE(records.at(2).plan.isEmpty());
+    EXPECT_FALSE(records.at(2).hasFullScan());
+
+    QEloquent::SlowQueryLog::clear();
+}
+
+TEST_F(SimpleModel, BulkInsertJoinsTransactionOfCaller) {
+    // Migration and seeding
+    ASSERT_TRUE(migrateAndSeed()) << lastErrorText;
+
+    auto before = SimpleProduct::count();
+    ASSERT_TRUE(before);
+
+    QEloquent::BulkInsertOptions options;
+    options.batchSize = 2;
+    options.transactionSize = 2;
+
+    ASSERT_TRUE(connection.beginTransaction());
+    {
+        QEloquent::BulkInsert insert(QEloquent::MetaObject::from<SimpleProduct>(), options);
+        EXPECT_TRUE(insert.add({ { "name", "Kiwi" }, { "description", "Green" }, { "price", 1.5 }, { "barcode", "K1" } }, 1));
+        EXPECT_TRUE(insert.add({ { "name", "Negative" }, { "description", "Check fails" }, { "price", -1 }, { "barcode", "N1" } }, 2));
+        EXPECT_TRUE(insert.add({ { "name", "Mango" }, { "description", "Sweet" }, { "price", 2 }, { "barcode", "M1" } }, 3));
+        EXPECT_TRUE(insert.finish());
+
+        EXPECT_EQ(insert.report().rowsInserted, 2);
+        ASSERT_EQ(insert.report().errors.size(), 1);
+        EXPECT_EQ(insert.report().errors.at(0).record, 2);
+    }
+
+    // Still open, the rows being discarded with it
+    EXPECT_TRUE(connection.isInTransaction());
+    ASSERT_TRUE(connection.rollbackTransaction());
+
+    auto after = SimpleProduct::count();
+    ASSERT_TRUE(after);
+    EXPECT_EQ(after.value(), before.value());
+}
+
+TEST_F(SimpleModel, ImportCsvReportsRowErrorsWithoutAborting) {
+    // Migration and seeding
+    ASSERT_TRUE(migrateAndSeed()) << lastErrorText;
+
+    auto before = SimpleProduct::count();
+    ASSERT_TRUE(before);
+
+    QByteArray csv = "name,description,price,barcode\r\n"
+                     "Kiwi,\"Green; fuzzy\",1.5,K1\r\n"
+                     "Mango,\"Sweet \"\"alphonso\"\"\",2.0,M1\r\n"
+                     "Broken,Bad price,abc,B1\r\n"
+                     "Negative,Check fails,-1,N1\r\n"
+                     "Pear,\"Two\nlines\",0.8,P1\r\n";
+    QBuffer buffer(&csv);
+    ASSERT_TRUE(buffer.open(QIODevice::ReadOnly));
+
+    QEloquent::BulkInsertOptions options;
+    options.batchSize = 3;
+
+    auto result = SimpleProduct::importCsv(&buffer, QEloquent::CsvOptions(), options);
+    ASSERT_TRUE(result) << TEST_STR(result ? "" : result.error().text());
+
+    const QEloquent::ImportReport report = result.value();
+    EXPECT_EQ(report.rowsRead, 5);
+    EXPECT_EQ(report.rowsInserted, 3);
+    EXPECT_EQ(report.rowsFailed, 2);
+    ASSERT_EQ(report.errors.size(), 2);
+    EXPECT_EQ(report.errors.at(0).record, 4); // Conversion error, header being record 1
+    EXPECT_EQ(report.errors.at(1).record, 5); // Rejected by the CHECK constraint
+    EXPECT_GT(report.rowsPerSecond(), 0.0);
+
+    auto after = SimpleProduct::count();
+    ASSERT_TRUE(after);
+    EXPECT_EQ(after.value(), before.value() + 3);
+
+    auto mango = SimpleProduct::find(SimpleProduct::query().where("barcode", "M1"));
+    ASSERT_TRUE(mango && mango->size() == 1);
+    EXPECT_EQ(TEST_STR(mango->first().description), "Sweet \"alphonso\"");
+    EXPECT_TRUE(mango->first().createdAt.isValid());
+
+    auto pear = SimpleProduct::find(SimpleProduct::query().where("barcode", "P1"));
+    ASSERT_TRUE(pear && pear->size() == 1);
+    EXPECT_EQ(TEST_STR(pear->first().description), "Two\nlines");
+}
+
+TEST_F(SimpleModel, ImportJsonStreamsArrayElements) {
+    // Migration and seeding
+    ASSERT_TRUE(migrateAndSeed()) << lastErrorText;
+
+    auto before = SimpleProduct::count();
+    ASSERT_TRUE(before);
+
+    QByteArray json = R"([
+        {"name": "Kiwi", "description": "Green {fuzzy}", "price": 1.5, "barcode": "K1", "unknown": [1, 2]},
+        {"name": "Negative", "description": "Check fails", "price": -1, "barcode": "N1"},
+        {"name": "Mango", "description": "Sweet \"alphonso\"", "price": 2, "barcode": "M1"}
+    ])";
+    QBuffer buffer(&json);
+    ASSERT_TRUE(buffer.open(QIODevice::ReadOnly));
+
+    auto result = SimpleProduct::importJson(&buffer);
+    ASSERT_TRUE(result) << TEST_STR(result ? "" : result.error().text());
+
+    const QEloquent::ImportReport report = result.value();
+    EXPECT_EQ(report.rowsRead, 3);
+    EXPECT_EQ(report.rowsInserted, 2);
+    EXPECT_EQ(report.rowsFailed, 1);
+    ASSERT_EQ(report.errors.size(), 1);
+    EXPECT_EQ(report.errors.at(0).record, 2);
+
+    auto after = SimpleProduct::count();
+    ASSERT_TRUE(after);
+    EXPECT_EQ(after.value(), before.value() + 2);
+
+    auto mango = SimpleProduct::find(SimpleProduct::query().where("barcode", "M1"));
+    ASSERT_TRUE(mango && mango->size() == 1);
+    EXPECT_EQ(TEST_STR(mango->first().description), "Sweet \"alphonso\"");
+
+    // Malformed elements are reported with their own number
+    QByteArray malformed = R"([{"name": "Lime", "description": "Sour", "price": 1, "barcode": "L1"}, {"name": }])";
+    QBuffer malformedBuffer(&malformed);
+    ASSERT_TRUE(malformedBuffer.open(QIODevice::ReadOnly));
+
+    auto partial = SimpleProduct::importJson(&malformedBuffer);
+    ASSERT_TRUE(partial) << TEST_STR(partial ? "" : partial.error().text());
+    EXPECT_EQ(partial->rowsInserted, 1);
+    ASSERT_EQ(partial->errors.size(), 1);
+    EXPECT_EQ(partial->errors.at(0).record, 2);
+}
+
+TEST_F(SimpleModel, BinaryExportRoundTripsModels) {
+    // Migration and seeding
+    ASSERT_TRUE(migrateAndSeed()) << lastErrorText;
+
+    auto products = SimpleProduct::all();
+    ASSERT_TRUE(products) << TEST_STR(products ? "" : products.error().text());
+
+    QByteArray data;
+    QBuffer buffer(&data);
+    ASSERT_TRUE(buffer.open(QIODevice::WriteOnly));
+
+    auto exported = SimpleProduct::exportBinary(&buffer);
+    ASSERT_TRUE(exported) << TEST_STR(exported ? "" : exported.error().text());
+    ASSERT_EQ(exported.value(), products->size());
+    buffer.close();
+
+    ASSERT_TRUE(buffer.open(QIODevice::ReadOnly));
+    auto imported = SimpleProduct::importBinary(&buffer);
+    ASSERT_TRUE(imported) << TEST_STR(imported ? "" : imported.error().text());
+    ASSERT_EQ(imported->size(), products->size());
+
+    for (qsizetype i(0); i < products->size(); ++i) {
+        const SimpleProduct &expected = products->at(i);
+        const SimpleProduct &actual = imported->at(i);
+        EXPECT_EQ(actual.id, expected.id);
+        EXPECT_EQ(TEST_STR(actual.name), TEST_STR(expected.name));
+        EXPECT_EQ(TEST_STR(actual.description), TEST_STR(expected.description));
+        EXPECT_DOUBLE_EQ(actual.price, expected.price);
+        EXPECT_EQ(actual.createdAt, expected.createdAt);
+    }
+
+    // Data of another table is rejected
+    QByteArray other;
+    {
+        QEloquent::BinaryWriter writer(&other);
+        writer.writeHeader("Others", { { "id", QEloquent::BinaryColumn::Integer } });
+    }
+    QBuffer otherBuffer(&other);
+    ASSERT_TRUE(otherBuffer.open(QIODevice::ReadOnly));
+    EXPECT_FALSE(SimpleProduct::importBinary(&otherBuffer));
+}
+
+TEST_F(SimpleModel, GenericModelsShareCachedTableMetaObject) {
+    // Migration and seeding
+    ASSERT_TRUE(migrateAndSeed()) << lastErrorText;
+
+    using Products = QEloquent::Generic<"Products">;
+
+    auto typed = SimpleProduct::all();
+    ASSERT_TRUE(typed) << TEST_STR(typed ? "" : typed.error().text());
+
+    auto products = Products::all();
+    ASSERT_TRUE(products) << TEST_STR(products ? "" : products.error().text());
+    ASSERT_EQ(products->size(), typed->size());
+    ASSERT_GE(products->size(), 2);
+
+    for (qsizetype i(0); i < products->size(); ++i) {
+        EXPECT_EQ(products->at(i).primary().toInt(), typed->at(i).id);
+        EXPECT_EQ(TEST_STR(products->at(i).field("name").toString()), TEST_STR(typed->at(i).name));
+    }
+
+    // Every instance uses the same meta object, resolved once
+    const auto fillable = [](const QEloquent::GenericModel &model) {
+        return model.metaObject().properties(QEloquent::MetaProperty::FillableProperty).constData();
+    };
+    EXPECT_EQ(fillable(products->at(0)), fillable(products->at(1)));
+    EXPECT_EQ(TEST_STR(products->at(0).metaObject().primaryProperty().fieldName()), "id");
+
+    auto apple = Products::find(1);
+    ASSERT_TRUE(apple) << TEST_STR(apple ? "" : apple.error().text());
+    EXPECT_EQ(TEST_STR(apple->field("name").toString()), TEST_STR(typed->first().name));
+
+    // Schema invalidation drops the cached meta object
+    QEloquent::Connection::defaultConnection().invalidateSchema("Products");
+    const QEloquent::GenericModel fresh = QEloquent::GenericModelMaker<"Products", "">::make();
+    EXPECT_NE(fillable(fresh), fillable(products->at(0)));
+    EXPECT_EQ(fresh.metaObject().properties().size(), products->at(0).metaObject().properties().size());
+}
+
+TEST_F(SimpleModel, ExecScriptRunsStatementsInBatches) {
+    QTemporaryFile file;
+    ASSERT_TRUE(file.open());
+    file.write("CREATE TABLE ScriptItems (id INTEGER PRIMARY KEY, label TEXT);\n");
+    for (int i(1); i <= 5; ++i)
+        file.write(QStringLiteral("INSERT INTO ScriptItems (label) VALUES ('item;%1');\n").arg(i).toUtf8());
+    file.write("INSERT INTO Missing VALUES (1);\n");
+    file.write("INSERT INTO ScriptItems (label) VALUES ('never');\n");
+    ASSERT_TRUE(file.seek(0));
+
+    QList<QEloquent::ScriptProgress> reports;
+    QEloquent::ScriptOptions options;
+    options.transactionSize = 2;
+    options.progress = [&reports](const QEloquent::ScriptProgress &progress) {
+        reports.append(progress);
+    };
+
+    // Execution stops on the failing statement, its batch being rolled back
+    auto result = QEloquent::QueryRunner::execScript(&file, connection, options);
+    ASSERT_FALSE(result);
+    ASSERT_EQ(reports.size(), 3);
+    EXPECT_EQ(reports.last().statements, 6);
+    EXPECT_EQ(reports.last().totalBytes, file.size());
+    EXPECT_LT(reports.last().bytesRead, reports.last().totalBytes);
+
+    auto count = QEloquent::QueryRunner::exec("SELECT COUNT(*) FROM ScriptItems", connection);
+    ASSERT_TRUE(count) << TEST_STR(count ? "" : count.error().text());
+    ASSERT_TRUE(count->next());
+    EXPECT_EQ(count->value(0).toInt(), 5);
+}